@@ -0,0 +1,16 @@
+# Geração do motor Conv1D especializado (firmware/conv1d_engine.cpp)
+# Compartilhado pelo build do Pico (CMakeLists.txt) e pelo build host (host/CMakeLists.txt)
+set(CONV1D_ENGINE_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+
+# conv1d_engine_generate(<modelo .tflite|.h> <header de saída>)
+function(conv1d_engine_generate model output)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND Python3::Interpreter ${CONV1D_ENGINE_ROOT}/tools/gen_conv1d_engine.py ${model} ${output}
+        DEPENDS ${model}
+                ${CONV1D_ENGINE_ROOT}/tools/gen_conv1d_engine.py
+                ${CONV1D_ENGINE_ROOT}/tools/tflite_reader.py
+        COMMENT "Gerando motor Conv1D a partir de ${model}"
+    )
+endfunction()
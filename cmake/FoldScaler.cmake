@@ -0,0 +1,24 @@
+# Scaler z-score dobrado na primeira camada do modelo (tools/fold_scaler.py)
+# Compartilhado pelo build do Pico (CMakeLists.txt) e pelo build host (host/CMakeLists.txt)
+set(FOLD_SCALER_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+
+# fold_scaler_generate(<modelo .tflite|.h> <saída .tflite|.h>)
+# Usa o scaler_params.h do mesmo diretório do modelo, exportado junto com ele pelo notebook, e
+# aborta o build se a paridade com o caminho normalizado (--check) passar da tolerância
+function(fold_scaler_generate model output)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+    get_filename_component(model_dir ${model} DIRECTORY)
+    set(scaler ${model_dir}/scaler_params.h)
+    if(NOT EXISTS ${scaler})
+        message(FATAL_ERROR "MODEL_RAW_INPUT: ${scaler} nao encontrado ao lado de ${model}")
+    endif()
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND Python3::Interpreter ${FOLD_SCALER_ROOT}/tools/fold_scaler.py ${model} ${scaler} ${output} --check
+        DEPENDS ${model} ${scaler}
+                ${FOLD_SCALER_ROOT}/tools/fold_scaler.py
+                ${FOLD_SCALER_ROOT}/tools/tflite_interpreter.py
+                ${FOLD_SCALER_ROOT}/tools/tflite_reader.py
+        COMMENT "Dobrando ${scaler} na primeira camada de ${model}"
+    )
+endfunction()
@@ -0,0 +1,17 @@
+# Geração do motor GRU especializado (firmware/gru_engine.cpp)
+# Compartilhado pelo build do Pico (CMakeLists.txt) e pelo build host (host/CMakeLists.txt)
+set(GRU_ENGINE_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+
+# gru_engine_generate(<modelo .keras> <header de saída>)
+function(gru_engine_generate model output)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND Python3::Interpreter ${GRU_ENGINE_ROOT}/tools/gen_gru_engine.py ${model} ${output}
+        DEPENDS ${model}
+                ${GRU_ENGINE_ROOT}/tools/gen_gru_engine.py
+                ${GRU_ENGINE_ROOT}/tools/gen_conv1d_engine.py
+                ${GRU_ENGINE_ROOT}/tools/keras_reader.py
+        COMMENT "Gerando motor GRU a partir de ${model}"
+    )
+endfunction()
@@ -0,0 +1,17 @@
+# Geração do motor MLP especializado (firmware/mlp_engine.cpp)
+# Compartilhado pelo build do Pico (CMakeLists.txt) e pelo build host (host/CMakeLists.txt)
+set(MLP_ENGINE_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+
+# mlp_engine_generate(<modelo .tflite|.h> <header de saída>)
+function(mlp_engine_generate model output)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+    add_custom_command(
+        OUTPUT ${output}
+        COMMAND Python3::Interpreter ${MLP_ENGINE_ROOT}/tools/gen_mlp_engine.py ${model} ${output}
+        DEPENDS ${model}
+                ${MLP_ENGINE_ROOT}/tools/gen_mlp_engine.py
+                ${MLP_ENGINE_ROOT}/tools/gen_conv1d_engine.py
+                ${MLP_ENGINE_ROOT}/tools/tflite_reader.py
+        COMMENT "Gerando motor MLP a partir de ${model}"
+    )
+endfunction()
@@ -0,0 +1,111 @@
+# Registro de modelos embarcados (tools/gen_model_registry.py, firmware/model_registry.h)
+# Compartilhado pelo build do Pico (CMakeLists.txt) e pelo build host (host/CMakeLists.txt)
+set(MODEL_REGISTRY_ROOT ${CMAKE_CURRENT_LIST_DIR}/..)
+include(${CMAKE_CURRENT_LIST_DIR}/Conv1DEngine.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/MlpEngine.cmake)
+include(${CMAKE_CURRENT_LIST_DIR}/GruEngine.cmake)
+
+# Arena do TFLM planejada no build (tools/plan_arena.py): margem sobre o plano e limite que falha o build.
+# A arena alocada não desce de TFLM_ARENA_MIN (os 60 KB conhecidos) enquanto o plano não for conferido contra
+# o AllocateTensors() real (host/tests/test_tflm_arena.cpp, build host com INFERENCE_ENGINE=TFLM); com 0 ela
+# fica no tamanho do plano. TFLM_OFFLINE_PLAN embute os offsets no flatbuffer (OfflineMemoryAllocation)
+set(TFLM_ARENA_MARGIN 2048 CACHE STRING "Bytes somados a arena planejada do TFLM")
+set(TFLM_ARENA_BUDGET 61440 CACHE STRING "Arena maxima do TFLM em bytes (0: sem limite)")
+set(TFLM_ARENA_MIN 61440 CACHE STRING "Arena minima alocada do TFLM em bytes (0: so o plano)")
+option(TFLM_OFFLINE_PLAN "Plano da arena embutido no flatbuffer (metadado OfflineMemoryAllocation)" OFF)
+
+# model_registry_setup(<TFLM|CODEGEN> <nome> <modelo> <scaler|->)
+# Lê a lista MODEL_REGISTRY (nomes de models/<nome>/, cada um com temperature_model.tflite e
+# scaler_params.h); vazia, o registro tem só o modelo do build passado aqui. Sem .tflite, o
+# temperature_model.keras (GRU, só CODEGEN). O scaler_params.h é obrigatório: o scaler com que o
+# modelo foi treinado vai junto com os pesos. Define no escopo do chamador MODEL_REGISTRY_SOURCES:
+# o header gerado e, no CODEGEN, o motor de cada modelo
+function(model_registry_setup engine default_name default_model default_scaler)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+    set(gen_dir ${CMAKE_CURRENT_BINARY_DIR}/generated)
+    set(header ${gen_dir}/model_registry_data.h)
+    set(args "")
+    set(deps "")
+    set(sources ${header})
+    if(MODEL_REGISTRY)
+        foreach(name IN LISTS MODEL_REGISTRY)
+            set(model ${MODEL_REGISTRY_ROOT}/models/${name}/temperature_model.tflite)
+            set(scaler ${MODEL_REGISTRY_ROOT}/models/${name}/scaler_params.h)
+            if(NOT EXISTS ${model})
+                set(model ${MODEL_REGISTRY_ROOT}/models/${name}/temperature_model.keras)
+            endif()
+            if(NOT EXISTS ${scaler})
+                message(FATAL_ERROR "MODEL_REGISTRY: models/${name} sem scaler_params.h (exportado pelo notebook "
+                                    "junto com o modelo)")
+            endif()
+            if(NOT EXISTS ${model})
+                message(FATAL_ERROR "MODEL_REGISTRY: models/${name} sem temperature_model.tflite nem .keras")
+            endif()
+            if(model MATCHES "\\.keras$" AND engine STREQUAL "TFLM")
+                message(FATAL_ERROR "MODEL_REGISTRY: ${name} só tem o .keras (o conversor emite TensorListReserve, "
+                                    "sem kernel no TFLM): use INFERENCE_ENGINE=CODEGEN")
+            endif()
+            list(APPEND args --model ${name} ${model} ${scaler})
+            list(APPEND deps ${model} ${scaler})
+            if(engine STREQUAL "CODEGEN")
+                # o gerador do motor depende do grafo: decidido no configure
+                execute_process(
+                    COMMAND ${Python3_EXECUTABLE} ${MODEL_REGISTRY_ROOT}/tools/gen_model_registry.py --kind ${model}
+                    OUTPUT_VARIABLE kind ERROR_VARIABLE err RESULT_VARIABLE rc
+                    OUTPUT_STRIP_TRAILING_WHITESPACE)
+                if(NOT rc EQUAL 0)
+                    message(FATAL_ERROR "MODEL_REGISTRY: ${name}: ${err}")
+                endif()
+                list(APPEND kinds ${kind})
+                set(kind_model_${kind} ${model})
+            endif()
+        endforeach()
+    else()
+        list(APPEND args --model ${default_name} ${default_model} ${default_scaler})
+        list(APPEND deps ${default_model})
+        if(NOT default_scaler STREQUAL "-")
+            list(APPEND deps ${default_scaler})
+        endif()
+        set(kinds conv1d) # CONV1D_ENGINE_MODEL
+        set(kind_model_conv1d ${default_model})
+    endif()
+    if(engine STREQUAL "CODEGEN")
+        list(REMOVE_DUPLICATES kinds) # dois modelos do mesmo motor: o gerador do registro aborta
+        list(APPEND sources ${MODEL_REGISTRY_ROOT}/firmware/codegen_wrapper.cpp)
+        foreach(kind IN LISTS kinds)
+            if(kind STREQUAL "conv1d")
+                conv1d_engine_generate(${kind_model_conv1d} ${gen_dir}/conv1d_engine_params.h)
+            elseif(kind STREQUAL "gru")
+                gru_engine_generate(${kind_model_gru} ${gen_dir}/gru_engine_params.h)
+            else()
+                mlp_engine_generate(${kind_model_${kind}} ${gen_dir}/${kind}_engine_params.h)
+            endif()
+            list(APPEND sources ${MODEL_REGISTRY_ROOT}/firmware/${kind}_engine.cpp ${gen_dir}/${kind}_engine_params.h)
+        endforeach()
+    endif()
+    string(TOLOWER ${engine} engine_arg)
+    if(engine STREQUAL "TFLM")
+        list(APPEND args --arena-margin ${TFLM_ARENA_MARGIN} --arena-budget ${TFLM_ARENA_BUDGET}
+                         --arena-min ${TFLM_ARENA_MIN})
+        if(TFLM_OFFLINE_PLAN)
+            list(APPEND args --offline-plan)
+        endif()
+    endif()
+    add_custom_command(
+        OUTPUT ${header}
+        COMMAND Python3::Interpreter ${MODEL_REGISTRY_ROOT}/tools/gen_model_registry.py ${header}
+                --engine ${engine_arg} --reference-scaler ${MODEL_REGISTRY_ROOT}/firmware/scaler_params.h ${args}
+        DEPENDS ${deps}
+                ${MODEL_REGISTRY_ROOT}/firmware/scaler_params.h
+                ${MODEL_REGISTRY_ROOT}/tools/gen_model_registry.py
+                ${MODEL_REGISTRY_ROOT}/tools/fold_scaler.py
+                ${MODEL_REGISTRY_ROOT}/tools/tflite_interpreter.py
+                ${MODEL_REGISTRY_ROOT}/tools/gen_conv1d_engine.py
+                ${MODEL_REGISTRY_ROOT}/tools/tflite_reader.py
+                ${MODEL_REGISTRY_ROOT}/tools/gen_gru_engine.py
+                ${MODEL_REGISTRY_ROOT}/tools/keras_reader.py
+                ${MODEL_REGISTRY_ROOT}/tools/plan_arena.py
+        COMMENT "Gerando registro de modelos (${engine})"
+    )
+    set(MODEL_REGISTRY_SOURCES ${sources} PARENT_SCOPE)
+endfunction()
@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#ifdef OP_PROFILER
+#include "op_profiler.h"
+//um evento por camada, com os mesmos nomes de op do TFLM para comparar os perfis
+#define PROFILE_BEGIN(tag) uint32_t prof_handle = op_profiler_begin(tag)
+#define PROFILE_END()      op_profiler_end(prof_handle)
+#else
+#define PROFILE_BEGIN(tag) do {} while (0)
+#define PROFILE_END()      do {} while (0)
+#endif
+
+//motor gerado de um modelo do registro (conv1d_engine.cpp, mlp_engine.cpp): kernels com formas
+//constexpr e pesos gerados no build, sem interpretador. codegen_wrapper.cpp implementa a API do
+//tflm_wrapper.h sobre eles e escolhe o motor do modelo ativo (model_registry_engines[])
+struct codegen_engine_t {
+    //janela cronológica [window][features] lida direto (zero-copy) -> out[horizons]
+    void (*invoke)(const float* window, float* out);
+    int macs_per_invoke;
+    int activation_bytes; //buffers estáticos de ativação do motor
+#ifdef TFLM_STREAMING
+    //modo incremental (NULL se o motor não tem): push a cada amostra normalizada, invoke só na cabeça
+    void (*stream_push)(const float* sample);
+    int (*stream_invoke)(float* out); //3 = janela incompleta
+    int macs_per_stream_step;
+#endif
+};
+
+//Dense (layout TFLite [out][in]) com ReLU opcional, compartilhada pelos motores
+template <int kIn, int kOut, bool kRelu>
+static inline void dense(const float (&in)[kIn], const float (&w)[kOut][kIn],
+                         const float (&b)[kOut], float (&out)[kOut]) {
+    for (int o = 0; o < kOut; o++) {
+        float acc = b[o];
+#pragma GCC unroll 24
+        for (int i = 0; i < kIn; i++)
+            acc += in[i] * w[o][i];
+        out[o] = (kRelu && acc < 0.0f) ? 0.0f : acc;
+    }
+}
@@ -0,0 +1,148 @@
+#include "tflm_wrapper.h"
+#include "model_registry_data.h" //descritores e motores gerados por tools/gen_model_registry.py
+#include "pico/time.h"
+#include <stdio.h>
+
+//motor CODEGEN: mesma API do tflm_wrapper.cpp sobre os motores gerados do registro de modelos.
+//Cada motor tem os próprios buffers de ativação; a janela vinculada é lida direto por qualquer um,
+//então trocar o modelo ativo não copia nada
+static float input_buf[MODEL_REGISTRY_WINDOW][MODEL_REGISTRY_FEATURES]; //tensor de entrada [1, 10, 4]
+static float output_buf[MODEL_REGISTRY_HORIZONS];                       //saída [3]: previsões 5, 10, 15 min
+static const float* input_src = &input_buf[0][0]; //janela lida pelo invoke (tflm_bind_input)
+static uint32_t initialized = 0; //bit i: motor de model_registry[i] disponível
+static int active = -1;
+static uint32_t last_invoke_us = 0;
+static int last_macs = 0;
+
+extern "C" int tflm_init(void) {
+    return tflm_init_models((1u << MODEL_REGISTRY_COUNT) - 1);
+}
+
+extern "C" int tflm_init_models(uint32_t mask) {
+    mask &= (1u << MODEL_REGISTRY_COUNT) - 1;
+    if (!mask) {
+        printf("[ENGINE] ERRO: nenhum modelo do registro selecionado\n");
+        return 7;
+    }
+#ifdef OP_PROFILER
+    op_profiler_init();
+#endif
+    active = -1;
+    for (int i = 0; i < MODEL_REGISTRY_COUNT; i++) {
+        if (!(mask & (1u << i))) continue;
+        const codegen_engine_t* e = model_registry_engines[i];
+        printf("[ENGINE] %s: motor gerado, %d MACs/invoke, %d bytes de ativações\n",
+               model_registry[i].name, e->macs_per_invoke, e->activation_bytes);
+#ifdef TFLM_STREAMING
+        if (e->stream_invoke)
+            printf("[ENGINE] %s: modo incremental, %d MACs/amostra (%.1fx menos)\n", model_registry[i].name,
+                   e->macs_per_stream_step, (double)e->macs_per_invoke / e->macs_per_stream_step);
+#endif
+        if (active < 0) active = i; //o primeiro do registro começa ativo
+    }
+    initialized = mask;
+    return 0;
+}
+
+extern "C" int tflm_model_count(void) {
+    return MODEL_REGISTRY_COUNT;
+}
+
+extern "C" const model_descriptor_t* tflm_model_info(int idx) {
+    return idx >= 0 && idx < MODEL_REGISTRY_COUNT ? &model_registry[idx] : nullptr;
+}
+
+extern "C" int tflm_select_model(int idx) {
+    if (idx < 0 || idx >= MODEL_REGISTRY_COUNT) return 1;
+    if (!(initialized & (1u << idx))) return 2;
+    active = idx;
+    return 0;
+}
+
+extern "C" int tflm_active_model(void) {
+    return active;
+}
+
+extern "C" float* tflm_input_ptr(int* nfloats) {
+    if (nfloats) *nfloats = MODEL_REGISTRY_WINDOW * MODEL_REGISTRY_FEATURES; //40 floats: 10 timesteps * 4 features
+    return &input_buf[0][0];
+}
+
+extern "C" float* tflm_output_ptr(int* nfloats) {
+    if (nfloats) *nfloats = MODEL_REGISTRY_HORIZONS; //3 floats: previsões 5, 10, 15 min
+    return output_buf;
+}
+
+extern "C" int tflm_invoke(void) {
+    if (active < 0) return 1;
+    const codegen_engine_t* e = model_registry_engines[active];
+    uint32_t start = time_us_32();
+#ifdef OP_PROFILER
+    op_profiler_begin_invoke();
+#endif
+    e->invoke(input_src, output_buf);
+#ifdef OP_PROFILER
+    op_profiler_end_invoke();
+#endif
+    last_invoke_us = time_us_32() - start;
+    last_macs = e->macs_per_invoke;
+    return 0;
+}
+
+extern "C" void tflm_bind_input(const float* window) {
+    input_src = window ? window : &input_buf[0][0];
+}
+
+extern "C" int tflm_arena_used_bytes(void) {
+    //não há arena: a entrada/saída daqui e os buffers estáticos dos motores inicializados
+    int bytes = (int)(sizeof(input_buf) + sizeof(output_buf));
+    for (int i = 0; i < MODEL_REGISTRY_COUNT; i++)
+        if (initialized & (1u << i))
+            bytes += model_registry_engines[i]->activation_bytes;
+    return bytes;
+}
+
+extern "C" int tflm_model_is_int8(void) {
+    return 0; //motores gerados são float32
+}
+
+extern "C" uint32_t tflm_last_invoke_us(void) {
+    return last_invoke_us;
+}
+
+#ifdef TFLM_STREAMING
+static uint32_t stream_push_us = 0;
+
+extern "C" int tflm_stream_push(const float* sample) {
+    //todos os motores incrementais recebem a amostra: o modelo ativo pode mudar entre invokes
+    uint32_t start = time_us_32();
+    for (int i = 0; i < MODEL_REGISTRY_COUNT; i++)
+        if ((initialized & (1u << i)) && model_registry_engines[i]->stream_push)
+            model_registry_engines[i]->stream_push(sample);
+    stream_push_us = time_us_32() - start;
+    return 0;
+}
+
+extern "C" int tflm_stream_invoke(void) {
+    if (active < 0) return 1;
+    const codegen_engine_t* e = model_registry_engines[active];
+    if (!e->stream_invoke)
+        return tflm_invoke(); //motor sem modo incremental: invoke completo sobre a janela vinculada
+    uint32_t start = time_us_32();
+#ifdef OP_PROFILER
+    op_profiler_begin_invoke();
+#endif
+    int rc = e->stream_invoke(output_buf);
+#ifdef OP_PROFILER
+    op_profiler_end_invoke();
+#endif
+    if (rc != 0) return rc;
+    last_invoke_us = stream_push_us + (time_us_32() - start); //inclui as colunas calculadas no push
+    last_macs = e->macs_per_stream_step;
+    return 0;
+}
+
+extern "C" int tflm_macs_per_invoke(void) {
+    return last_macs;
+}
+#endif
@@ -0,0 +1,140 @@
+#include "codegen_engine.h"
+#include "conv1d_engine_params.h" //pesos e formas gerados por tools/gen_conv1d_engine.py
+
+//motor Conv1D especializado (codegen_engine.h), sem interpretador.
+//todas as formas são constexpr, então os laços internos têm limites fixos e o
+//compilador desenrola o kernel (kernel_size × canais) sem metadados de tensor.
+using namespace conv1d_engine;
+
+static float conv1_buf[kConv1Steps][kConv1Filters];  //saída conv1d_1 [8, 24]
+static float conv2_buf[kConv2Steps][kConv2Filters];  //saída conv1d_2 [6, 16]
+static float pool_buf[kConv2Filters];                //GlobalAveragePooling1D [16]
+static float dense_buf[kDenseUnits];                 //dense_1 [24]
+
+//uma coluna (timestep) de Conv1D com padding VALID e ReLU fundida (layout TFLite [out][k][in]).
+//in aponta para a primeira das kK linhas consecutivas da entrada
+template <int kIn, int kOut, int kK>
+static inline void conv1d_column(const float (*in)[kIn], const float (&w)[kOut][kK][kIn],
+                                 const float (&b)[kOut], float (&out)[kOut]) {
+    for (int o = 0; o < kOut; o++) {
+        float acc = b[o];
+#pragma GCC unroll 96
+        for (int k = 0; k < kK; k++)
+            for (int i = 0; i < kIn; i++)
+                acc += in[k][i] * w[o][k][i];
+        out[o] = acc > 0.0f ? acc : 0.0f;
+    }
+}
+
+//Conv1D completa: stride 1, uma coluna por timestep de saída
+template <int kSteps, int kIn, int kOut, int kK>
+static inline void conv1d_relu(const float (&in)[kSteps + kK - 1][kIn],
+                               const float (&w)[kOut][kK][kIn],
+                               const float (&b)[kOut],
+                               float (&out)[kSteps][kOut]) {
+    for (int t = 0; t < kSteps; t++)
+        conv1d_column(&in[t], w, b, out[t]);
+}
+
+//GlobalAveragePooling1D + dense_1 + saída sobre as colunas de conv1d_2 (ordem cronológica)
+static void run_head(const float (*const cols[kConv2Steps])[kConv2Filters], float (&out)[kHorizons]) {
+    {
+        PROFILE_BEGIN("MEAN");
+        for (int o = 0; o < kConv2Filters; o++) {
+            float sum = 0.0f;
+            for (int t = 0; t < kConv2Steps; t++)
+                sum += (*cols[t])[o];
+            pool_buf[o] = sum * (1.0f / kConv2Steps);
+        }
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        dense<kConv2Filters, kDenseUnits, true>(pool_buf, dense1_weights, dense1_bias, dense_buf);
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        dense<kDenseUnits, kHorizons, false>(dense_buf, output_weights, output_bias, out);
+        PROFILE_END();
+    }
+}
+
+static void invoke(const float* window, float* out) {
+    {
+        PROFILE_BEGIN("CONV_2D");
+        //zero-copy: a Conv1D lê direto da janela vinculada
+        conv1d_relu<kConv1Steps>(*reinterpret_cast<const float (*)[kWindow][kFeatures]>(window),
+                                 conv1_weights, conv1_bias, conv1_buf);
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("CONV_2D");
+        conv1d_relu<kConv2Steps>(conv1_buf, conv2_weights, conv2_bias, conv2_buf);
+        PROFILE_END();
+    }
+    const float (*cols[kConv2Steps])[kConv2Filters];
+    for (int t = 0; t < kConv2Steps; t++)
+        cols[t] = &conv2_buf[t];
+    run_head(cols, *reinterpret_cast<float (*)[kHorizons]>(out));
+}
+
+#ifdef TFLM_STREAMING
+//modo incremental: anéis com as últimas kK linhas de entrada/conv1d_1 e as kConv2Steps colunas de
+//conv1d_2. As linhas são duplicadas (anel espelhado) para que as kK linhas mais recentes fiquem
+//sempre contíguas e possam ser passadas direto para conv1d_column()
+static float stream_in[2 * kConv1Kernel][kFeatures];
+static float stream_c1[2 * kConv2Kernel][kConv1Filters];
+static float stream_c2[kConv2Steps][kConv2Filters];
+static int stream_in_pos = 0, stream_c1_pos = 0, stream_c2_pos = 0;
+static int stream_count = 0; //amostras recebidas (satura em kWindow)
+
+static void stream_push(const float* sample) {
+    for (int f = 0; f < kFeatures; f++) { //grava na posição e no espelho
+        stream_in[stream_in_pos][f] = sample[f];
+        stream_in[stream_in_pos + kConv1Kernel][f] = sample[f];
+    }
+    stream_in_pos = (stream_in_pos + 1) % kConv1Kernel;
+    if (stream_count < kWindow) stream_count++;
+
+    //coluna nova de conv1d_1: precisa das últimas kConv1Kernel amostras
+    if (stream_count >= kConv1Kernel) {
+        float col[kConv1Filters];
+        conv1d_column(&stream_in[stream_in_pos], conv1_weights, conv1_bias, col);
+        for (int o = 0; o < kConv1Filters; o++) {
+            stream_c1[stream_c1_pos][o] = col[o];
+            stream_c1[stream_c1_pos + kConv2Kernel][o] = col[o];
+        }
+        stream_c1_pos = (stream_c1_pos + 1) % kConv2Kernel;
+    }
+    //coluna nova de conv1d_2: precisa das últimas kConv2Kernel colunas de conv1d_1
+    if (stream_count >= kConv1Kernel + kConv2Kernel - 1) {
+        conv1d_column(&stream_c1[stream_c1_pos], conv2_weights, conv2_bias, stream_c2[stream_c2_pos]);
+        stream_c2_pos = (stream_c2_pos + 1) % kConv2Steps;
+    }
+}
+
+static int stream_invoke(float* out) {
+    if (stream_count < kWindow) return 3; //janela ainda incompleta
+    const float (*cols[kConv2Steps])[kConv2Filters];
+    for (int t = 0; t < kConv2Steps; t++) //mais antiga -> mais recente, como no invoke completo
+        cols[t] = &stream_c2[(stream_c2_pos + t) % kConv2Steps];
+    run_head(cols, *reinterpret_cast<float (*)[kHorizons]>(out));
+    return 0;
+}
+#endif
+
+//não há arena: apenas os buffers estáticos de ativação (o extern dá ligação externa ao const)
+namespace conv1d_engine {
+extern const codegen_engine_t engine;
+const codegen_engine_t engine = {
+    invoke,
+    kMacsPerInvoke,
+    (int)(sizeof(conv1_buf) + sizeof(conv2_buf) + sizeof(pool_buf) + sizeof(dense_buf)),
+#ifdef TFLM_STREAMING
+    stream_push,
+    stream_invoke,
+    kMacsPerStreamStep,
+#endif
+};
+} // namespace conv1d_engine
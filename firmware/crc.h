@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+
+//CRC-32 (IEEE 802.3, refletido, polinômio 0xEDB88320), bit a bit: sem tabela de 1 KB na flash;
+//os registros gravados são curtos. Encadeável: crc32_update(crc32_update(0, a, n), b, m)
+static inline uint32_t crc32_update(uint32_t crc, const void* data, size_t len) {
+    const uint8_t* p = (const uint8_t*)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        for (int b = 0; b < 8; b++)
+            crc = (crc >> 1) ^ (0xEDB88320u & -(crc & 1u));
+    }
+    return ~crc;
+}
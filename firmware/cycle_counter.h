@@ -0,0 +1,36 @@
+#pragma once
+#include <stdint.h>
+#if PICO_ON_DEVICE
+#include "hardware/structs/systick.h"
+#else
+#include <time.h>
+#endif
+
+//contador de ciclos para medir trechos curtos. Cortex-M0+ não tem DWT: usa o SysTick (24 bits,
+//decrescente, clock do processador; ~134 ms por volta a 125 MHz). No host o "ciclo" é o
+//nanossegundo do relógio do sistema (timespec_get, C11)
+static inline void cycle_counter_init(void) {
+#if PICO_ON_DEVICE
+    systick_hw->rvr = 0x00FFFFFF; //recarga máxima
+    systick_hw->cvr = 0;
+    systick_hw->csr = 0x5;        //habilita, clock do processador, sem interrupção
+#endif
+}
+
+static inline uint32_t cycle_counter_read(void) {
+#if PICO_ON_DEVICE
+    return systick_hw->cvr;
+#else
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+#endif
+}
+
+static inline uint32_t cycle_counter_elapsed(uint32_t start, uint32_t end) {
+#if PICO_ON_DEVICE
+    return (start - end) & 0x00FFFFFFu; //contador decrescente de 24 bits
+#else
+    return end - start;
+#endif
+}
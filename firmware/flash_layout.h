@@ -0,0 +1,15 @@
+#pragma once
+#include "hardware/flash.h" //PICO_FLASH_SIZE_BYTES, FLASH_SECTOR_SIZE
+
+//partições de dados no fim da flash, abaixo do fim e acima do binário (conferido no boot contra
+//__flash_binary_end por cada módulo):
+//  [.. binário ..][ log de amostras (flash_log.c) ][ checkpoint da janela (window_checkpoint.c) ]
+#ifndef WINDOW_CHECKPOINT_SECTORS
+#define WINDOW_CHECKPOINT_SECTORS 2   //setores de 4 KB (128 registros cada)
+#endif
+#ifndef FLASH_LOG_SECTORS
+#define FLASH_LOG_SECTORS 192         //768 KB: 21.504 registros, ~7,7 dias a 31 s por amostra
+#endif
+
+#define WINDOW_CHECKPOINT_OFFSET (PICO_FLASH_SIZE_BYTES - WINDOW_CHECKPOINT_SECTORS * FLASH_SECTOR_SIZE)
+#define FLASH_LOG_OFFSET         (WINDOW_CHECKPOINT_OFFSET - FLASH_LOG_SECTORS * FLASH_SECTOR_SIZE)
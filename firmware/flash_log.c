@@ -0,0 +1,184 @@
+#include "flash_log.h"
+#include "crc.h"
+#include "hardware/flash.h"
+#include "pico/flash.h"
+#include "pico/time.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+
+#define LOG_MAGIC        0x474F4C46u //"FLOG"
+#define PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define NUM_PAGES        (FLASH_LOG_SECTORS * PAGES_PER_SECTOR)
+
+typedef struct {
+    flash_log_page_header_t header;
+    flash_log_record_t records[FLASH_LOG_RECORDS_PER_PAGE];
+} log_page_t;
+_Static_assert(sizeof(flash_log_record_t) == 32, "registro deve ocupar 32 bytes");
+_Static_assert(sizeof(log_page_t) == FLASH_PAGE_SIZE, "cabeçalho + 7 registros devem ocupar uma página");
+
+static bool enabled = false;
+static uint32_t next_page;
+static log_page_t pending;       //página em montagem na RAM
+static flash_log_info_t info;
+
+static const log_page_t* page_ptr(uint32_t page) {
+    return (const log_page_t*)(XIP_BASE + FLASH_LOG_OFFSET) + page; //leitura direto pelo XIP
+}
+
+static uint32_t page_crc(const log_page_t* p) {
+    static const uint32_t zero = 0;
+    uint32_t crc = crc32_update(0, p, offsetof(flash_log_page_header_t, crc));
+    crc = crc32_update(crc, &zero, sizeof(zero));
+    return crc32_update(crc, &p->header.pad, sizeof(*p) - offsetof(flash_log_page_header_t, pad));
+}
+
+static bool page_valid(const log_page_t* p) {
+    return p->header.magic == LOG_MAGIC && p->header.count >= 1 &&
+           p->header.count <= FLASH_LOG_RECORDS_PER_PAGE && p->header.crc == page_crc(p);
+}
+
+static bool page_blank(uint32_t page) {
+    const uint32_t* w = (const uint32_t*)page_ptr(page);
+    for (uint32_t i = 0; i < FLASH_PAGE_SIZE / 4; i++)
+        if (w[i] != 0xFFFFFFFFu) return false;
+    return true;
+}
+
+static bool sector_blank(uint32_t first_page) {
+    for (uint32_t p = first_page; p < first_page + PAGES_PER_SECTOR; p++)
+        if (!page_blank(p)) return false;
+    return true;
+}
+
+void flash_log_init(void) {
+    memset(&info, 0, sizeof(info));
+#if PICO_ON_DEVICE
+    extern char __flash_binary_end;
+    if ((uintptr_t)&__flash_binary_end > XIP_BASE + FLASH_LOG_OFFSET) //binário invadiria a partição
+        return;
+#endif
+    enabled = true;
+
+    //página mais recente: maior first_seq válida; o boot novo é o maior já gravado + 1
+    uint32_t newest_page = NUM_PAGES - 1, newest_seq = 0, last_boot = 0;
+    bool found = false;
+    for (uint32_t p = 0; p < NUM_PAGES; p++) {
+        const log_page_t* page = page_ptr(p);
+        if (!page_valid(page)) continue;
+        info.pages++;
+        if (page->header.boot > last_boot) last_boot = page->header.boot;
+        if (!found || page->header.first_seq > newest_seq) {
+            newest_seq = page->header.first_seq;
+            newest_page = p;
+            info.next_seq = newest_seq + page->header.count;
+            found = true;
+        }
+    }
+    info.boot = last_boot + 1;
+    next_page = (newest_page + 1) % NUM_PAGES;
+    pending.header.count = 0;
+}
+
+typedef struct {
+    uint32_t erase_offset; //0: sem apagamento
+    uint32_t page_offset;
+    const uint8_t* page;
+} flash_op_t;
+
+//roda com as interrupções desligadas e o outro núcleo parado fora da flash (flash_safe_execute)
+static void flash_op(void* param) {
+    const flash_op_t* op = (const flash_op_t*)param;
+    if (op->erase_offset)
+        flash_range_erase(op->erase_offset, FLASH_SECTOR_SIZE);
+    flash_range_program(op->page_offset, op->page, FLASH_PAGE_SIZE);
+}
+
+static int write_pending(void) {
+    //página rasgada por um reset no meio da gravação: pula até uma página livre
+    while (next_page % PAGES_PER_SECTOR && !page_blank(next_page))
+        next_page = (next_page + 1) % NUM_PAGES;
+
+    uint16_t count = pending.header.count;
+    for (int i = count; i < FLASH_LOG_RECORDS_PER_PAGE; i++) //registros não usados ficam apagados
+        memset(&pending.records[i], 0xFF, sizeof(pending.records[i]));
+    pending.header.magic = LOG_MAGIC;
+    pending.header.boot = info.boot;
+    pending.header.first_seq = info.next_seq;
+    pending.header.reserved = 0xFFFF;
+    pending.header.pad = 0xFFFFFFFFu;
+    pending.header.crc = page_crc(&pending);
+
+    uint32_t offset = FLASH_LOG_OFFSET + next_page * FLASH_PAGE_SIZE;
+    flash_op_t op = {0, offset, (const uint8_t*)&pending};
+    uint32_t dropped = 0; //páginas válidas do setor apagado, que saem do log
+    bool erase = next_page % PAGES_PER_SECTOR == 0 && !sector_blank(next_page);
+    if (erase) {
+        op.erase_offset = offset; //entra no setor mais antigo do anel: apaga antes da primeira página
+        for (uint32_t p = next_page; p < next_page + PAGES_PER_SECTOR; p++)
+            dropped += page_valid(page_ptr(p));
+    }
+
+    uint64_t start = time_us_64();
+    int rc = flash_safe_execute(flash_op, &op, 100);
+    pending.header.count = 0; //em caso de erro os registros da página se perdem, o log continua
+    if (rc != PICO_OK) return -1;
+    info.last_write_us = (uint32_t)(time_us_64() - start);
+    if (erase) info.erases++;
+    info.pages = info.pages - dropped + 1;
+    info.pages_written++;
+    info.next_seq += count;
+    next_page = (next_page + 1) % NUM_PAGES;
+    return 1;
+}
+
+int flash_log_append(const flash_log_record_t* r, uint64_t t_ms) {
+    if (!enabled) return -1;
+    if (pending.header.count == 0)
+        pending.header.base_ms = t_ms;
+    flash_log_record_t* dst = &pending.records[pending.header.count++];
+    *dst = *r;
+    dst->dt_ms = (uint32_t)(t_ms - pending.header.base_ms);
+    if (pending.header.count < FLASH_LOG_RECORDS_PER_PAGE) return 0;
+    return write_pending();
+}
+
+int flash_log_flush(void) {
+    if (!enabled) return -1;
+    if (pending.header.count == 0) return 0;
+    return write_pending();
+}
+
+void flash_log_dump(void) {
+    if (!enabled) {
+        printf("FLASH_LOG ERRO partição sobreposta ao binário\n");
+        return;
+    }
+    printf("FLASH_LOG BEGIN boot=%lu pages=%lu next_seq=%lu page_size=%u\n", (unsigned long)info.boot,
+           (unsigned long)info.pages, (unsigned long)info.next_seq, (unsigned)FLASH_PAGE_SIZE);
+    //a página seguinte à posição de escrita é a mais antiga do anel
+    for (uint32_t i = 0; i < NUM_PAGES; i++) {
+        uint32_t p = (next_page + i) % NUM_PAGES;
+        const log_page_t* page = page_ptr(p);
+        if (!page_valid(page)) continue;
+        const uint8_t* bytes = (const uint8_t*)page;
+        char line[2 + 2 * FLASH_PAGE_SIZE + 2];
+        static const char hex[] = "0123456789abcdef";
+        char* c = line;
+        *c++ = 'P';
+        *c++ = ' ';
+        for (uint32_t b = 0; b < FLASH_PAGE_SIZE; b++) {
+            *c++ = hex[bytes[b] >> 4];
+            *c++ = hex[bytes[b] & 0xF];
+        }
+        *c++ = '\n';
+        *c = '\0';
+        fputs(line, stdout);
+    }
+    printf("FLASH_LOG END\n");
+}
+
+const flash_log_info_t* flash_log_info(void) {
+    return &info;
+}
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_acquisition.h" //sensor_counts_t
+#include "flash_layout.h"       //FLASH_LOG_SECTORS e FLASH_LOG_OFFSET
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//log em anel das amostras e previsões na partição FLASH_LOG_OFFSET: registros de 32 bytes acumulados
+//em RAM e gravados de 7 em 7 numa página de 256 bytes (cabeçalho com boot, seq e CRC-32 da página),
+//então cada amostra custa 1/7 de gravação de página e nenhum apagamento extra. Ao entrar num setor o
+//mais antigo é apagado (o anel percorre todos os setores por igual). Um reset perde só os registros
+//ainda na RAM (até 6). flash_log_dump() envia o log inteiro, do mais antigo ao mais novo, em texto
+//hexadecimal pelo stdio (USB CDC ou UART); tools/flash_log_dump.py converte para CSV
+
+#define FLASH_LOG_RECORDS_PER_PAGE 7
+#define FLASH_LOG_NO_PREDICTION    INT16_MIN
+
+typedef struct {
+    uint32_t dt_ms;          //ms desde o primeiro registro da página (base_ms do cabeçalho)
+    sensor_counts_t counts;  //leituras inteiras dos drivers (AHT20 contagens, BMP280 °C x100 e Pa)
+    int16_t pred_centi[3];   //previsões +5/+10/+15 min em °C x100 (FLASH_LOG_NO_PREDICTION: janela incompleta)
+    uint16_t flags;          //reservado (0)
+    uint32_t invoke_us;      //duração do invoke da previsão
+} flash_log_record_t;
+
+typedef struct {
+    uint32_t magic;
+    uint32_t boot;           //incrementado a cada boot
+    uint32_t first_seq;      //seq do primeiro registro (crescente, nunca reutilizada)
+    uint16_t count;          //registros válidos na página (1..7; < 7 só em flush)
+    uint16_t reserved;
+    uint64_t base_ms;        //ms desde o boot no primeiro registro
+    uint32_t crc;            //CRC-32 da página com este campo zerado
+    uint32_t pad;
+} flash_log_page_header_t;
+
+typedef struct {
+    uint32_t boot;
+    uint32_t pages;          //páginas válidas no anel
+    uint32_t next_seq;
+    uint32_t pages_written;  //desde o boot
+    uint32_t erases;         //desde o boot
+    uint32_t last_write_us;  //duração da última gravação de página (com apagamento, quando houve)
+} flash_log_info_t;
+
+void flash_log_init(void);                        //encontra o fim do anel; chamar uma vez no boot
+int  flash_log_append(const flash_log_record_t* r, uint64_t t_ms); //1 página gravada, 0 acumulado, -1 erro
+int  flash_log_flush(void);                       //grava a página parcial (ex.: antes de desligar)
+void flash_log_dump(void);                        //log inteiro pelo stdio, do mais antigo ao mais novo
+const flash_log_info_t* flash_log_info(void);
+
+#ifdef __cplusplus
+}
+#endif
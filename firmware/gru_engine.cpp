@@ -0,0 +1,66 @@
+#include "codegen_engine.h"
+#include "gru_engine_params.h" //pesos e formas gerados por tools/gen_gru_engine.py a partir do .keras
+#include <math.h>
+
+//motor GRU especializado (codegen_engine.h): a célula do Keras (reset_after=True) desenrolada sobre
+//os kWindow passos fixos da janela, no lugar do laço WHILE/TensorListReserve que o TFLM não tem.
+//Por passo: portões da entrada W·x + b_i e da recorrência U·h + b_r pela mesma densa das outras
+//camadas, e depois, por unidade,
+//  z = σ(x_z + h_z), r = σ(x_r + h_r), h' = tanh(x_h + r ⊙ h_h), h = z ⊙ h + (1 - z) ⊙ h'
+using namespace gru_engine;
+
+static float state_buf[kUnits];      //h: estado do GRU, zerado a cada janela (não é stateful)
+static float input_gates[kGates];    //W·x_t + b_i
+static float recurrent_gates[kGates]; //U·h + b_r
+static float hidden_buf[kHidden];    //dense_1 [16]
+
+static inline float sigmoid(float v) {
+    return 1.0f / (1.0f + expf(-v));
+}
+
+static void invoke(const float* window, float* out) {
+    {
+        PROFILE_BEGIN("GRU");
+        for (int j = 0; j < kUnits; j++)
+            state_buf[j] = 0.0f;
+        for (int t = 0; t < kWindow; t++) {
+            //zero-copy: linha t da janela cronológica é x_t
+            dense<kFeatures, kGates, false>(*reinterpret_cast<const float (*)[kFeatures]>(window + t * kFeatures),
+                                            gru_kernel, gru_input_bias, input_gates);
+            dense<kUnits, kGates, false>(state_buf, gru_recurrent_kernel, gru_recurrent_bias, recurrent_gates);
+            for (int j = 0; j < kUnits; j++) {
+                float z = sigmoid(input_gates[j] + recurrent_gates[j]);
+                float r = sigmoid(input_gates[kUnits + j] + recurrent_gates[kUnits + j]);
+                float h = tanhf(input_gates[2 * kUnits + j] + r * recurrent_gates[2 * kUnits + j]);
+                state_buf[j] = z * state_buf[j] + (1.0f - z) * h;
+            }
+        }
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        dense<kUnits, kHidden, true>(state_buf, dense_weights, dense_bias, hidden_buf);
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        dense<kHidden, kHorizons, false>(hidden_buf, output_weights, output_bias,
+                                         *reinterpret_cast<float (*)[kHorizons]>(out));
+        PROFILE_END();
+    }
+}
+
+//sem modo incremental: o estado depende do início da janela, então cada invoke refaz os kWindow passos
+namespace gru_engine {
+extern const codegen_engine_t engine;
+const codegen_engine_t engine = {
+    invoke,
+    kMacsPerInvoke,
+    (int)(sizeof(state_buf) + sizeof(input_gates) + sizeof(recurrent_gates) + sizeof(hidden_buf)),
+#ifdef TFLM_STREAMING
+    nullptr,
+    nullptr,
+    0,
+#endif
+};
+} // namespace gru_engine
@@ -2,15 +2,16 @@
 #include "pico/stdlib.h"
 #include "hardware/i2c.h"
 #include "aht20.h"
+#include "i2c_dma.h"
 
 bool aht20_init(i2c_inst_t *i2c) {
     uint8_t init_cmd[3] = {AHT20_CMD_INIT, 0x08, 0x00};
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3, false); //envia comando de inicialização
+    i2c_dma_write_blocking(i2c, AHT20_I2C_ADDR, init_cmd, 3); //envia comando de inicialização
     sleep_ms(50); //aguarda sensor estabilizar
 
     uint8_t status;
     for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false); //lê byte de status
+        i2c_dma_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1); //lê byte de status
         if ((status & AHT20_STATUS_CALIBRATED) == AHT20_STATUS_CALIBRATED)
             return true; //sensor calibrado e pronto
         sleep_ms(10);
@@ -18,44 +19,90 @@ bool aht20_init(i2c_inst_t *i2c) {
     return false; //timeout: sensor não calibrou
 }
 
-bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+bool aht20_trigger(AHT20_Measurement *m, i2c_inst_t *i2c) {
     uint8_t trigger_cmd[3] = {AHT20_CMD_TRIGGER, 0x33, 0x00};
-    uint8_t buffer[6];
+    m->i2c = i2c;
+    if (i2c_dma_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3) != 3) { //dispara medição
+        m->state = AHT20_STATE_ERROR;
+        return false;
+    }
+    absolute_time_t now = get_absolute_time();
+    m->next_poll = delayed_by_ms(now, AHT20_MEASURE_TIME_MS); //antes disso o sensor certamente está ocupado
+    m->deadline = delayed_by_ms(now, AHT20_TIMEOUT_MS);
+    m->state = AHT20_STATE_CONVERTING;
+    return true;
+}
 
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, trigger_cmd, 3, false); //dispara medição
+AHT20_State aht20_poll(AHT20_Measurement *m) {
+    if (m->state != AHT20_STATE_CONVERTING) return m->state;
+    absolute_time_t now = get_absolute_time();
+    if (absolute_time_diff_us(m->next_poll, now) < 0) return m->state; //ainda convertendo: sem I2C
 
     uint8_t status;
-    for (int i = 0; i < 10; i++) {
-        i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false); //pooling de status
-        if (!(status & AHT20_STATUS_BUSY)) break; //sensor pronto
-        sleep_ms(10);
+    if (i2c_dma_read_blocking(m->i2c, AHT20_I2C_ADDR, &status, 1) != 1) { //lê byte de status
+        m->state = AHT20_STATE_ERROR;
+    } else if (!(status & AHT20_STATUS_BUSY)) {
+        m->state = AHT20_STATE_READY; //sensor pronto
+    } else if (absolute_time_diff_us(m->deadline, now) >= 0) {
+        m->state = AHT20_STATE_ERROR; //timeout: sensor ainda ocupado
+    } else {
+        m->next_poll = delayed_by_ms(now, AHT20_POLL_INTERVAL_MS);
     }
+    return m->state;
+}
 
-    if (status & AHT20_STATUS_BUSY) return false; //timeout: sensor ainda ocupado
+bool aht20_collect_raw(AHT20_Measurement *m, AHT20_Raw *raw) {
+    uint8_t buffer[6];
+    if (m->state != AHT20_STATE_READY) return false;
+    m->state = AHT20_STATE_IDLE;
+    if (i2c_dma_read_blocking(m->i2c, AHT20_I2C_ADDR, buffer, 6) != 6) return false; //falha na leitura
 
-    if (i2c_read_blocking(i2c, AHT20_I2C_ADDR, buffer, 6, false) != 6) return false; //falha na leitura
+    raw->humidity = ((uint32_t)buffer[1] << 12) |
+                    ((uint32_t)buffer[2] << 4)  |
+                    (buffer[3] >> 4);                  //umidade: 20 bits [1..3]
+    raw->temperature = ((uint32_t)(buffer[3] & 0x0F) << 16) |
+                       ((uint32_t)buffer[4] << 8) |
+                       buffer[5];                      //temperatura: 20 bits [3..5]
+    return true;
+}
+
+void aht20_convert(const AHT20_Raw *raw, AHT20_Data *data) {
+    data->humidity = (float)raw->humidity * 100.0 / 1048576.0;                //converte para %RH
+    data->temperature = ((float)raw->temperature * 200.0 / 1048576.0) - 50.0; //converte para °C
+}
 
-    uint32_t raw_humidity = ((uint32_t)buffer[1] << 12) |
-                            ((uint32_t)buffer[2] << 4)  |
-                            (buffer[3] >> 4);                          //umidade: 20 bits [1..3]
-    data->humidity = (float)raw_humidity * 100.0 / 1048576.0;         //converte para %RH
+bool aht20_collect(AHT20_Measurement *m, AHT20_Data *data) {
+    AHT20_Raw raw;
+    if (!aht20_collect_raw(m, &raw)) return false;
+    aht20_convert(&raw, data);
+    return true;
+}
 
-    uint32_t raw_temp = ((uint32_t)(buffer[3] & 0x0F) << 16) |
-                        ((uint32_t)buffer[4] << 8) |
-                        buffer[5];                                     //temperatura: 20 bits [3..5]
-    data->temperature = ((float)raw_temp * 200.0 / 1048576.0) - 50.0; //converte para °C
+//leitura bloqueante: dispara, dorme até o próximo instante de consulta e coleta
+bool aht20_read_raw(i2c_inst_t *i2c, AHT20_Raw *raw) {
+    AHT20_Measurement m;
+    if (!aht20_trigger(&m, i2c)) return false;
+    AHT20_State state;
+    while ((state = aht20_poll(&m)) == AHT20_STATE_CONVERTING)
+        sleep_until(aht20_next_poll(&m));
+    return state == AHT20_STATE_READY && aht20_collect_raw(&m, raw);
+}
 
+bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data) {
+    AHT20_Raw raw;
+    if (!aht20_read_raw(i2c, &raw)) return false;
+    aht20_convert(&raw, data);
     return true;
 }
 
 void aht20_reset(i2c_inst_t *i2c) {
     uint8_t reset_cmd = AHT20_CMD_RESET;
-    i2c_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1, false); //soft reset
+    i2c_dma_write_blocking(i2c, AHT20_I2C_ADDR, &reset_cmd, 1); //soft reset
     sleep_ms(20);
     aht20_init(i2c); //reinicializa após reset
 }
 
 bool aht20_check(i2c_inst_t *i2c) {
     uint8_t status;
-    return i2c_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1, false) == 1; //verifica se sensor responde no I2C
+    return i2c_dma_read_blocking(i2c, AHT20_I2C_ADDR, &status, 1) == 1; //verifica se sensor responde no I2C
 }
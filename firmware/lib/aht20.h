@@ -2,7 +2,9 @@
 #define AHT20_H
 
 #include <stdbool.h>
+#include <stdint.h>
 #include "hardware/i2c.h"
+#include "pico/time.h"
 
 #define AHT20_I2C_ADDR      0x38
 #define AHT20_CMD_INIT          0xBE
@@ -10,15 +12,48 @@
 #define AHT20_CMD_RESET         0xBA
 #define AHT20_STATUS_BUSY       0x80 //bit: sensor ocupado
 #define AHT20_STATUS_CALIBRATED 0x08 //bit: sensor calibrado
+#define AHT20_MEASURE_TIME_MS   80   //tempo de conversão (datasheet)
+#define AHT20_POLL_INTERVAL_MS  10   //intervalo entre consultas de status após o tempo de conversão
+#define AHT20_TIMEOUT_MS        100  //desiste se o sensor continuar ocupado
 
 typedef struct {
     float temperature;
     float humidity;
 } AHT20_Data;
 
+//resultado bruto: contagens de 20 bits, T = c * 200 / 2^20 - 50 °C e UR = c * 100 / 2^20 %
+typedef struct {
+    uint32_t temperature;
+    uint32_t humidity;
+} AHT20_Raw;
+
+//medição assíncrona: aht20_trigger() dispara e retorna; aht20_poll() não bloqueia e pode ser
+//chamada do loop principal ou de um callback de timer; aht20_collect() lê o resultado
+typedef enum {
+    AHT20_STATE_IDLE,       //nenhuma medição em andamento
+    AHT20_STATE_CONVERTING, //conversão em andamento
+    AHT20_STATE_READY,      //conversão concluída, resultado pronto para aht20_collect()
+    AHT20_STATE_ERROR,      //falha de I2C ou timeout
+} AHT20_State;
+
+typedef struct {
+    i2c_inst_t *i2c;
+    AHT20_State state;
+    absolute_time_t next_poll; //status só é consultado a partir deste instante
+    absolute_time_t deadline;  //timeout da conversão
+} AHT20_Measurement;
+
 bool aht20_init(i2c_inst_t *i2c);                   //inicializa o sensor
 bool aht20_read(i2c_inst_t *i2c, AHT20_Data *data); //lê temperatura e umidade
+bool aht20_read_raw(i2c_inst_t *i2c, AHT20_Raw *raw); //lê contagens brutas (sem ponto flutuante)
 void aht20_reset(i2c_inst_t *i2c);                  //soft reset
 bool aht20_check(i2c_inst_t *i2c);                  //verifica se sensor responde no I2C
 
+bool        aht20_trigger(AHT20_Measurement *m, i2c_inst_t *i2c); //dispara medição sem esperar
+AHT20_State aht20_poll(AHT20_Measurement *m);                     //avança o estado sem bloquear
+bool        aht20_collect(AHT20_Measurement *m, AHT20_Data *data); //lê e converte o resultado pronto
+bool        aht20_collect_raw(AHT20_Measurement *m, AHT20_Raw *raw); //lê o resultado pronto sem converter
+void        aht20_convert(const AHT20_Raw *raw, AHT20_Data *data);    //contagens -> °C e %RH (ponto flutuante)
+static inline absolute_time_t aht20_next_poll(const AHT20_Measurement *m) { return m->next_poll; }
+
 #endif //AHT20_H
@@ -1,5 +1,6 @@
 #include "bmp280.h"
 #include "hardware/i2c.h"
+#include "i2c_dma.h"
 
 #define ADDR _u(0x76)
 
@@ -8,32 +9,30 @@ void bmp280_init(i2c_inst_t *i2c) {
     const uint8_t reg_config_val = ((0x04 << 5) | (0x05 << 2)) & 0xFC;
     buf[0] = REG_CONFIG;
     buf[1] = reg_config_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false); //escreve REG_CONFIG
+    i2c_dma_write_blocking(i2c, ADDR, buf, 2); //escreve REG_CONFIG
     const uint8_t reg_ctrl_meas_val = (0x01 << 5) | (0x03 << 2) | (0x03);
     buf[0] = REG_CTRL_MEAS;
     buf[1] = reg_ctrl_meas_val;
-    i2c_write_blocking(i2c, ADDR, buf, 2, false); //escreve REG_CTRL_MEAS
+    i2c_dma_write_blocking(i2c, ADDR, buf, 2); //escreve REG_CTRL_MEAS
 }
 
 void bmp280_read_raw(i2c_inst_t *i2c, int32_t* temp, int32_t* pressure) {
     uint8_t buf[6];
     uint8_t reg = REG_PRESSURE_MSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, 6, false);
+    i2c_dma_write_read_blocking(i2c, ADDR, &reg, 1, buf, 6); //ponteiro + repeated start + burst 0xF7..0xFC
     *pressure = (buf[0] << 12) | (buf[1] << 4) | (buf[2] >> 4);
     *temp     = (buf[3] << 12) | (buf[4] << 4) | (buf[5] >> 4);
 }
 
 void bmp280_reset(i2c_inst_t *i2c) {
     uint8_t buf[2] = { REG_RESET, 0xB6 };
-    i2c_write_blocking(i2c, ADDR, buf, 2, false); //soft reset
+    i2c_dma_write_blocking(i2c, ADDR, buf, 2); //soft reset
 }
 
 void bmp280_get_calib_params(i2c_inst_t *i2c, struct bmp280_calib_param* params) {
     uint8_t buf[NUM_CALIB_PARAMS] = { 0 };
     uint8_t reg = REG_DIG_T1_LSB;
-    i2c_write_blocking(i2c, ADDR, &reg, 1, true);
-    i2c_read_blocking(i2c, ADDR, buf, NUM_CALIB_PARAMS, false);
+    i2c_dma_write_read_blocking(i2c, ADDR, &reg, 1, buf, NUM_CALIB_PARAMS);
     params->dig_t1 = (uint16_t)(buf[1] << 8) | buf[0]; //temperatura
     params->dig_t2 = (int16_t)(buf[3] << 8)  | buf[2];
     params->dig_t3 = (int16_t)(buf[5] << 8)  | buf[4];
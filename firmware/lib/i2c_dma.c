@@ -0,0 +1,206 @@
+#include "i2c_dma.h"
+#include "pico/time.h"
+#include "hardware/sync.h"
+
+static volatile uint32_t total_cpu_us = 0;
+
+#ifdef I2C_DMA
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+typedef struct {
+    i2c_inst_t *i2c;
+    int tx_chan, rx_chan;
+    i2c_dma_xfer_t *queue[I2C_DMA_QUEUE_LEN];
+    uint32_t head, tail;             //queue[tail] é a próxima a iniciar
+    i2c_dma_xfer_t *active;
+    spin_lock_t *lock;               //fila compartilhada entre os dois núcleos e o IRQ
+    bool aborting;                   //TX_ABRT tratado, aguardando o STOP_DET correspondente
+    uint32_t cmds[I2C_DMA_MAX_BYTES]; //palavras de IC_DATA_CMD (32 bits: escrita APB de largura total)
+} i2c_dma_bus_t;
+
+static i2c_dma_bus_t buses[2];
+
+//monta os comandos da próxima transação e dispara os canais; chamado com o spin lock do barramento
+static void start_next(i2c_dma_bus_t *b) {
+    if (b->active || b->aborting || b->head == b->tail) return;
+    uint32_t start = time_us_32();
+    i2c_dma_xfer_t *x = b->queue[b->tail % I2C_DMA_QUEUE_LEN];
+    b->tail++;
+    b->active = x;
+
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    hw->enable = 0;
+    hw->tar = x->addr;
+    hw->enable = 1;
+
+    size_t n = 0;
+    for (size_t i = 0; i < x->tx_len; i++)
+        b->cmds[n++] = x->tx[i];
+    for (size_t i = 0; i < x->rx_len; i++) //leitura: bit CMD, repeated start após a escrita
+        b->cmds[n++] = I2C_IC_DATA_CMD_CMD_BITS | (i == 0 && x->tx_len ? I2C_IC_DATA_CMD_RESTART_BITS : 0);
+    b->cmds[n - 1] |= I2C_IC_DATA_CMD_STOP_BITS; //STOP no último byte: conclusão via STOP_DET
+
+    if (x->rx_len) {
+        dma_channel_config c = dma_channel_get_default_config(b->rx_chan);
+        channel_config_set_transfer_data_size(&c, DMA_SIZE_8);
+        channel_config_set_read_increment(&c, false);
+        channel_config_set_write_increment(&c, true);
+        channel_config_set_dreq(&c, i2c_get_dreq(b->i2c, false));
+        dma_channel_configure(b->rx_chan, &c, x->rx, &hw->data_cmd, x->rx_len, true);
+    }
+    dma_channel_config c = dma_channel_get_default_config(b->tx_chan);
+    channel_config_set_transfer_data_size(&c, DMA_SIZE_32);
+    channel_config_set_read_increment(&c, true);
+    channel_config_set_write_increment(&c, false);
+    channel_config_set_dreq(&c, i2c_get_dreq(b->i2c, true));
+    dma_channel_configure(b->tx_chan, &c, &hw->data_cmd, b->cmds, n, true);
+    x->cpu_us += time_us_32() - start;
+}
+
+static void bus_irq(i2c_dma_bus_t *b) {
+    uint32_t start = time_us_32();
+    uint32_t save = spin_lock_blocking(b->lock);
+    i2c_hw_t *hw = i2c_get_hw(b->i2c);
+    uint32_t stat = hw->intr_stat;
+    i2c_dma_xfer_t *x = b->active;
+    int result = 0;
+
+    if (stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS) { //NACK ou perda de arbitragem: FIFO já descartado
+        (void)hw->clr_tx_abrt;
+        dma_channel_abort(b->tx_chan);
+        dma_channel_abort(b->rx_chan);
+        b->aborting = true;
+        result = PICO_ERROR_GENERIC;
+    }
+    if (stat & I2C_IC_INTR_STAT_R_STOP_DET_BITS) {
+        (void)hw->clr_stop_det;
+        if (b->aborting && !(stat & I2C_IC_INTR_STAT_R_TX_ABRT_BITS)) {
+            b->aborting = false; //STOP da transação abortada: barramento livre
+            x = NULL;
+        } else if (!b->aborting && x) {
+            while (x->rx_len && dma_channel_is_busy(b->rx_chan))
+                tight_loop_contents(); //último byte ainda saindo do FIFO de RX
+            result = (int)(x->rx_len ? x->rx_len : x->tx_len);
+        } else {
+            b->aborting = false;
+        }
+    }
+    bool completed = x && result != 0;
+    if (completed) b->active = NULL;
+    start_next(b);
+    spin_unlock(b->lock, save);
+    if (completed) { //fora do lock: o callback pode submeter outra transação
+        x->cpu_us += time_us_32() - start;
+        total_cpu_us += x->cpu_us;
+        x->result = result;
+        if (x->callback) x->callback(x);
+    }
+    __sev(); //acorda quem espera em i2c_dma_wait()
+}
+
+static void i2c0_dma_irq(void) { bus_irq(&buses[0]); }
+static void i2c1_dma_irq(void) { bus_irq(&buses[1]); }
+
+int i2c_dma_init(i2c_inst_t *i2c) {
+    unsigned idx = i2c_hw_index(i2c);
+    i2c_dma_bus_t *b = &buses[idx];
+    if (b->i2c) return 0;
+    b->i2c = i2c;
+    b->tx_chan = dma_claim_unused_channel(false);
+    b->rx_chan = dma_claim_unused_channel(false);
+    if (b->tx_chan < 0 || b->rx_chan < 0) return -1;
+    b->lock = spin_lock_instance(spin_lock_claim_unused(true));
+    i2c_hw_t *hw = i2c_get_hw(i2c);
+    hw->dma_cr = I2C_IC_DMA_CR_TDMAE_BITS | I2C_IC_DMA_CR_RDMAE_BITS;
+    hw->intr_mask = I2C_IC_INTR_MASK_M_STOP_DET_BITS | I2C_IC_INTR_MASK_M_TX_ABRT_BITS;
+    unsigned irq = idx ? I2C1_IRQ : I2C0_IRQ;
+    irq_set_exclusive_handler(irq, idx ? i2c1_dma_irq : i2c0_dma_irq);
+    irq_set_enabled(irq, true);
+    return 0;
+}
+
+int i2c_dma_submit(i2c_dma_xfer_t *x) {
+    i2c_dma_bus_t *b = &buses[i2c_hw_index(x->i2c)];
+    if (!b->i2c || x->tx_len + x->rx_len == 0 || x->tx_len + x->rx_len > I2C_DMA_MAX_BYTES) return -1;
+    uint32_t save = spin_lock_blocking(b->lock);
+    if (b->head - b->tail == I2C_DMA_QUEUE_LEN) {
+        spin_unlock(b->lock, save);
+        return -1;
+    }
+    x->result = I2C_DMA_PENDING;
+    x->cpu_us = 0;
+    b->queue[b->head % I2C_DMA_QUEUE_LEN] = x;
+    b->head++;
+    start_next(b);
+    spin_unlock(b->lock, save);
+    return 0;
+}
+
+int i2c_dma_wait(i2c_dma_xfer_t *x) {
+    while (x->result == I2C_DMA_PENDING)
+        __wfe();
+    return x->result;
+}
+
+bool i2c_dma_idle(i2c_inst_t *i2c) {
+    const i2c_dma_bus_t *b = &buses[i2c_hw_index(i2c)];
+    return !b->active && b->head == b->tail;
+}
+
+#else //sem I2C_DMA: transações executadas na hora com as chamadas bloqueantes do SDK
+
+int i2c_dma_init(i2c_inst_t *i2c) {
+    (void)i2c;
+    return 0;
+}
+
+int i2c_dma_submit(i2c_dma_xfer_t *x) {
+    if (x->tx_len + x->rx_len == 0) return -1;
+    uint32_t start = time_us_32();
+    int result = 0;
+    if (x->tx_len)
+        result = i2c_write_blocking(x->i2c, x->addr, x->tx, x->tx_len, x->rx_len != 0);
+    if (result >= 0 && x->rx_len)
+        result = i2c_read_blocking(x->i2c, x->addr, x->rx, x->rx_len, false);
+    x->cpu_us = time_us_32() - start; //CPU presa durante todo o tempo de fio
+    total_cpu_us += x->cpu_us;
+    x->result = result;
+    if (x->callback) x->callback(x);
+    return 0;
+}
+
+int i2c_dma_wait(i2c_dma_xfer_t *x) {
+    return x->result;
+}
+
+bool i2c_dma_idle(i2c_inst_t *i2c) {
+    (void)i2c;
+    return true;
+}
+
+#endif
+
+uint32_t i2c_dma_cpu_us(void) {
+    return total_cpu_us;
+}
+
+static int transfer_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t src_len,
+                             uint8_t *dst, size_t dst_len) {
+    i2c_dma_xfer_t x = {i2c, addr, src, src_len, dst, dst_len, NULL, NULL, I2C_DMA_PENDING, 0};
+    if (i2c_dma_submit(&x) != 0) return PICO_ERROR_GENERIC;
+    return i2c_dma_wait(&x);
+}
+
+int i2c_dma_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len) {
+    return transfer_blocking(i2c, addr, src, len, NULL, 0);
+}
+
+int i2c_dma_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len) {
+    return transfer_blocking(i2c, addr, NULL, 0, dst, len);
+}
+
+int i2c_dma_write_read_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t src_len,
+                                uint8_t *dst, size_t dst_len) {
+    return transfer_blocking(i2c, addr, src, src_len, dst, dst_len);
+}
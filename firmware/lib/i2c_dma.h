@@ -0,0 +1,45 @@
+#ifndef I2C_DMA_H
+#define I2C_DMA_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "hardware/i2c.h"
+
+//fila de transações I2C por barramento. Com I2C_DMA, cada transação é enviada por dois canais de
+//DMA (comandos -> IC_DATA_CMD e IC_DATA_CMD -> buffer de leitura) e concluída no IRQ do I2C
+//(STOP_DET ou TX_ABRT): a CPU só monta os comandos e trata o IRQ. Sem I2C_DMA, as mesmas chamadas
+//executam i2c_write_blocking/i2c_read_blocking na hora, como referência de comparação
+#define I2C_DMA_QUEUE_LEN 8    //transações pendentes por barramento
+#define I2C_DMA_MAX_BYTES 1040 //escrita + leitura por transação (frame SSD1306: 1037 bytes com a janela)
+#define I2C_DMA_PENDING   (-100)
+
+typedef struct i2c_dma_xfer i2c_dma_xfer_t;
+typedef void (*i2c_dma_callback_t)(i2c_dma_xfer_t *xfer); //chamado no IRQ ao concluir
+
+struct i2c_dma_xfer {
+    i2c_inst_t *i2c;
+    uint8_t addr;
+    const uint8_t *tx;            //bytes escritos (pode ser NULL se tx_len == 0)
+    size_t tx_len;
+    uint8_t *rx;                  //bytes lidos após repeated start (pode ser NULL se rx_len == 0)
+    size_t rx_len;
+    i2c_dma_callback_t callback;  //opcional
+    void *user;
+    volatile int result;          //I2C_DMA_PENDING, bytes transferidos ou PICO_ERROR_GENERIC
+    uint32_t cpu_us;              //tempo de CPU gasto nesta transação (montagem + IRQ, ou bloqueio)
+};
+
+int  i2c_dma_init(i2c_inst_t *i2c);       //reserva canais e IRQ do barramento; 0 se OK
+int  i2c_dma_submit(i2c_dma_xfer_t *xfer); //enfileira e retorna; 0 se OK, -1 se fila cheia/inválida
+int  i2c_dma_wait(i2c_dma_xfer_t *xfer);   //dorme (__wfe) até concluir; retorna result
+bool i2c_dma_idle(i2c_inst_t *i2c);        //nenhuma transação pendente no barramento
+uint32_t i2c_dma_cpu_us(void);             //CPU acumulada em transações I2C (todos os barramentos)
+
+//wrappers bloqueantes com a semântica de retorno do SDK (bytes ou PICO_ERROR_GENERIC)
+int i2c_dma_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len);
+int i2c_dma_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len);
+int i2c_dma_write_read_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t src_len,
+                                uint8_t *dst, size_t dst_len); //escrita + repeated start + leitura
+
+#endif //I2C_DMA_H
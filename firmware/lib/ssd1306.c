@@ -1,6 +1,8 @@
 #include "ssd1306.h"
 #include "font.h"
+#include "font_atlas.h" // Glifos já em colunas da GDDRAM (tools/gen_font_atlas.py)
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "hardware/i2c.h"
 
@@ -11,18 +13,21 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
     ssd->pages = height / 8;
     ssd->address = address;
     ssd->i2c_port = i2c;
-    ssd->bufsize = ssd->pages * ssd->width + 1;
+    ssd->bufsize = ssd->pages * ssd->width;
     
-    // Aloca buffer de dados
+    // Aloca buffer de dados e de envio (retângulos ocupam páginas distintas: no máximo um frame + cabeçalhos)
     ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    if (ssd->ram_buffer == NULL) {
+    ssd->tx_buffer = malloc(ssd->bufsize + SSD1306_MAX_RECTS * SSD1306_RECT_HEADER);
+    if (ssd->ram_buffer == NULL || ssd->tx_buffer == NULL || ssd->pages > SSD1306_MAX_PAGES) {
         // Em caso de falha, poderia adicionar tratamento de erro (ex.: log ou loop infinito)
         while (1);
     }
     
     // Inicializa buffers
-    ssd->ram_buffer[0] = 0x40; // Prefixo de dados
     ssd->port_buffer[0] = 0x00; // Prefixo de comando (Co=0, D/C=0)
+    ssd->num_xfers = 0;         // Nenhum flush pendente
+    ssd->flush_bytes = 0;
+    ssd1306_invalidate(ssd);    // GDDRAM do display tem conteúdo indefinido até o primeiro frame
 }
 
 // Configura os parâmetros iniciais do display
@@ -57,38 +62,151 @@ void ssd1306_config(ssd1306_t *ssd) {
 // Envia um comando para o display via I2C
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
     ssd->port_buffer[1] = command;
-    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false);
+    i2c_dma_write_blocking(ssd->i2c_port, ssd->address, ssd->port_buffer, 2);
 }
 
-// Envia o buffer de dados para o display
+// Envia as regiões alteradas do buffer para o display
 void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, 0x21); // Define endereço de coluna
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, 0x22); // Define endereço de página
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false);
+    ssd1306_send_data_async(ssd);
+    ssd1306_wait(ssd);
+}
+
+// Marca colunas x0..x1 da página como alteradas
+static inline void mark_dirty(ssd1306_t *ssd, uint8_t page, uint8_t x0, uint8_t x1) {
+    if (x0 < ssd->dirty_x0[page]) ssd->dirty_x0[page] = x0;
+    if (x1 > ssd->dirty_x1[page]) ssd->dirty_x1[page] = x1;
+}
+
+// Escreve um byte da GDDRAM local; só marca a coluna se o conteúdo mudou
+static inline void put_byte(ssd1306_t *ssd, uint8_t page, uint8_t x, uint8_t value) {
+    uint8_t *b = &ssd->ram_buffer[page * ssd->width + x];
+    if (*b == value) return;
+    *b = value;
+    mark_dirty(ssd, page, x, x);
+}
+
+void ssd1306_invalidate(ssd1306_t *ssd) {
+    for (uint8_t p = 0; p < ssd->pages; ++p) {
+        ssd->dirty_x0[p] = 0;
+        ssd->dirty_x1[p] = ssd->width - 1;
+    }
+}
+
+// Copia o retângulo (páginas p0..p1, colunas x0..x1) para tx_buffer e o enfileira como uma transação:
+// janela de colunas/páginas em comandos com Co=1 seguida do stream de dados, no mesmo START/STOP
+static void submit_rect(ssd1306_t *ssd, uint8_t *dst, uint8_t x0, uint8_t x1, uint8_t p0, uint8_t p1) {
+    const uint8_t header[SSD1306_RECT_HEADER] = {
+        0x80, 0x21, 0x80, x0, 0x80, x1, // Define endereço de coluna
+        0x80, 0x22, 0x80, p0, 0x80, p1, // Define endereço de página
+        0x40,                           // Prefixo de dados: o restante da transação vai para a GDDRAM
+    };
+    uint8_t *out = dst;
+    for (int i = 0; i < SSD1306_RECT_HEADER; i++) *out++ = header[i];
+    uint8_t w = x1 - x0 + 1;
+    for (uint8_t p = p0; p <= p1; ++p) {
+        memcpy(out, &ssd->ram_buffer[p * ssd->width + x0], w);
+        out += w;
+    }
+    i2c_dma_xfer_t *x = &ssd->xfers[ssd->num_xfers++];
+    *x = (i2c_dma_xfer_t){ssd->i2c_port, ssd->address, dst, (size_t)(out - dst), NULL, 0, NULL, NULL, 0, 0};
+    ssd->flush_bytes += x->tx_len + 1; // + byte de endereço
+    i2c_dma_submit(x);
+}
+
+// Agrupa páginas alteradas consecutivas em retângulos e enfileira um por transação; a CPU fica livre durante o envio
+void ssd1306_send_data_async(ssd1306_t *ssd) {
+    ssd1306_wait(ssd); // Flush anterior ainda pode estar lendo tx_buffer
+    ssd->num_xfers = 0;
+    ssd->flush_bytes = 0;
+    uint8_t *dst = ssd->tx_buffer;
+    int open = 0;       // Retângulo em formação
+    uint8_t x0 = 0, x1 = 0, p0 = 0, p1 = 0;
+    uint16_t area = 0;  // Bytes realmente alterados no retângulo em formação
+    for (uint8_t p = 0; p <= ssd->pages; ++p) {
+        bool dirty = p < ssd->pages && ssd->dirty_x0[p] <= ssd->dirty_x1[p];
+        if (open) {
+            bool last = ssd->num_xfers == SSD1306_MAX_RECTS - 1; // Limite de transações: o resto vai neste
+            if (dirty) {
+                // Funde com o retângulo anterior se as colunas extras custam menos que uma transação nova
+                uint8_t nx0 = ssd->dirty_x0[p] < x0 ? ssd->dirty_x0[p] : x0;
+                uint8_t nx1 = ssd->dirty_x1[p] > x1 ? ssd->dirty_x1[p] : x1;
+                uint16_t page_w = ssd->dirty_x1[p] - ssd->dirty_x0[p] + 1;
+                int merged = (nx1 - nx0 + 1) * (p - p0 + 1);
+                if (last || merged - (area + page_w) <= SSD1306_RECT_HEADER + 1) {
+                    x0 = nx0; x1 = nx1; p1 = p;
+                    area += page_w;
+                    continue;
+                }
+            } else if (last && p < ssd->pages) {
+                continue;
+            }
+            submit_rect(ssd, dst, x0, x1, p0, p1);
+            dst += SSD1306_RECT_HEADER + (x1 - x0 + 1) * (p1 - p0 + 1);
+            open = 0;
+        }
+        if (dirty) {
+            x0 = ssd->dirty_x0[p]; x1 = ssd->dirty_x1[p]; p0 = p1 = p;
+            area = x1 - x0 + 1;
+            open = 1;
+        }
+    }
+    for (uint8_t p = 0; p < ssd->pages; ++p) { // Tudo enviado: páginas limpas
+        ssd->dirty_x0[p] = 0xFF;
+        ssd->dirty_x1[p] = 0;
+    }
+}
+
+bool ssd1306_busy(ssd1306_t *ssd) {
+    for (uint8_t i = 0; i < ssd->num_xfers; ++i)
+        if (ssd->xfers[i].result == I2C_DMA_PENDING) return true;
+    return false;
+}
+
+void ssd1306_wait(ssd1306_t *ssd) {
+    for (uint8_t i = 0; i < ssd->num_xfers; ++i)
+        if (ssd->xfers[i].result == I2C_DMA_PENDING) i2c_dma_wait(&ssd->xfers[i]);
+}
+
+uint32_t ssd1306_frame_cpu_us(const ssd1306_t *ssd) {
+    uint32_t us = 0;
+    for (uint8_t i = 0; i < ssd->num_xfers; ++i) us += ssd->xfers[i].cpu_us;
+    return us;
+}
+
+uint16_t ssd1306_flush_bytes(const ssd1306_t *ssd) {
+    return ssd->flush_bytes;
+}
+
+uint8_t ssd1306_flush_rects(const ssd1306_t *ssd) {
+    return ssd->num_xfers;
 }
 
 // Desenha um pixel no buffer
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     if (x >= ssd->width || y >= ssd->height) return; // Verifica limites
-    uint16_t index = (y / 8) * ssd->width + x + 1;
-    uint8_t pixel = y % 8;
-    if (value) {
-        ssd->ram_buffer[index] |= (1 << pixel);
-    } else {
-        ssd->ram_buffer[index] &= ~(1 << pixel);
-    }
+    uint8_t page = y / 8;
+    uint8_t old = ssd->ram_buffer[page * ssd->width + x];
+    uint8_t bit = 1 << (y % 8);
+    put_byte(ssd, page, x, value ? (old | bit) : (old & ~bit));
 }
 
-// Preenche a tela com pixels ligados ou desligados
+// Preenche a tela com pixels ligados ou desligados (byte a byte)
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
+    ssd1306_fill_rect(ssd, 0, 0, ssd->width, ssd->height, value);
+}
+
+// Preenche um retângulo byte a byte: páginas inteiras recebem 0x00/0xFF, as das bordas uma máscara
+void ssd1306_fill_rect(ssd1306_t *ssd, uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool value) {
+    if (x >= ssd->width || y >= ssd->height || width == 0 || height == 0) return;
+    uint8_t x1 = (x + width > ssd->width) ? ssd->width - 1 : x + width - 1;
+    uint8_t y1 = (y + height > ssd->height) ? ssd->height - 1 : y + height - 1;
+    for (uint8_t page = y / 8; page <= y1 / 8; ++page) {
+        uint8_t top = page == y / 8 ? y % 8 : 0;
+        uint8_t bottom = page == y1 / 8 ? y1 % 8 : 7;
+        uint8_t mask = (uint8_t)((0xFF << top) & (0xFF >> (7 - bottom)));
+        uint8_t *row = &ssd->ram_buffer[page * ssd->width];
+        for (uint8_t col = x; col <= x1; ++col)
+            put_byte(ssd, page, col, value ? (row[col] | mask) : (row[col] & ~mask));
     }
 }
 
@@ -115,54 +233,27 @@ void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y, bool use_sm
         return;
     }
 
-    uint16_t index = 0;
-    bool rotate = false;
-
-    // Mapeia caracteres
-    if (c >= '0' && c <= '9') {
-        index = (c - '0' + 1) * 8;
-    } else if (c >= 'A' && c <= 'Z') {
-        index = (c - 'A' + 11) * 8;
-    } else if (c >= 'a' && c <= 'z') {
-        index = (c - 'a' + 37) * 8;
-    } else if (c == ':') {
-        index = 64 * 8;
-        rotate = true;
-    } else if (c == '.') {
-        index = 65 * 8;
-        rotate = true;
-    } else if (c == '>') {
-        index = 66 * 8;
-        rotate = true;
-    } else if (c == '-') {
-        index = 67 * 8;
-        rotate = true;
-    } else if (c == 127) {
-        index = 68 * 8; // Símbolo Ohm
-    } else if (c == '!') {
-        index = 69 * 8;
-        rotate = true;
-    }
-    else if (c == '%') {
-        index = 70 * 8;
-        rotate = true;
-    } 
-    else if (c == '/') {
-        index = 71 * 8;
-        rotate = true;
-    } 
-    else {
-        return; // Caractere não suportado
-    }
-
-    // Renderiza caractere
-    for (uint8_t i = 0; i < 8; ++i) {
-        uint8_t line = font[index + i];
-        for (uint8_t j = 0; j < 8; ++j) {
-            bool pixel_value = rotate ? (line >> j) & 0x01 : (line >> j) & 0x01;
-            ssd1306_pixel(ssd, x + (rotate ? (7 - j) : i), y + (rotate ? i : j), pixel_value);
-        }
+    if ((uint8_t)c < FONT_ATLAS_FIRST || (uint8_t)c > FONT_ATLAS_LAST) return;
+    uint8_t glyph = font_atlas_index[(uint8_t)c - FONT_ATLAS_FIRST];
+    if (glyph == FONT_ATLAS_NONE || x >= ssd->width || y >= ssd->height) return; // Caractere não suportado
+    const uint8_t *cols = font_atlas[glyph];
+    uint8_t w = ssd->width - x < 8 ? ssd->width - x : 8; // Corta na borda direita
+    uint8_t page = y / 8, shift = y % 8;
+
+    // Linha alinhada a página: um byte por coluna, célula 8x8 opaca
+    if (shift == 0) {
+        for (uint8_t i = 0; i < w; ++i) put_byte(ssd, page, x + i, cols[i]);
+        return;
     }
+    // Linha desalinhada: parte de cima na página y/8 e o resto na seguinte, preservando os demais bits
+    uint8_t mask_lo = 0xFF << shift, mask_hi = 0xFF >> (8 - shift);
+    uint8_t *lo = &ssd->ram_buffer[page * ssd->width + x];
+    for (uint8_t i = 0; i < w; ++i)
+        put_byte(ssd, page, x + i, (lo[i] & ~mask_lo) | (uint8_t)(cols[i] << shift));
+    if (page + 1 >= ssd->pages) return;
+    uint8_t *hi = lo + ssd->width;
+    for (uint8_t i = 0; i < w; ++i)
+        put_byte(ssd, page + 1, x + i, (hi[i] & ~mask_hi) | (cols[i] >> (8 - shift)));
 }
 
 // Desenha uma string
@@ -186,6 +277,10 @@ void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y,
 
 // Desenha um retângulo
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill) {
+    if (fill) {
+        ssd1306_fill_rect(ssd, left, top, width, height, value);
+        return;
+    }
     for (uint8_t x = left; x < left + width; ++x) {
         ssd1306_pixel(ssd, x, top, value);
         ssd1306_pixel(ssd, x, top + height - 1, value);
@@ -194,13 +289,6 @@ void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint
         ssd1306_pixel(ssd, left, y, value);
         ssd1306_pixel(ssd, left + width - 1, y, value);
     }
-    if (fill) {
-        for (uint8_t x = left + 1; x < left + width - 1; ++x) {
-            for (uint8_t y = top + 1; y < top + height - 1; ++y) {
-                ssd1306_pixel(ssd, x, y, value);
-            }
-        }
-    }
 }
 
 // Desenha uma linha (Bresenham)
@@ -5,14 +5,25 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "hardware/i2c.h"
+#include "i2c_dma.h"
+
+#define SSD1306_MAX_PAGES   8  // 64 linhas
+#define SSD1306_MAX_RECTS   4  // Retângulos (transações) por flush; além disso os vizinhos são fundidos
+#define SSD1306_RECT_HEADER 13 // 6 comandos com Co=1 (janela) + byte de controle do stream de dados
 
 // Estrutura principal do display SSD1306
 typedef struct {
     uint8_t width, height, pages, address;
     i2c_inst_t *i2c_port;
     uint16_t bufsize;
-    uint8_t *ram_buffer;
+    uint8_t *ram_buffer;      // GDDRAM local: [página][coluna], um byte = 8 linhas
     uint8_t port_buffer[2];
+    uint8_t dirty_x0[SSD1306_MAX_PAGES]; // Colunas alteradas desde o último flush, por página (x0 > x1: limpa)
+    uint8_t dirty_x1[SSD1306_MAX_PAGES];
+    uint8_t *tx_buffer;       // Cópia dos retângulos enviados (cabeçalho + bytes), livre para redesenhar
+    i2c_dma_xfer_t xfers[SSD1306_MAX_RECTS]; // Transações do último flush assíncrono
+    uint8_t num_xfers;
+    uint16_t flush_bytes;     // Bytes no fio do último flush (dados + byte de endereço de cada transação)
 } ssd1306_t;
 
 // Inicialização e configuração
@@ -23,10 +34,20 @@ void ssd1306_config(ssd1306_t *ssd);
 // Comunicação I2C
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
+// Flush assíncrono: envia só os retângulos alterados (uma transação cada) e retorna; os bytes são
+// copiados para tx_buffer, então ram_buffer pode ser redesenhado enquanto o envio continua
+void ssd1306_send_data_async(ssd1306_t *ssd);
+void ssd1306_invalidate(ssd1306_t *ssd); // Força o próximo flush a enviar o frame inteiro
+bool ssd1306_busy(ssd1306_t *ssd);
+void ssd1306_wait(ssd1306_t *ssd);
+uint32_t ssd1306_frame_cpu_us(const ssd1306_t *ssd); // CPU gasta no último frame (montagem + IRQ, ou bloqueio)
+uint16_t ssd1306_flush_bytes(const ssd1306_t *ssd);  // Bytes no fio do último flush
+uint8_t ssd1306_flush_rects(const ssd1306_t *ssd);   // Retângulos (transações) do último flush
 
 // Funções de desenho básicas
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
+void ssd1306_fill_rect(ssd1306_t *ssd, uint8_t x, uint8_t y, uint8_t width, uint8_t height, bool value);
 
 // Funções de linhas
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1, bool value);
@@ -2,132 +2,563 @@
 #include "hardware/i2c.h"
 #include <stdio.h>
 #include <string.h>
+#include <stdlib.h>
 #include <math.h>
 #include "tflm_wrapper.h"
+#ifndef MODEL_RAW_INPUT
 #include "scaler_params.h" //parâmetros de normalização (mean e scale) gerados no treino
+#endif
 #include "ssd1306.h"
 #include "font.h"
 #include "aht20.h"
 #include "bmp280.h"
+#include "i2c_dma.h"
+#include "sensor_window.h" //WINDOW_SIZE, NUM_FEATURES e janela cronológica
+#include "sensor_acquisition.h"
+#include "cycle_counter.h"
+#include "telemetry.h"
+#include "sample_scheduler.h"
+#ifdef FIXED_POINT_INPUT
+#include "sensor_fixed.h"
+#endif
+#ifdef MULTICORE_PIPELINE
+#include "pico/multicore.h"
+#include "sample_queue.h"
+#endif
+#if defined(WINDOW_CHECKPOINT) || defined(FLASH_LOG)
+#include "pico/flash.h"
+#endif
+#ifdef WINDOW_CHECKPOINT
+#include "window_checkpoint.h"
+#endif
+#ifdef FLASH_LOG
+#include "flash_log.h"
+#endif
+#ifdef LOW_POWER
+#include "power_manager.h"
+#endif
+#ifdef MODEL_CASCADE
+#include "model_cascade.h"
+#endif
 
-#define WINDOW_SIZE        10    //tamanho da janela temporal usada pelo modelo
-#define NUM_FEATURES       4     //Temp_AHT20, Umid_AHT20, Temp_BMP280, Press_BMP280
 #define NUM_HORIZONS       3     //número de previsões: 5, 10 e 15 minutos
 #define SAMPLE_INTERVAL_MS 31000 //intervalo entre coletas em ms
+#define IDLE_POLL_MS       100   //entre amostras: comandos do serial e relógio do checkpoint
+#ifndef I2C0_BAUDRATE
+#define I2C0_BAUDRATE      (100 * 1000) //AHT20 e BMP280 aceitam Fast-mode (400kHz): -DI2C0_FAST_MODE=ON
+#endif
+#define I2C1_BAUDRATE      (400 * 1000) //display
+#ifdef TELEMETRY_BINARY
+#define TELEMETRY_DEFAULT_MODE TELEMETRY_MODE_BINARY //registros COBS desde a primeira amostra ('t' volta ao texto)
+#else
+#define TELEMETRY_DEFAULT_MODE TELEMETRY_MODE_TEXT
+#endif
+#ifdef OP_PROFILER
+#include "op_profiler.h"
+#ifndef OP_PROFILER_DUMP_EVERY
+#define OP_PROFILER_DUMP_EVERY 10 //imprime o perfil por operador a cada N predições
+#endif
+#endif
 
 ssd1306_t display;
 
-static float sensor_window[WINDOW_SIZE][NUM_FEATURES]; //buffer circular: 10 amostras × 4 features
-static int window_pos = 0;
-static bool window_full = false;
+static sensor_window_t sensor_window; //anel espelhado: 10 amostras × 4 features normalizadas
+static uint32_t window_seq;           //prazo na grade do agendador da amostra mais nova da janela
 static struct bmp280_calib_param bmp_params; //calibração lida uma vez na inicialização
+static sensor_acquisition_t acquisition;      //AHT20 + BMP280 sobrepostos no I2C0
+static uint32_t first_sample_delay_ms = SAMPLE_INTERVAL_MS; //menor com uma janela salva antes do reset
+static uint32_t acquisition_us;       //última aquisição (core0 no pipeline em dois núcleos)
+static telemetry_timing_t cycle_timing; //display e latência do ciclo, no registro TIMING
+#ifdef FLASH_LOG
+static flash_log_record_t log_record;  //amostra do ciclo atual; a previsão é preenchida se houver
+static uint64_t log_t_ms;
+#endif
 
-//lê temperatura e umidade do AHT20, retorna 0 se OK
-int read_aht20(float* temp_c, float* humidity_pct) {
-    AHT20_Data dados_aht;
-    if (!aht20_read(i2c0, &dados_aht)) return -1;
-    *temp_c = dados_aht.temperature;
-    *humidity_pct = dados_aht.humidity;
+//lê temperatura e umidade do AHT20 (contagens de 20 bits), retorna 0 se OK
+int read_aht20(sensor_counts_t* s) {
+    AHT20_Raw dados_aht;
+    if (!aht20_read_raw(i2c0, &dados_aht)) return -1;
+    s->v[0] = (int32_t)dados_aht.temperature;
+    s->v[1] = (int32_t)dados_aht.humidity;
     return 0;
 }
 
-//lê temperatura e pressão do BMP280, aplica calibração, retorna 0 se OK
-int read_bmp280(float* temp_c, float* pressure_hpa) {
+//lê temperatura (°C x100) e pressão (Pa) do BMP280 com a compensação inteira, retorna 0 se OK
+int read_bmp280(sensor_counts_t* s) {
     int32_t temp_raw, press_raw;
     bmp280_read_raw(i2c0, &temp_raw, &press_raw);
-    int32_t temp_conv  = bmp280_convert_temp(temp_raw, &bmp_params);
-    int32_t press_conv = bmp280_convert_pressure(press_raw, temp_raw, &bmp_params);
-    *temp_c       = temp_conv / 100.0f;  //°C
-    *pressure_hpa = press_conv / 100.0f; //Pa -> hPa
+    s->v[2] = bmp280_convert_temp(temp_raw, &bmp_params);
+    s->v[3] = bmp280_convert_pressure(press_raw, temp_raw, &bmp_params);
     return 0;
 }
 
+#ifndef FIXED_POINT_INPUT
+//caminho float (referência): contagens -> unidades físicas (°C, %, °C, hPa)
+void counts_to_physical(const sensor_counts_t* s, float raw[NUM_FEATURES]) {
+    AHT20_Raw aht = {(uint32_t)s->v[0], (uint32_t)s->v[1]};
+    AHT20_Data dados_aht;
+    aht20_convert(&aht, &dados_aht);
+    raw[0] = dados_aht.temperature;
+    raw[1] = dados_aht.humidity;
+    raw[2] = s->v[2] / 100.0f; //°C
+    raw[3] = s->v[3] / 100.0f; //Pa -> hPa
+}
+
+#ifndef MODEL_RAW_INPUT
 //normalização z-score com parâmetros do scaler treinado: (x - mean) / scale
 void normalize_feature(float* feature, int feature_idx) {
     *feature = (*feature - scaler_mean[feature_idx]) / scaler_scale[feature_idx];
 }
+#endif
+#endif
+
+#if defined(FIXED_POINT_INPUT) && defined(MODEL_RAW_INPUT)
+//modelo com o scaler dobrado na primeira camada: o caminho inteiro entrega unidades físicas em Q15.16
+static const float raw_mean[NUM_FEATURES]  = {0.0f, 0.0f, 0.0f, 0.0f};
+static const float raw_scale[NUM_FEATURES] = {1.0f, 1.0f, 1.0f, 1.0f};
+#endif
 
-//monta o tensor de entrada, executa inferência e exibe previsões no serial e display
+//executa inferência sobre a janela cronológica e exibe previsões no serial e display
 void run_temperature_prediction(void) {
-    int in_size, out_size;
-    float* input  = tflm_input_ptr(&in_size);
+    int out_size;
     float* output = tflm_output_ptr(&out_size);
-    if (!input || !output) {
-        printf("ERRO: Tensores inválidos\n");
+    if (!output) {
+        telemetry_printf("ERRO: Tensores inválidos\n");
         return;
     }
-    printf("\n=== Nova Predição ===\n");
-    for (int t = 0; t < WINDOW_SIZE; t++) { //preenche tensor [1, 10, 4]
-        for (int f = 0; f < NUM_FEATURES; f++)
-            input[t * NUM_FEATURES + f] = sensor_window[t][f];
-    }
-    int rc = tflm_invoke(); //executa CNN 1D
+    telemetry_printf("\n=== Nova Predição ===\n");
+#ifdef LOW_POWER
+    power_phase(POWER_PHASE_INFER); //clk_sys de boost só para o invoke e a saída
+#endif
+#if defined(MODEL_CASCADE)
+    int rc = model_cascade_invoke(sensor_window_view(&sensor_window), window_seq); //barato e, se volátil, o completo
+#elif defined(TFLM_STREAMING)
+    int rc = tflm_stream_invoke(); //colunas das convoluções já calculadas em collect_sensor_sample()
+#else
+    int rc = tflm_invoke(); //executa CNN 1D sobre a janela vinculada em collect_sensor_sample()
+#endif
+#ifdef LOW_POWER
+    power_phase(POWER_PHASE_OUTPUT);
+#endif
     if (rc != 0) {
-        printf("ERRO tflm_invoke: %d\n", rc);
+        telemetry_printf("ERRO tflm_invoke: %d\n", rc);
+        telemetry_error(TELEMETRY_ERR_INVOKE, rc);
         return;
     }
-    printf("Previsões de Temperatura (AHT20):\n");
-    printf("  +5 min:  %.2f °C\n", output[0]);
-    printf("  +10 min: %.2f °C\n", output[1]);
-    printf("  +15 min: %.2f °C\n", output[2]);
-    ssd1306_fill(&display, false);
-    char line[24];
-    snprintf(line, sizeof(line), "Temp Prediction");
-    ssd1306_draw_string(&display, line, 0, 0, false);
-    snprintf(line, sizeof(line), "+5m:  %.2fC", output[0]);
-    ssd1306_draw_string(&display, line, 0, 16, false);
-    snprintf(line, sizeof(line), "+10m: %.2fC", output[1]);
-    ssd1306_draw_string(&display, line, 0, 28, false);
-    snprintf(line, sizeof(line), "+15m: %.2fC", output[2]);
-    ssd1306_draw_string(&display, line, 0, 40, false);
-    ssd1306_send_data(&display);
+    const char* model = tflm_model_info(tflm_active_model())->name;
+#ifdef TFLM_STREAMING
+    telemetry_printf("Inferência %s: %lu us (%d MACs)\n", model, (unsigned long)tflm_last_invoke_us(),
+                     tflm_macs_per_invoke());
+#else
+    telemetry_printf("Inferência %s: %lu us\n", model, (unsigned long)tflm_last_invoke_us());
+#endif
+#ifdef MODEL_CASCADE
+    const cascade_stats_t* cascade = model_cascade_stats();
+    telemetry_printf("Cascata: variação %.3f °C, resíduo %.3f °C -> %s (%lu/%lu escaladas, %llu ciclos/predição)\n",
+                     cascade->last_slope, cascade->last_residual, cascade->last_escalated ? "completo" : "barato",
+                     (unsigned long)cascade->escalations, (unsigned long)cascade->predictions,
+                     (unsigned long long)(cascade->cycles / cascade->predictions));
+#endif
+    telemetry_printf("Previsões de Temperatura (AHT20):\n");
+    telemetry_printf("  +5 min:  %.2f °C\n", output[0]);
+    telemetry_printf("  +10 min: %.2f °C\n", output[1]);
+    telemetry_printf("  +15 min: %.2f °C\n", output[2]);
+    telemetry_prediction_t prediction = {0, {output[0], output[1], output[2]}, tflm_last_invoke_us(),
+                                         (uint8_t)tflm_active_model(), {0}};
+    telemetry_prediction(&prediction);
+#ifdef FLASH_LOG
+    for (int i = 0; i < NUM_HORIZONS; i++)
+        log_record.pred_centi[i] = (int16_t)lroundf(output[i] * 100.0f);
+    log_record.invoke_us = tflm_last_invoke_us();
+#endif
+    static bool prediction_screen = false; //título e rótulos desenhados uma vez; depois só os valores
+    if (!prediction_screen) {
+        ssd1306_fill(&display, false);
+        ssd1306_draw_string(&display, "Temp Prediction", 0, 0, false);
+        ssd1306_draw_string(&display, "+5m:", 0, 16, false);
+        ssd1306_draw_string(&display, "+10m:", 0, 28, false);
+        ssd1306_draw_string(&display, "+15m:", 0, 40, false);
+        prediction_screen = true;
+    }
+    //largura fixa: cada glifo (inclusive espaço) sobrescreve sua célula 8x8, então só os dígitos
+    //que mudaram marcam colunas sujas e o flush envia apenas esses retângulos
+    static const uint8_t rows[3] = {16, 28, 40};
+    for (int i = 0; i < 3; i++) {
+        char value[16], line[16];
+        snprintf(value, sizeof(value), "%.2fC", output[i]);
+        snprintf(line, sizeof(line), "%-8s", value); //espaços apagam sobras de um valor mais longo
+        ssd1306_draw_string(&display, line, 48, rows[i], false);
+    }
+    ssd1306_send_data_async(&display); //com I2C_DMA retorna logo; os retângulos seguem por DMA no I2C1
+    telemetry_printf("Display: %u bytes em %u retângulos, %lu us de CPU no envio\n",
+                     ssd1306_flush_bytes(&display), ssd1306_flush_rects(&display),
+                     (unsigned long)ssd1306_frame_cpu_us(&display));
+    cycle_timing.display_cpu_us = ssd1306_frame_cpu_us(&display);
+    cycle_timing.display_bytes = (uint16_t)ssd1306_flush_bytes(&display);
+    cycle_timing.display_rects = (uint16_t)ssd1306_flush_rects(&display);
+#ifdef OP_PROFILER
+    if (op_profiler_invokes() % OP_PROFILER_DUMP_EVERY == 0)
+        op_profiler_dump();
+#endif
 }
 
-//coleta uma amostra dos sensores, normaliza e insere no buffer circular
-int collect_sensor_sample(void) {
-    float temp_aht20, humidity_aht20, temp_bmp280, pressure_bmp280;
-    if (read_aht20(&temp_aht20, &humidity_aht20) != 0) {
-        printf("ERRO: Falha ao ler AHT20\n");
+//fim do ciclo de amostragem: grava a amostra (e a previsão, se houve) no log da flash e reporta
+//os bytes e ciclos gastos na saída do ciclo
+static void end_sample_cycle(bool predicted) {
+#ifdef FLASH_LOG
+    int rc = flash_log_append(&log_record, log_t_ms);
+    if (rc == 1) {
+        telemetry_printf("Log: página gravada em %lu us (%lu páginas no log, %lu setores apagados)\n",
+                         (unsigned long)flash_log_info()->last_write_us, (unsigned long)flash_log_info()->pages,
+                         (unsigned long)flash_log_info()->erases);
+    } else if (rc < 0) {
+        telemetry_printf("AVISO: falha ao gravar o log na flash\n");
+        telemetry_error(TELEMETRY_ERR_FLASH, rc);
+    }
+#endif
+    telemetry_cycle_end(predicted ? &cycle_timing : NULL);
+}
+
+//atraso das amostras em relação à grade t0 + k * SAMPLE_INTERVAL_MS (núcleo da aquisição)
+static void print_schedule_stats(void) {
+    const sample_scheduler_stats_t* st = sample_scheduler_stats();
+    telemetry_printf("Agenda: %lu amostras, atraso %ld/%lu/%ld us (mín/méd/máx), período %+ld/%+ld us, "
+                     "deriva %lld us, %lu prazos perdidos\n",
+                     (unsigned long)st->samples, (long)st->lateness_min_us,
+                     (unsigned long)(st->lateness_sum_us / st->samples), (long)st->lateness_max_us,
+                     (long)st->period_err_min_us, (long)st->period_err_max_us, (long long)st->drift_us,
+                     (unsigned long)st->missed);
+}
+
+#ifdef LOW_POWER
+//tempo e clk_sys por fase desde o último relatório, e a carga pelo modelo linear de power_manager.h
+static void print_power_stats(void) {
+    const power_stats_t* st = power_stats();
+    telemetry_printf("Energia:");
+    for (int p = 0; p < POWER_PHASE_COUNT; p++)
+        telemetry_printf(" %s %.1f ms a %lu MHz%s", power_phase_name((power_phase_t)p), st->us[p] / 1000.0,
+                         (unsigned long)(st->khz[p] / 1000), p + 1 < POWER_PHASE_COUNT ? "," : "\n");
+    uint64_t charge_uc = power_charge_uc(st);
+    if (st->predictions) {
+        uint64_t per_prediction_uc = charge_uc / st->predictions;
+        telemetry_printf("  %lu trocas de clock (%llu us); estimativa por predição: %llu uC, %.1f mJ a %d mV\n",
+                         (unsigned long)st->transitions, (unsigned long long)st->transition_us,
+                         (unsigned long long)per_prediction_uc,
+                         (double)per_prediction_uc * POWER_SUPPLY_MV / 1e6, POWER_SUPPLY_MV);
+    }
+    power_stats_reset();
+}
+#endif
+
+//comandos de uma letra pelo serial (USB/UART): 't' alterna saída em texto/binária; 'p' imprime o
+//perfil por operador, 'r' zera; 'l' grava a página parcial e envia o log da flash (tools/flash_log_dump.py)
+void poll_serial_commands(void) {
+    int c = getchar_timeout_us(0);
+    if (c == 't') {
+        bool binary = telemetry_text();
+        printf("Telemetria: modo %s\n", binary ? "binário" : "texto");
+        telemetry_set_mode(binary ? TELEMETRY_MODE_BINARY : TELEMETRY_MODE_TEXT);
+    }
+#ifndef MODEL_CASCADE
+    if (c == 'm' && tflm_model_count() > 1) { //próximo modelo do registro, a partir do próximo invoke
+        tflm_select_model((tflm_active_model() + 1) % tflm_model_count());
+        printf("Modelo ativo: %s\n", tflm_model_info(tflm_active_model())->name);
+    }
+#endif
+#ifdef OP_PROFILER
+    if (c == 'p')
+        op_profiler_dump();
+    else if (c == 'r')
+        op_profiler_reset();
+#endif
+#ifdef FLASH_LOG
+    if (c == 'l') {
+        flash_log_flush();
+        flash_log_dump();
+    }
+#endif
+}
+
+//lê uma amostra dos dois sensores (leituras inteiras dos drivers), retorna 0 se OK
+int read_sensor_sample(sensor_counts_t* s) {
+    uint64_t start = time_us_64();
+    uint32_t i2c_cpu = i2c_dma_cpu_us();
+#ifdef SEQUENTIAL_ACQUISITION
+    //referência: AHT20 completo (disparo + espera da conversão) e só depois o BMP280
+    if (read_aht20(s) != 0) {
+        telemetry_printf("ERRO: Falha ao ler AHT20\n");
+        telemetry_error(TELEMETRY_ERR_SENSOR, 0);
+        return -1;
+    }
+    if (read_bmp280(s) != 0) {
+        telemetry_printf("ERRO: Falha ao ler BMP280\n");
+        telemetry_error(TELEMETRY_ERR_SENSOR, 1);
         return -1;
     }
-    if (read_bmp280(&temp_bmp280, &pressure_bmp280) != 0) {
-        printf("ERRO: Falha ao ler BMP280\n");
+#else
+    if (sensor_acquisition_read(&acquisition, s) != 0) { //BMP280 lido durante a conversão do AHT20
+        telemetry_printf("ERRO: Falha ao ler AHT20\n");
+        telemetry_error(TELEMETRY_ERR_SENSOR, 0);
         return -1;
     }
-    printf("Sensores: AHT20=%.2f°C %.2f%% | BMP280=%.2f°C %.2fhPa\n",
-           temp_aht20, humidity_aht20, temp_bmp280, pressure_bmp280);
-    sensor_window[window_pos][0] = temp_aht20;
-    sensor_window[window_pos][1] = humidity_aht20;
-    sensor_window[window_pos][2] = temp_bmp280;
-    sensor_window[window_pos][3] = pressure_bmp280;
+#endif
+    acquisition_us = (uint32_t)(time_us_64() - start);
+    telemetry_printf("Aquisição: %lu us (I2C0 a %d kHz, %lu us de CPU em I2C)\n", (unsigned long)acquisition_us,
+                     I2C0_BAUDRATE / 1000, (unsigned long)(i2c_dma_cpu_us() - i2c_cpu));
+    return 0;
+}
+
+#if !defined(SEQUENTIAL_ACQUISITION) && !defined(MULTICORE_PIPELINE)
+//aquisição dirigida pelo laço principal (ciclo sobreposto): o disparo sai no alarme da amostra e a
+//coleta do AHT20 quando o laço acorda no prazo da conversão; nada dorme dentro da aquisição
+static uint32_t acquisition_i2c_cpu_us; //CPU em I2C do disparo + leitura do BMP280
+
+//dispara o AHT20 e lê o BMP280, retorna 0 se OK
+static int start_sensor_sample(void) {
+    uint32_t i2c_cpu = i2c_dma_cpu_us();
+    int rc = sensor_acquisition_start(&acquisition);
+    acquisition_i2c_cpu_us = i2c_dma_cpu_us() - i2c_cpu;
+    if (rc != 0) {
+        telemetry_printf("ERRO: Falha ao ler AHT20\n");
+        telemetry_error(TELEMETRY_ERR_SENSOR, 0);
+    }
+    return rc;
+}
+
+//coleta o AHT20 se a conversão terminou: 1 amostra em *s, 0 ainda convertendo, -1 erro
+static int poll_sensor_sample(sensor_counts_t* s) {
+    uint32_t i2c_cpu = i2c_dma_cpu_us();
+    int rc = sensor_acquisition_poll(&acquisition);
+    if (rc == 0) return 0;
+    if (rc < 0) {
+        telemetry_printf("ERRO: Falha ao ler AHT20\n");
+        telemetry_error(TELEMETRY_ERR_SENSOR, 0);
+        return -1;
+    }
+    *s = acquisition.counts;
+    acquisition_us = acquisition.sample_us; //disparo -> coleta
+    telemetry_printf("Aquisição: %lu us (I2C0 a %d kHz, %lu us de CPU em I2C)\n", (unsigned long)acquisition_us,
+                     I2C0_BAUDRATE / 1000, (unsigned long)(acquisition_i2c_cpu_us + i2c_dma_cpu_us() - i2c_cpu));
+    return 1;
+}
+#endif
+
+//contagens dos drivers -> features do modelo (z-score, ou unidades físicas com MODEL_RAW_INPUT)
+static void counts_to_features(const sensor_counts_t* s, float sample[NUM_FEATURES]) {
+#ifdef FIXED_POINT_INPUT
+    //inteiro até o z-score; o tensor de entrada é float32, então sobra uma conversão exata por feature
+    int32_t z[NUM_FEATURES];
+    sensor_fixed_normalize(s, z);
+    for (int f = 0; f < NUM_FEATURES; f++)
+        sample[f] = (float)z[f] * (1.0f / (1 << SENSOR_FIXED_FRAC_BITS));
+#else
+    counts_to_physical(s, sample);
+#ifndef MODEL_RAW_INPUT
     for (int f = 0; f < NUM_FEATURES; f++)
-        normalize_feature(&sensor_window[window_pos][f], f);
-    window_pos = (window_pos + 1) % WINDOW_SIZE; //avança posição no buffer circular
-    if (window_pos == 0 && !window_full) {
-        window_full = true; //janela cheia: predição liberada
-        printf("Janela temporal completa! Iniciando predições...\n");
+        normalize_feature(&sample[f], f); //com MODEL_RAW_INPUT o modelo recebe as unidades físicas
+#endif
+#endif
+}
+
+//insere uma amostra convertida na janela cronológica (e nas colunas do motor incremental)
+static void push_window_sample(const float sample[NUM_FEATURES]) {
+    sensor_window_push(&sensor_window, sample); //grava direto no buffer lido pelo modelo
+    tflm_bind_input(sensor_window_view(&sensor_window)); //início da janela avança a cada amostra
+#ifdef TFLM_STREAMING
+    tflm_stream_push(sample); //calcula só a coluna nova de cada Conv1D
+#endif
+}
+
+#ifdef WINDOW_CHECKPOINT
+//primeira amostra após o boot: reinsere as amostras gravadas antes do reset, se ainda valem
+static void restore_window_checkpoint(const sensor_counts_t* first, uint64_t t_ms) {
+    static const char* const reasons[] = {
+        "log vazio", "restaurada", "primeira amostra chegou tarde demais",
+        "primeira amostra não continua a última salva", "boot a frio",
+    };
+    sensor_counts_t saved[WINDOW_SIZE - 1];
+    int n = window_checkpoint_restore(first, t_ms, saved);
+    for (int i = 0; i < n; i++) {
+        float sample[NUM_FEATURES];
+        counts_to_features(&saved[i], sample);
+        push_window_sample(sample);
+    }
+    const window_checkpoint_info_t* info = window_checkpoint_info();
+    if (n > 0 && info->age_ms >= 0)
+        printf("Checkpoint: %d amostras restauradas (reset a quente, última há %lld ms)\n", n,
+               (long long)info->age_ms);
+    else if (n > 0)
+        printf("Checkpoint: %d amostras restauradas (boot a frio, leitura contínua com a última salva)\n", n);
+    else if (info->saved)
+        printf("Checkpoint: janela descartada (%s)\n", reasons[window_checkpoint_result()]);
+}
+#endif
+
+//converte e normaliza uma amostra e insere na janela cronológica; seq é o prazo da amostra na grade
+//do agendador (falhas de leitura e prazos perdidos ficam como buracos)
+void ingest_sensor_sample(const sensor_counts_t* s, uint32_t seq) {
+    float sample[NUM_FEATURES];
+    uint32_t start = cycle_counter_read();
+    counts_to_features(s, sample);
+    uint32_t cycles = cycle_counter_elapsed(start, cycle_counter_read());
+    telemetry_sample_t record = {0, (uint32_t)(time_us_64() / 1000), *s, acquisition_us, cycles,
+                                 sample_scheduler_stats()->lateness_us};
+    telemetry_sample(&record); //no modo binário, as contagens vão cruas e as linhas abaixo são puladas
+    if (telemetry_text()) {
+#ifdef FIXED_POINT_INPUT
+        int32_t centi[NUM_FEATURES];
+        char text[NUM_FEATURES][16];
+        sensor_fixed_centi(s, centi);
+        for (int f = 0; f < NUM_FEATURES; f++) //x100 -> "23.45" sem printf de ponto flutuante
+            snprintf(text[f], sizeof(text[f]), "%s%ld.%02ld", centi[f] < 0 ? "-" : "",
+                     labs((long)centi[f]) / 100, labs((long)centi[f]) % 100);
+        telemetry_printf("Sensores: AHT20=%s°C %s%% | BMP280=%s°C %shPa\n", text[0], text[1], text[2], text[3]);
+        telemetry_printf("Normalização (inteira): %lu ciclos\n", (unsigned long)cycles);
+#else
+        float raw[NUM_FEATURES];
+        counts_to_physical(s, raw); //de novo só para o log, fora do trecho medido
+        telemetry_printf("Sensores: AHT20=%.2f°C %.2f%% | BMP280=%.2f°C %.2fhPa\n", raw[0], raw[1], raw[2], raw[3]);
+        telemetry_printf("Normalização (float): %lu ciclos\n", (unsigned long)cycles);
+#endif
+    }
+    bool was_full = sensor_window_full(&sensor_window);
+#ifdef FLASH_LOG
+    log_record.counts = *s;
+    for (int i = 0; i < NUM_HORIZONS; i++)
+        log_record.pred_centi[i] = FLASH_LOG_NO_PREDICTION;
+    log_record.flags = 0;
+    log_record.invoke_us = 0;
+    log_t_ms = time_us_64() / 1000;
+#endif
+#ifdef WINDOW_CHECKPOINT
+    static bool first_sample = true;
+    uint64_t t_ms = window_checkpoint_clock_ms();
+    if (first_sample) {
+        restore_window_checkpoint(s, t_ms);
+        first_sample = false;
     }
+#endif
+    push_window_sample(sample);
+    window_seq = seq;
+#ifdef WINDOW_CHECKPOINT
+    if (window_checkpoint_append(s, t_ms) == 0)
+        telemetry_printf("Checkpoint: %lu us na flash (%lu registros, %lu setores apagados)\n",
+                         (unsigned long)window_checkpoint_info()->last_write_us,
+                         (unsigned long)window_checkpoint_info()->writes,
+                         (unsigned long)window_checkpoint_info()->erases);
+#endif
+    if (!was_full && sensor_window_full(&sensor_window))
+        telemetry_printf("Janela temporal completa! Iniciando predições...\n"); //janela cheia: predição liberada
+}
+
+//coleta uma amostra dos sensores, normaliza e insere na janela cronológica
+int collect_sensor_sample(void) {
+    sensor_counts_t s;
+    if (read_sensor_sample(&s) != 0) return -1;
+    ingest_sensor_sample(&s, sample_scheduler_stats()->seq);
     return 0;
 }
 
+#ifdef MULTICORE_PIPELINE
+//pipeline em dois núcleos: core0 só amostra os sensores (I2C0) em prazos absolutos e publica
+//na fila; core1 normaliza, executa a inferência e atualiza o display (I2C1). Uma inferência
+//ou um flush de display lento atrasa apenas o core1, nunca o instante da próxima amostra
+static sample_queue_t sample_queue;
+
+//imprime ocupação de um núcleo; cada núcleo só lê os próprios contadores
+static void print_core_usage(int core, uint64_t busy_us, uint64_t since_us) {
+    uint64_t total_us = time_us_64() - since_us;
+    telemetry_printf("[core%d] ocupado %llu ms / ocioso %llu ms (%.2f%%)\n", core,
+                     (unsigned long long)(busy_us / 1000), (unsigned long long)((total_us - busy_us) / 1000),
+                     total_us ? 100.0 * (double)busy_us / (double)total_us : 0.0);
+}
+
+static void core1_inference_loop(void) {
+    uint64_t since_us = time_us_64();
+    uint64_t busy_us = 0;
+    uint32_t samples = 0;
+    sensor_sample_t s;
+    while (1) {
+        if (!sample_queue_pop(&sample_queue, &s)) {
+            //dorme até o core0 publicar uma amostra (__sev) ou até IDLE_POLL_MS: os comandos do serial
+            //mexem no estado do core1 (telemetria, modelo ativo, perfil, log) e são atendidos aqui
+            best_effort_wfe_or_timeout(make_timeout_time_ms(IDLE_POLL_MS));
+            poll_serial_commands();
+            continue;
+        }
+        uint64_t start = time_us_64();
+        ingest_sensor_sample(&s.counts, s.seq);
+        bool predicted = sensor_window_full(&sensor_window);
+        if (predicted) {
+            run_temperature_prediction();
+            cycle_timing.latency_us = (uint32_t)(time_us_64() - s.timestamp_us);
+            telemetry_printf("Latência amostra->display: %lu us (fila: %lu, descartadas: %lu)\n",
+                             (unsigned long)cycle_timing.latency_us,
+                             (unsigned long)sample_queue_size(&sample_queue), (unsigned long)sample_queue.dropped);
+        } else {
+            telemetry_printf("Amostras coletadas: %d/10\n", sensor_window.count);
+        }
+        end_sample_cycle(predicted);
+        busy_us += time_us_64() - start;
+        if (++samples % WINDOW_SIZE == 0)
+            print_core_usage(1, busy_us, since_us);
+    }
+}
+
+static void core0_acquisition_loop(void) {
+    uint64_t since_us = time_us_64();
+    uint64_t busy_us = 0;
+    uint32_t samples = 0;
+#if defined(WINDOW_CHECKPOINT) || defined(FLASH_LOG)
+    flash_safe_execute_core_init(); //core1 grava na flash: core0 precisa aceitar a pausa fora da flash
+#endif
+    sample_scheduler_init(SAMPLE_INTERVAL_MS, first_sample_delay_ms);
+    while (1) {
+        if (!sample_scheduler_wait(SAMPLE_INTERVAL_MS)) //alarme no prazo absoluto t0 + k * SAMPLE_INTERVAL_MS
+            continue;
+        sensor_sample_t s;
+        s.timestamp_us = time_us_64();
+        s.seq = sample_scheduler_stats()->seq;
+        if (read_sensor_sample(&s.counts) == 0) {
+            if (!sample_queue_push(&sample_queue, &s)) {
+                telemetry_printf("AVISO: fila cheia, amostra descartada\n");
+                telemetry_error(TELEMETRY_ERR_QUEUE_FULL, (int32_t)sample_queue.dropped);
+            }
+            __sev(); //acorda o core1
+        }
+        busy_us += time_us_64() - s.timestamp_us;
+#ifdef WINDOW_CHECKPOINT
+        window_checkpoint_heartbeat();
+#endif
+        if (++samples % WINDOW_SIZE == 0) {
+            print_core_usage(0, busy_us, since_us);
+            print_schedule_stats();
+        }
+    }
+}
+#endif
+
 int main() {
     stdio_init_all();
+    telemetry_init(TELEMETRY_DEFAULT_MODE); //boot sempre em texto; o modo vale para o ciclo de amostragem
     sleep_ms(2000); //aguarda USB/serial estabilizar
     printf("Temperature Prediction - CNN 1D\n\n");
 
-    //I2C0: sensores (GP0=SDA, GP1=SCL) a 100kHz
-    i2c_init(i2c0, 100 * 1000);
+    //I2C0: sensores (GP0=SDA, GP1=SCL) a 100kHz, ou 400kHz com I2C0_FAST_MODE
+    i2c_init(i2c0, I2C0_BAUDRATE);
     gpio_set_function(0, GPIO_FUNC_I2C);
     gpio_set_function(1, GPIO_FUNC_I2C);
     gpio_pull_up(0);
     gpio_pull_up(1);
+    i2c_dma_init(i2c0); //fila de transações (DMA com I2C_DMA, bloqueante sem)
 
     //I2C1: display OLED (GP14=SDA, GP15=SCL) a 400kHz
-    i2c_init(i2c1, 400 * 1000);
+    i2c_init(i2c1, I2C1_BAUDRATE);
     gpio_set_function(14, GPIO_FUNC_I2C);
     gpio_set_function(15, GPIO_FUNC_I2C);
     gpio_pull_up(14);
     gpio_pull_up(15);
+    i2c_dma_init(i2c1);
 
     printf("Inicializando sensores...\n");
     if (!aht20_init(i2c0))
@@ -136,6 +567,13 @@ int main() {
         printf("AHT20 OK\n");
     bmp280_init(i2c0);
     bmp280_get_calib_params(i2c0, &bmp_params); //lê calibração uma única vez
+    sensor_acquisition_init(&acquisition, i2c0, &bmp_params);
+    cycle_counter_init();
+#if defined(FIXED_POINT_INPUT) && defined(MODEL_RAW_INPUT)
+    sensor_fixed_init(raw_mean, raw_scale); //só a conversão de unidade: o z-score está no modelo
+#elif defined(FIXED_POINT_INPUT)
+    sensor_fixed_init(scaler_mean, scaler_scale); //única conta em ponto flutuante do caminho inteiro
+#endif
     printf("BMP280 OK\n");
 
     printf("Inicializando display...\n");
@@ -158,6 +596,8 @@ int main() {
             case 4: printf("Tensores nulos!\n"); break;
             case 5: printf("Tipo do input incorreto!\n"); break;
             case 6: printf("Tipo do output incorreto!\n"); break;
+            case 7: printf("Selecao de modelos invalida!\n"); break;
+            case 8: printf("Forma dos tensores incompativel!\n"); break;
             default: printf("Erro desconhecido!\n"); break;
         }
         ssd1306_fill(&display, false);
@@ -168,7 +608,43 @@ int main() {
         ssd1306_send_data(&display);
         while (1) tight_loop_contents();
     }
-    printf("TFLM OK - Arena: %d bytes\n\n", tflm_arena_used_bytes());
+    sensor_window_init(&sensor_window);
+#ifdef WINDOW_CHECKPOINT
+    window_checkpoint_init(SAMPLE_INTERVAL_MS);
+    first_sample_delay_ms = window_checkpoint_first_delay_ms();
+    printf("Checkpoint: %lu registros na flash, %u amostras contíguas, boot %s, primeira amostra em %lu ms\n",
+           (unsigned long)window_checkpoint_info()->records, window_checkpoint_info()->saved,
+           window_checkpoint_info()->warm ? "a quente" : "a frio", (unsigned long)first_sample_delay_ms);
+#endif
+#ifdef FLASH_LOG
+    flash_log_init();
+    printf("Log: %lu páginas na flash, boot %lu, próximo registro %lu ('l' envia o log)\n",
+           (unsigned long)flash_log_info()->pages, (unsigned long)flash_log_info()->boot,
+           (unsigned long)flash_log_info()->next_seq);
+#endif
+    for (int i = 0; i < tflm_model_count(); i++) {
+        const model_descriptor_t* d = tflm_model_info(i);
+        printf("Modelo %d: %s%s, %lu parâmetros, %lu MACs, %d ops (%s)%s", i, d->name, d->int8 ? " int8" : "",
+               (unsigned long)d->params, (unsigned long)d->macs, d->num_ops, d->ops,
+               d->dequantized ? ", pesos híbridos em float32" : "");
+        if (d->arena_bytes)
+            printf(", arena planejada %lu bytes", (unsigned long)d->arena_bytes);
+        printf("\n");
+    }
+#ifdef MODEL_CASCADE
+    if (model_cascade_init() != 0) {
+        printf("ERRO: cascata requer 2 modelos no registro\n");
+        while (1) tight_loop_contents();
+    }
+    printf("Cascata: %s, e %s quando a variação da janela passar de %.2f °C ou o resíduo +5 min de %.2f °C\n",
+           tflm_model_info(model_cascade_cheap())->name, tflm_model_info(model_cascade_full())->name,
+           (double)CASCADE_SLOPE_C, (double)CASCADE_RESIDUAL_C);
+#else
+    if (tflm_model_count() > 1)
+        printf("'m' no serial troca o modelo ativo\n");
+#endif
+    printf("TFLM OK - Modelo %s %s, Arena: %d bytes\n\n", tflm_model_info(tflm_active_model())->name,
+           tflm_model_is_int8() ? "int8" : "float32", tflm_arena_used_bytes());
 
     ssd1306_fill(&display, false);
     ssd1306_draw_string(&display, "PRONTO!", 0, 0, false);
@@ -179,19 +655,102 @@ int main() {
 
     printf("Coletando a cada %d s, aguardando 10 amostras...\n\n", SAMPLE_INTERVAL_MS/1000);
 
-    absolute_time_t last_sample_time = get_absolute_time();
+#ifdef MULTICORE_PIPELINE
+    sample_queue_init(&sample_queue);
+    multicore_launch_core1(core1_inference_loop); //core1: inferência + display
+    core0_acquisition_loop();                     //core0: aquisição dos sensores
+#else
+#ifdef LOW_POWER
+    power_register_i2c(i2c0, I2C0_BAUDRATE);
+    power_register_i2c(i2c1, I2C1_BAUDRATE);
+    power_init(); //daqui em diante o clk_sys só sobe para o invoke e a saída
+#endif
+    //prazos absolutos num alarme do timer: o tempo do ciclo não se soma ao intervalo
+    sample_scheduler_init(SAMPLE_INTERVAL_MS, first_sample_delay_ms);
+#ifdef SEQUENTIAL_ACQUISITION
     while (1) {
-        int64_t elapsed_ms = absolute_time_diff_us(last_sample_time, get_absolute_time()) / 1000;
-        if (elapsed_ms >= SAMPLE_INTERVAL_MS) {
+        if (sample_scheduler_wait(IDLE_POLL_MS)) { //WFE até o alarme da amostra ou IDLE_POLL_MS
+#ifdef LOW_POWER
+            power_phase(POWER_PHASE_ACQUIRE);
+#endif
             if (collect_sensor_sample() == 0) {
-                if (window_full)
+                bool predicted = sensor_window_full(&sensor_window);
+                if (predicted)
                     run_temperature_prediction();
                 else
-                    printf("Amostras coletadas: %d/10\n", window_pos);
+                    telemetry_printf("Amostras coletadas: %d/10\n", sensor_window.count);
+                end_sample_cycle(predicted);
             }
-            last_sample_time = get_absolute_time();
+#ifdef LOW_POWER
+            power_phase(POWER_PHASE_SLEEP); //espera o I2C ficar ocioso e baixa o clk_sys
+#endif
+            if (sample_scheduler_stats()->samples % WINDOW_SIZE == 0) {
+                print_schedule_stats();
+#ifdef LOW_POWER
+                print_power_stats();
+#endif
+            }
+        }
+#ifdef WINDOW_CHECKPOINT
+        window_checkpoint_heartbeat(); //relógio nos scratch do watchdog para o próximo reset
+#endif
+        poll_serial_commands();
+    }
+#else
+    //ciclo sobreposto: no alarme da amostra k o AHT20 começa a converter (~80 ms) e o BMP280 é lido
+    //durante a conversão; o laço volta ao WFE (serial atendido) e coleta o AHT20 quando acorda no
+    //prazo da conversão. A predição da janela que a amostra k fechou roda logo depois da coleta, então
+    //a previsão sai no mesmo ciclo da última amostra da janela; com I2C_DMA o flush do display segue
+    //no I2C1 enquanto o laço volta a dormir
+    bool converting = false; //amostra atual aguardando a coleta do AHT20
+    while (1) {
+        bool cycle_done = false;
+        if (converting) {
+            //WFE até o prazo da conversão; sem sleep dentro da aquisição, o serial segue atendido
+            best_effort_wfe_or_timeout(sensor_acquisition_next_poll(&acquisition));
+            sensor_counts_t counts;
+            int rc = poll_sensor_sample(&counts);
+            if (rc != 0) {
+#ifdef LOW_POWER
+                power_phase(POWER_PHASE_ACQUIRE);
+#endif
+                converting = false;
+                cycle_done = true;
+                if (rc > 0) {
+                    ingest_sensor_sample(&counts, sample_scheduler_stats()->seq); //o próximo prazo ainda não começou
+                    bool predicted = sensor_window_full(&sensor_window);
+                    if (predicted)
+                        run_temperature_prediction();
+                    else
+                        telemetry_printf("Amostras coletadas: %d/10\n", sensor_window.count);
+                    end_sample_cycle(predicted);
+                }
+#ifdef LOW_POWER
+                power_phase(POWER_PHASE_SLEEP); //espera o I2C ficar ocioso e baixa o clk_sys
+#endif
+            }
+        } else if (sample_scheduler_wait(IDLE_POLL_MS)) { //WFE até o alarme da amostra ou IDLE_POLL_MS
+#ifdef LOW_POWER
+            power_phase(POWER_PHASE_ACQUIRE);
+#endif
+            converting = start_sensor_sample() == 0;
+            cycle_done = !converting;
+#ifdef LOW_POWER
+            power_phase(POWER_PHASE_SLEEP); //a conversão termina em WFE, no clock baixo
+#endif
+        }
+        if (cycle_done && sample_scheduler_stats()->samples % WINDOW_SIZE == 0) {
+            print_schedule_stats();
+#ifdef LOW_POWER
+            print_power_stats();
+#endif
         }
-        sleep_ms(100); //evita busy-wait
+#ifdef WINDOW_CHECKPOINT
+        window_checkpoint_heartbeat(); //relógio nos scratch do watchdog para o próximo reset
+#endif
+        poll_serial_commands();
     }
+#endif
+#endif
     return 0;
 }
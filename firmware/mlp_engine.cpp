@@ -0,0 +1,45 @@
+#include "codegen_engine.h"
+#include "mlp_engine_params.h" //pesos e formas gerados por tools/gen_mlp_engine.py
+
+//motor MLP especializado (codegen_engine.h): Flatten é só a janela cronológica lida como [40],
+//seguido das três camadas densas com formas constexpr
+using namespace mlp_engine;
+
+static float hidden1_buf[kHidden1]; //dense_1 [32]
+static float hidden2_buf[kHidden2]; //dense_2 [16]
+
+static void invoke(const float* window, float* out) {
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        //zero-copy: [kWindow][kFeatures] row-major é o Flatten [kInputs]
+        dense<kInputs, kHidden1, true>(*reinterpret_cast<const float (*)[kInputs]>(window),
+                                       dense1_weights, dense1_bias, hidden1_buf);
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        dense<kHidden1, kHidden2, true>(hidden1_buf, dense2_weights, dense2_bias, hidden2_buf);
+        PROFILE_END();
+    }
+    {
+        PROFILE_BEGIN("FULLY_CONNECTED");
+        dense<kHidden2, kHorizons, false>(hidden2_buf, output_weights, output_bias,
+                                          *reinterpret_cast<float (*)[kHorizons]>(out));
+        PROFILE_END();
+    }
+}
+
+//sem modo incremental: cada invoke refaz as três camadas sobre a janela inteira
+namespace mlp_engine {
+extern const codegen_engine_t engine;
+const codegen_engine_t engine = {
+    invoke,
+    kMacsPerInvoke,
+    (int)(sizeof(hidden1_buf) + sizeof(hidden2_buf)),
+#ifdef TFLM_STREAMING
+    nullptr,
+    nullptr,
+    0,
+#endif
+};
+} // namespace mlp_engine
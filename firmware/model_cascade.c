@@ -0,0 +1,109 @@
+#include "model_cascade.h"
+#include "tflm_wrapper.h"
+#include "cycle_counter.h"
+#include <math.h>
+#include <string.h>
+
+static int cheap = -1, full = -1;
+static cascade_stats_t stats;
+//previsões +5 min do modelo barato dos últimos CASCADE_RESIDUAL_LAG prazos, em °C, na posição
+//seq % CASCADE_RESIDUAL_LAG: o prazo seq - CASCADE_RESIDUAL_LAG ocupa a mesma posição que o seq
+typedef struct {
+    uint32_t seq; //prazo da amostra mais nova da janela da previsão
+    float temp_c; //NAN: sem previsão
+} cascade_forecast_t;
+static cascade_forecast_t cheap_forecasts[CASCADE_RESIDUAL_LAG];
+
+int model_cascade_init(void) {
+    if (tflm_model_count() < 2) return 1;
+    cheap = full = 0;
+    for (int i = 1; i < tflm_model_count(); i++) {
+        if (tflm_model_info(i)->macs < tflm_model_info(cheap)->macs) cheap = i;
+        if (tflm_model_info(i)->macs > tflm_model_info(full)->macs) full = i;
+    }
+    if (cheap == full) full = (cheap + 1) % tflm_model_count(); //mesmos MACs: qualquer outro
+    for (int i = 0; i < CASCADE_RESIDUAL_LAG; i++)
+        cheap_forecasts[i].temp_c = NAN;
+    model_cascade_stats_reset();
+    return 0;
+}
+
+int model_cascade_cheap(void) {
+    return cheap;
+}
+
+int model_cascade_full(void) {
+    return full;
+}
+
+const cascade_stats_t* model_cascade_stats(void) {
+    return &stats;
+}
+
+void model_cascade_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    stats.last_slope = stats.last_residual = NAN;
+}
+
+//invoke do modelo atual pelo mesmo caminho do firmware (incremental, se houver)
+static int invoke_model(int idx) {
+    tflm_select_model(idx);
+#ifdef TFLM_STREAMING
+    int rc = tflm_stream_invoke();
+    stats.macs += (uint64_t)tflm_macs_per_invoke();
+#else
+    int rc = tflm_invoke();
+    stats.macs += tflm_model_info(idx)->macs;
+#endif
+    return rc;
+}
+
+int model_cascade_invoke(const float* window, uint32_t seq) {
+    if (cheap < 0) return 1;
+    uint32_t start = cycle_counter_read();
+    const model_descriptor_t* d = tflm_model_info(cheap);
+    int n = d->window, nf = d->features;
+    //Temp_AHT20 (feature 0) de volta a °C: o scaler é o mesmo para todos os modelos do registro
+    float mean = d->raw_input ? 0.0f : d->scaler_mean[0];
+    float scale = d->raw_input ? 1.0f : d->scaler_scale[0];
+
+    //inclinação por mínimos quadrados (menos sensível ao ruído que última - primeira) vezes o vão da janela
+    float center = 0.5f * (float)(n - 1), num = 0.0f, den = 0.0f;
+    for (int i = 0; i < n; i++) {
+        float x = (float)i - center;
+        num += x * window[i * nf];
+        den += x * x;
+    }
+    float slope = num / den * scale * (float)(n - 1);
+    //a leitura atual é o alvo da previsão +5 min da janela que terminou CASCADE_RESIDUAL_LAG prazos atrás
+    float current = window[(n - 1) * nf] * scale + mean;
+    cascade_forecast_t* slot = &cheap_forecasts[seq % CASCADE_RESIDUAL_LAG];
+    bool realized = seq >= CASCADE_RESIDUAL_LAG && slot->seq == seq - CASCADE_RESIDUAL_LAG;
+    float residual = realized ? slot->temp_c - current : NAN; //NAN: previsão daquele prazo não existe
+
+    int rc = invoke_model(cheap);
+    float* out = tflm_output_ptr(NULL);
+    slot->seq = seq;
+    slot->temp_c = rc == 0 ? out[0] : NAN;
+    if (rc != 0) return rc;
+
+    bool by_slope = fabsf(slope) > CASCADE_SLOPE_C;
+    bool by_residual = fabsf(residual) > CASCADE_RESIDUAL_C; //falso com NAN
+    bool escalate = by_slope || by_residual;
+    if (escalate) {
+        rc = invoke_model(full);
+        if (rc != 0) {
+            tflm_select_model(cheap); //a saída do barato se perdeu no buffer compartilhado
+            return rc;
+        }
+    }
+    stats.cycles += cycle_counter_elapsed(start, cycle_counter_read());
+    stats.predictions++;
+    stats.escalations += escalate;
+    stats.by_slope += by_slope;
+    stats.by_residual += by_residual;
+    stats.last_slope = slope;
+    stats.last_residual = residual;
+    stats.last_escalated = escalate;
+    return 0;
+}
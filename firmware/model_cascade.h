@@ -0,0 +1,53 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//cascata com saída antecipada (-DMODEL_CASCADE=ON, registro com 2+ modelos): a cada predição roda o
+//modelo barato do registro (menos MACs) e só chama o completo (mais MACs) quando um dos sinais de
+//volatilidade passa do limiar. Os dois sinais saem do que o firmware já tem, sem invoke extra:
+// - variação da janela: inclinação (mínimos quadrados) da Temp_AHT20 nas 10 amostras, em °C por janela
+// - resíduo realizado: erro da previsão +5 min do modelo barato feita na janela que terminou
+//   CASCADE_RESIDUAL_LAG prazos atrás contra a leitura atual (o alvo dela, como em create_sequences).
+//   As previsões guardam o prazo da amostra (seq); sem a previsão daquele prazo (falha de leitura,
+//   prazo perdido, janela ainda enchendo) o resíduo fica NAN e não escala
+//Tempo estável: saída do barato; rampas ou barato errando: saída do completo
+
+//limiares do replay (MLP;Conv1D): ~30% das predições escaladas, metade dos MACs do Conv1D sozinho
+#ifndef CASCADE_SLOPE_C
+#define CASCADE_SLOPE_C    0.12f //|variação| da temperatura na janela que escala para o modelo completo
+#endif
+#ifndef CASCADE_RESIDUAL_C
+#define CASCADE_RESIDUAL_C 0.50f //|erro| realizado do +5 min do modelo barato que escala
+#endif
+#define CASCADE_RESIDUAL_LAG 11  //+5 min: alvo 1 + 10 amostras após o fim da janela
+
+typedef struct {
+    uint32_t predictions;  //invokes da cascata com sucesso
+    uint32_t escalations;  //predições entregues pelo modelo completo
+    uint32_t by_slope;     //escaladas pela variação da janela
+    uint32_t by_residual;  //escaladas pelo resíduo (as duas condições contam nas duas)
+    uint64_t cycles;       //ciclos somados (invokes + sinais; ns no host)
+    uint64_t macs;         //MACs somados dos invokes
+    float last_slope;      //sinais da última predição em °C (resíduo NAN até a 1a previsão realizar)
+    float last_residual;
+    bool last_escalated;
+} cascade_stats_t;
+
+//escolhe o barato e o completo pelos MACs do registro; 0 OK, 1 registro com menos de 2 modelos
+int model_cascade_init(void);
+//executa a cascata sobre a janela cronológica normalizada (a mesma vinculada com tflm_bind_input)
+//cuja amostra mais nova é do prazo seq da grade do agendador; a saída fica em tflm_output_ptr() e o
+//modelo que a produziu em tflm_active_model(). Retorna o rc do invoke que falhou, ou 0
+int model_cascade_invoke(const float* window, uint32_t seq);
+int model_cascade_cheap(void); //índices no registro
+int model_cascade_full(void);
+const cascade_stats_t* model_cascade_stats(void);
+void model_cascade_stats_reset(void);
+
+#ifdef __cplusplus
+}
+#endif
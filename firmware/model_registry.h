@@ -0,0 +1,38 @@
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//registro de modelos embarcados: o build (-DMODEL_REGISTRY="Conv1D;MLP") gera model_registry_data.h
+//com tools/gen_model_registry.py, um flatbuffer por modelo com prefixo próprio (model_conv1d_tflite,
+//model_mlp_tflite) e esta tabela de descritores. Vazio, o registro tem só o modelo da variante do build
+//(TFLM_MODEL_VARIANT, MODEL_RAW_INPUT ou CONV1D_ENGINE_MODEL), pelo mesmo caminho de código.
+//Todos os modelos leem a mesma janela normalizada [window][features] e entregam [horizons] em °C
+
+#define MODEL_REGISTRY_MAX 4 //interpretadores/motores reservados no tflm_wrapper
+
+typedef struct {
+    const char* name;            //nome no MODEL_REGISTRY (models/<nome>/)
+    const unsigned char* tflite; //flatbuffer na flash (NULL no motor CODEGEN, que embarca só os pesos)
+    uint32_t tflite_len;
+    uint8_t window;              //timesteps da janela de entrada
+    uint8_t features;
+    uint8_t horizons;            //previsões na saída (5, 10, 15 min)
+    uint8_t int8;                //entrada/saída int8 (quantização nas bordas do invoke)
+    uint8_t raw_input;           //scaler dobrado nos pesos (MODEL_RAW_INPUT): janela em unidades físicas
+    uint8_t dequantized;         //pesos híbridos int8 convertidos para float32 pelo gerador
+    uint8_t num_ops;             //operadores do grafo
+    const char* ops;             //operadores distintos, separados por espaço, na ordem do primeiro uso
+    uint32_t params;             //pesos + bias
+    uint32_t macs;               //MACs por invoke
+    uint32_t activation_bytes;   //soma dos tensores não constantes: teto da arena, sem reuso entre tensores
+    uint32_t arena_bytes;        //arena do TFLM só com este modelo (tools/plan_arena.py, sem margem; 0 no CODEGEN)
+    const float* scaler_mean;    //scaler exportado com o modelo (conferido com scaler_params.h no build)
+    const float* scaler_scale;
+} model_descriptor_t;
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,97 @@
+#include "op_profiler.h"
+#include <stdio.h>
+#include <stdbool.h>
+#include <string.h>
+#include "pico/time.h"
+#include "cycle_counter.h" //SysTick no RP2040, nanossegundos no host
+
+#define HANDLE_NONE 0xFFFFFFFFu
+
+typedef struct {
+    const char* tag;
+    uint32_t count;
+    uint32_t min_cycles, max_cycles;
+    uint64_t sum_cycles;
+    uint32_t min_us, max_us;
+    uint64_t sum_us;
+    uint32_t hist[OP_PROFILER_HIST_BUCKETS];
+} op_stats_t;
+
+static op_stats_t stats[OP_PROFILER_MAX_OPS];
+static uint32_t start_cycles[OP_PROFILER_MAX_OPS];
+static uint32_t start_us[OP_PROFILER_MAX_OPS];
+static uint32_t next_op = 0;      //índice do próximo op dentro do invoke atual
+static bool     in_invoke = false;
+static uint32_t invokes = 0;
+
+void op_profiler_reset(void) {
+    memset(stats, 0, sizeof(stats));
+    for (int i = 0; i < OP_PROFILER_MAX_OPS; i++) {
+        stats[i].min_cycles = UINT32_MAX;
+        stats[i].min_us = UINT32_MAX;
+    }
+    invokes = 0;
+}
+
+void op_profiler_init(void) {
+    cycle_counter_init();
+    op_profiler_reset();
+}
+
+void op_profiler_begin_invoke(void) {
+    next_op = 0;
+    in_invoke = true;
+}
+
+void op_profiler_end_invoke(void) {
+    in_invoke = false;
+    invokes++;
+}
+
+uint32_t op_profiler_begin(const char* tag) {
+    if (!in_invoke || next_op >= OP_PROFILER_MAX_OPS) return HANDLE_NONE; //fora de um invoke (ex.: Prepare)
+    uint32_t h = next_op++;
+    stats[h].tag = tag;
+    start_us[h] = time_us_32();
+    start_cycles[h] = cycle_counter_read();
+    return h;
+}
+
+void op_profiler_end(uint32_t handle) {
+    uint32_t end_cycles = cycle_counter_read();
+    uint32_t end_us = time_us_32();
+    if (handle == HANDLE_NONE) return;
+    op_stats_t* s = &stats[handle];
+    uint32_t cyc = cycle_counter_elapsed(start_cycles[handle], end_cycles);
+    uint32_t us = end_us - start_us[handle];
+    s->count++;
+    s->sum_cycles += cyc;
+    s->sum_us += us;
+    if (cyc < s->min_cycles) s->min_cycles = cyc;
+    if (cyc > s->max_cycles) s->max_cycles = cyc;
+    if (us < s->min_us) s->min_us = us;
+    if (us > s->max_us) s->max_us = us;
+    int b = 0;
+    while ((us >> (b + 1)) != 0 && b < OP_PROFILER_HIST_BUCKETS - 1) b++;
+    s->hist[b]++;
+}
+
+uint32_t op_profiler_invokes(void) {
+    return invokes;
+}
+
+void op_profiler_dump(void) {
+    printf("PROF,invokes,%lu\n", (unsigned long)invokes);
+    printf("PROF,op,tag,n,cyc_min,cyc_mean,cyc_max,us_min,us_mean,us_max,hist_log2_us\n");
+    for (int i = 0; i < OP_PROFILER_MAX_OPS; i++) {
+        const op_stats_t* s = &stats[i];
+        if (s->count == 0) continue;
+        printf("PROF,%d,%s,%lu,%lu,%lu,%lu,%lu,%lu,%lu,", i, s->tag ? s->tag : "?",
+               (unsigned long)s->count,
+               (unsigned long)s->min_cycles, (unsigned long)(s->sum_cycles / s->count), (unsigned long)s->max_cycles,
+               (unsigned long)s->min_us, (unsigned long)(s->sum_us / s->count), (unsigned long)s->max_us);
+        for (int b = 0; b < OP_PROFILER_HIST_BUCKETS; b++)
+            printf(b ? ":%lu" : "%lu", (unsigned long)s->hist[b]);
+        printf("\n");
+    }
+}
@@ -0,0 +1,26 @@
+#pragma once
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//profiler por operador: cada evento entre begin_invoke/end_invoke recebe o índice do op na
+//ordem de execução e acumula ciclos e tempo de parede (min/média/máx + histograma log2 em µs).
+//O TFLM alimenta via MicroProfilerInterface (tflm_wrapper.cpp) e o motor gerado chama
+//diretamente por camada, então os dumps de device e host têm o mesmo formato e podem ser comparados
+#define OP_PROFILER_MAX_OPS     16
+#define OP_PROFILER_HIST_BUCKETS 12 //bucket b: [2^b, 2^(b+1)) µs; o último acumula o resto
+
+void     op_profiler_init(void);           //configura o contador de ciclos e zera as estatísticas
+void     op_profiler_reset(void);          //zera as estatísticas
+void     op_profiler_begin_invoke(void);
+void     op_profiler_end_invoke(void);
+uint32_t op_profiler_begin(const char* tag); //retorna handle para op_profiler_end()
+void     op_profiler_end(uint32_t handle);
+void     op_profiler_dump(void);           //imprime CSV por op no stdio (USB/UART)
+uint32_t op_profiler_invokes(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,130 @@
+#include "power_manager.h"
+#include "i2c_dma.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/sync.h"
+#include "pico/stdlib.h"
+#if LIB_PICO_STDIO_UART
+#include "hardware/uart.h"
+#endif
+#include <string.h>
+
+#define MAX_BUSES 2
+
+typedef struct {
+    i2c_inst_t* i2c;
+    uint32_t baudrate;
+} power_bus_t;
+
+static power_bus_t buses[MAX_BUSES];
+static int num_buses = 0;
+static power_phase_t phase = POWER_PHASE_OUTPUT; //boot: mensagens no clock padrão do SDK
+static uint32_t current_khz;
+static uint64_t phase_start_us;
+static power_stats_t stats;
+
+static const char* const phase_names[POWER_PHASE_COUNT] = {"sono", "aquisição", "inferência", "saída"};
+
+//clk_sys baixo: com stdio USB, 48 MHz do pll_usb (mesmo PLL do clk_usb, o controlador não perde o
+//barramento); sem USB, o clk_ref direto (XOSC, 12 MHz)
+static uint32_t low_khz(void) {
+#if LIB_PICO_STDIO_USB
+    return 48000;
+#else
+    return clock_get_hz(clk_ref) / 1000;
+#endif
+}
+
+static uint32_t phase_khz(power_phase_t p) {
+    return p == POWER_PHASE_INFER || p == POWER_PHASE_OUTPUT ? POWER_BOOST_KHZ : low_khz();
+}
+
+//clk_sys trocado direto pelo clock_configure: os set_sys_clock_* do SDK 2.1.0 devolvem o clk_peri ao
+//clk_sys (set_sys_clock_48mhz) e o deixam lá (set_sys_clock_khz), e a UART do stdio, com o divisor
+//calculado para os 48 MHz do pll_usb, sairia no baudrate errado na inferência e na saída
+static uint boost_vco, boost_pd1, boost_pd2;
+
+static void set_clock(uint32_t khz) {
+    for (int i = 0; i < num_buses; i++)
+        while (!i2c_dma_idle(buses[i].i2c)) //frame do display ainda no DMA: o divisor não pode mudar no meio
+            __wfe();
+    if (khz == POWER_BOOST_KHZ) {
+        //vindo do clock baixo, o pll_sys está desligado e o clk_sys fora dele: religa, espera o lock e troca
+        pll_init(pll_sys, PLL_COMMON_REFDIV, boost_vco, boost_pd1, boost_pd2);
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                        CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, khz * KHZ, khz * KHZ);
+    } else {
+#if LIB_PICO_STDIO_USB
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                        CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+#else
+        uint32_t ref = clock_get_hz(clk_ref);
+        clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF, 0, ref, ref);
+#endif
+        pll_deinit(pll_sys);
+    }
+    for (int i = 0; i < num_buses; i++)
+        i2c_set_baudrate(buses[i].i2c, buses[i].baudrate); //SCL em contagens do clk_sys
+    current_khz = khz;
+}
+
+void power_register_i2c(i2c_inst_t* i2c, uint32_t baudrate) {
+    if (num_buses < MAX_BUSES)
+        buses[num_buses++] = (power_bus_t){i2c, baudrate};
+}
+
+void power_init(void) {
+#if LIB_PICO_STDIO_UART
+    stdio_flush(); //a UART esvazia no baudrate antigo antes de o clk_peri mudar
+#endif
+    if (!check_sys_clock_khz(POWER_BOOST_KHZ, &boost_vco, &boost_pd1, &boost_pd2))
+        panic("POWER_BOOST_KHZ %u inatingivel pelo pll_sys", POWER_BOOST_KHZ);
+    //clk_peri no pll_usb, que nunca desliga: set_clock só mexe no clk_sys, então a UART não muda mais
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+#if LIB_PICO_STDIO_UART
+    uart_set_baudrate(uart_default, PICO_DEFAULT_UART_BAUD_RATE);
+#endif
+    current_khz = clock_get_hz(clk_sys) / 1000;
+    phase_start_us = time_us_64();
+    power_phase(POWER_PHASE_SLEEP);
+    power_stats_reset();
+}
+
+void power_phase(power_phase_t next) {
+    uint64_t now = time_us_64();
+    stats.us[phase] += now - phase_start_us;
+    phase = next;
+    phase_start_us = now;
+    if (next == POWER_PHASE_INFER) stats.predictions++;
+    uint32_t khz = phase_khz(next);
+    if (khz != current_khz) {
+        set_clock(khz);
+        stats.transitions++;
+        stats.transition_us += time_us_64() - now;
+    }
+}
+
+const power_stats_t* power_stats(void) {
+    return &stats;
+}
+
+void power_stats_reset(void) {
+    memset(&stats, 0, sizeof(stats));
+    for (int p = 0; p < POWER_PHASE_COUNT; p++)
+        stats.khz[p] = phase_khz((power_phase_t)p);
+    phase_start_us = time_us_64();
+}
+
+uint64_t power_charge_uc(const power_stats_t* st) {
+    uint64_t ua_us = 0;
+    for (int p = 0; p < POWER_PHASE_COUNT; p++) {
+        uint32_t per_mhz = p == POWER_PHASE_SLEEP ? POWER_SLEEP_UA_PER_MHZ : POWER_UA_PER_MHZ;
+        uint64_t ua = POWER_BASE_UA + (uint64_t)per_mhz * st->khz[p] / 1000;
+        ua_us += ua * st->us[p];
+    }
+    return ua_us / 1000000;
+}
+
+const char* power_phase_name(power_phase_t p) {
+    return p < POWER_PHASE_COUNT ? phase_names[p] : "?";
+}
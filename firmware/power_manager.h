@@ -0,0 +1,72 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/i2c.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//modo de energia do ciclo de amostragem (-DLOW_POWER=ON): entre amostras e na aquisição o clk_sys
+//fica baixo com o pll_sys desligado; só a inferência e a saída sobem para POWER_BOOST_KHZ. A espera
+//continua no WFE do sample_scheduler, acordada pelo alarme do timer (o timer conta no clk_ref, que
+//não muda). Cada troca espera os barramentos I2C registrados ficarem ociosos, troca só o clk_sys
+//pelo clock_configure e refaz o baudrate dos barramentos (o divisor do I2C sai do clk_sys). Os
+//set_sys_clock_* do SDK não são usados: no SDK 2.1.0 eles deixam o clk_peri no clk_sys, e a UART
+//mudaria de baudrate a cada troca. clk_peri (UART) e clk_usb ficam no pll_usb, que nunca desliga.
+//O tempo de cada fase é somado para uma estimativa de energia por predição
+//
+//Dormant não é usado: nele o XOSC para, junto com o timer do alarme e o USB, e acordar pelo RTC
+//exigiria um cristal de 32 kHz externo no GPIO de clock
+
+#ifndef POWER_BOOST_KHZ
+#define POWER_BOOST_KHZ    125000 //clk_sys do invoke e da saída (padrão do SDK; 133 MHz também roda a 1,10 V)
+#endif
+//modelo linear de corrente para a estimativa (I = base + k * MHz): ordem de grandeza de uma Pico
+//alimentada pelo VSYS; meça na placa com um amperímetro e passe os valores por -D
+#ifndef POWER_BASE_UA
+#define POWER_BASE_UA        4000 //reguladores, flash, PLLs e USB sem tráfego
+#endif
+#ifndef POWER_UA_PER_MHZ
+#define POWER_UA_PER_MHZ     150  //núcleo executando
+#endif
+#ifndef POWER_SLEEP_UA_PER_MHZ
+#define POWER_SLEEP_UA_PER_MHZ 40 //núcleo em WFE: barramento e periféricos seguem no clk_sys
+#endif
+#ifndef POWER_SUPPLY_MV
+#define POWER_SUPPLY_MV      3300
+#endif
+
+typedef enum {
+    POWER_PHASE_SLEEP = 0, //WFE entre amostras (inclui os comandos do serial a cada IDLE_POLL_MS)
+    POWER_PHASE_ACQUIRE,   //sensores, normalização e linhas de texto do ciclo sem predição
+    POWER_PHASE_INFER,     //invoke do modelo
+    POWER_PHASE_OUTPUT,    //serial, display, log
+    POWER_PHASE_COUNT,
+} power_phase_t;
+
+typedef struct {
+    uint64_t us[POWER_PHASE_COUNT];  //tempo em cada fase desde power_stats_reset
+    uint32_t khz[POWER_PHASE_COUNT]; //clk_sys da fase
+    uint32_t predictions;            //entradas em POWER_PHASE_INFER
+    uint32_t transitions;            //trocas de clk_sys
+    uint64_t transition_us;          //espera do I2C + PLL + baudrates (entra na fase de destino)
+} power_stats_t;
+
+//move clk_peri para o pll_usb (a UART fica independente do clk_sys), confere que o pll_sys alcança
+//POWER_BOOST_KHZ e entra em POWER_PHASE_SLEEP com o clock baixo; chamar antes do laço de
+//amostragem, depois de power_register_i2c
+void power_init(void);
+//barramento com o baudrate que deve ser refeito a cada troca de clk_sys (até 2)
+void power_register_i2c(i2c_inst_t* i2c, uint32_t baudrate);
+//fecha a fase atual e entra em outra, trocando o clk_sys se o da nova fase for diferente
+void power_phase(power_phase_t phase);
+const power_stats_t* power_stats(void);
+void power_stats_reset(void);
+//carga estimada pelo modelo linear, em uC (uA x s)
+uint64_t power_charge_uc(const power_stats_t* st);
+const char* power_phase_name(power_phase_t phase);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,55 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "hardware/sync.h"
+#include "sensor_acquisition.h" //sensor_counts_t
+
+//fila lock-free de produtor único / consumidor único entre os dois núcleos do RP2040.
+//core0 (aquisição) só escreve em head, core1 (inferência) só escreve em tail; as barreiras
+//garantem que o conteúdo do slot fique visível antes do índice que o publica
+#define SAMPLE_QUEUE_CAPACITY 8 //potência de 2
+
+typedef struct {
+    uint64_t timestamp_us;      //instante da leitura (time_us_64) no core0
+    uint32_t seq;               //prazo da amostra na grade do agendador (sample_scheduler_stats()->seq)
+    sensor_counts_t counts;     //leituras inteiras dos drivers, antes da conversão e normalização
+} sensor_sample_t;
+
+typedef struct {
+    sensor_sample_t slots[SAMPLE_QUEUE_CAPACITY];
+    volatile uint32_t head;    //próxima escrita (produtor)
+    volatile uint32_t tail;    //próxima leitura (consumidor)
+    volatile uint32_t dropped; //amostras descartadas com a fila cheia
+} sample_queue_t;
+
+static inline void sample_queue_init(sample_queue_t* q) {
+    q->head = q->tail = q->dropped = 0;
+}
+
+//produtor: retorna false (e conta o descarte) se o consumidor ficou SAMPLE_QUEUE_CAPACITY amostras atrás
+static inline bool sample_queue_push(sample_queue_t* q, const sensor_sample_t* s) {
+    uint32_t head = q->head;
+    if (head - q->tail == SAMPLE_QUEUE_CAPACITY) {
+        q->dropped++;
+        return false;
+    }
+    q->slots[head & (SAMPLE_QUEUE_CAPACITY - 1)] = *s;
+    __mem_fence_release(); //slot escrito antes de publicar head
+    q->head = head + 1;
+    return true;
+}
+
+//consumidor: retorna false se a fila está vazia
+static inline bool sample_queue_pop(sample_queue_t* q, sensor_sample_t* s) {
+    uint32_t tail = q->tail;
+    if (q->head == tail) return false;
+    __mem_fence_acquire(); //head lido antes do conteúdo do slot
+    *s = q->slots[tail & (SAMPLE_QUEUE_CAPACITY - 1)];
+    __mem_fence_release(); //slot copiado antes de liberá-lo para o produtor
+    q->tail = tail + 1;
+    return true;
+}
+
+static inline uint32_t sample_queue_size(const sample_queue_t* q) {
+    return q->head - q->tail;
+}
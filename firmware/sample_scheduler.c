@@ -0,0 +1,93 @@
+#include "sample_scheduler.h"
+#include "hardware/timer.h"
+#include "pico/time.h"
+#include <string.h>
+
+static int alarm_num = -1;
+static uint64_t period_us;
+static uint64_t t0_us;           //prazo da amostra 0
+static uint64_t first_start_us;
+static uint64_t last_start_us;
+static uint32_t next_k;          //índice do próximo prazo
+static uint32_t first_k;         //índice da primeira amostra atendida
+static volatile bool due = false;
+static sample_scheduler_stats_t stats;
+
+static uint64_t deadline_us(uint32_t k) {
+    return t0_us + (uint64_t)k * period_us; //produto, não soma acumulada: sem erro de arredondamento
+}
+
+//IRQ do timer: só marca a amostra como devida (a entrada na exceção já acorda o WFE deste núcleo;
+//um __sev acordaria também o outro à toa)
+static void alarm_fired(uint alarm) {
+    (void)alarm;
+    due = true;
+}
+
+static void arm(uint32_t k) {
+    due = false;
+    //true: o prazo já passou antes de o alarme ser armado (o IRQ não virá)
+    if (hardware_alarm_set_target((uint)alarm_num, from_us_since_boot(deadline_us(k))))
+        due = true;
+}
+
+void sample_scheduler_init(uint32_t period_ms, uint32_t first_delay_ms) {
+    memset(&stats, 0, sizeof(stats));
+    stats.lateness_min_us = stats.period_err_min_us = INT32_MAX;
+    stats.lateness_max_us = stats.period_err_max_us = INT32_MIN;
+    period_us = (uint64_t)period_ms * 1000;
+    t0_us = time_us_64() + (uint64_t)first_delay_ms * 1000;
+    next_k = 0;
+    if (alarm_num < 0) {
+        alarm_num = hardware_alarm_claim_unused(true);
+        hardware_alarm_set_callback((uint)alarm_num, alarm_fired);
+    }
+    arm(next_k);
+}
+
+static void record_start(uint64_t start_us, uint64_t deadline) { //antes de next_k avançar
+    int32_t late = (int32_t)(start_us - deadline);
+    stats.lateness_us = late;
+    if (late < stats.lateness_min_us) stats.lateness_min_us = late;
+    if (late > stats.lateness_max_us) stats.lateness_max_us = late;
+    stats.lateness_sum_us += (uint64_t)late;
+    if (stats.samples == 0) {
+        first_start_us = start_us;
+        first_k = next_k;
+    } else {
+        int32_t err = (int32_t)((int64_t)(start_us - last_start_us) - (int64_t)period_us);
+        if (err < stats.period_err_min_us) stats.period_err_min_us = err;
+        if (err > stats.period_err_max_us) stats.period_err_max_us = err;
+    }
+    stats.drift_us = (int64_t)(start_us - first_start_us) - (int64_t)((next_k - first_k) * period_us);
+    stats.seq = next_k;
+    last_start_us = start_us;
+}
+
+bool sample_scheduler_wait(uint32_t timeout_ms) {
+    absolute_time_t until = make_timeout_time_ms(timeout_ms);
+    for (;;) {
+        while (!due) {
+            if (best_effort_wfe_or_timeout(until) && !due) return false; //WFE até o IRQ do alarme ou o timeout
+        }
+        uint64_t start = time_us_64();
+        if ((int64_t)(start - deadline_us(next_k)) <= (int64_t)SAMPLE_SCHEDULER_MAX_LATE_MS * 1000) {
+            record_start(start, deadline_us(next_k));
+            stats.samples++;
+            next_k++;
+            arm(next_k);
+            return true;
+        }
+        //o ciclo anterior passou do prazo: lida agora, a amostra ficaria fora da grade com o seq do prazo.
+        //Conta este e os outros vencidos como perdidos e espera o próximo prazo da grade
+        do {
+            next_k++;
+            stats.missed++;
+        } while (deadline_us(next_k) <= start);
+        arm(next_k);
+    }
+}
+
+const sample_scheduler_stats_t* sample_scheduler_stats(void) {
+    return &stats;
+}
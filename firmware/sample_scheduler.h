@@ -0,0 +1,44 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//agenda das amostras em prazos absolutos: a amostra k é devida em t0 + k * período, com o prazo
+//armado num alarme de hardware do timer, então o tempo de aquisição, inferência e display não
+//se soma ao período (o laço antigo media o intervalo a partir do fim do ciclo anterior e derivava
+//~80 ms por amostra). Entre eventos o núcleo dorme em WFE; o IRQ do alarme o acorda.
+//Uma amostra só começa até SAMPLE_SCHEDULER_MAX_LATE_MS depois do seu prazo: se o ciclo anterior
+//terminar depois disso, o prazo e os seguintes já vencidos contam como perdidos e a amostra espera o
+//próximo prazo da grade, então toda amostra iniciada está no instante do seu seq (nunca recomeça a
+//partir do atraso)
+
+#ifndef SAMPLE_SCHEDULER_MAX_LATE_MS
+#define SAMPLE_SCHEDULER_MAX_LATE_MS 100 //acima do despertar e dos comandos do serial, abaixo do que desloca a janela
+#endif
+
+typedef struct {
+    uint32_t samples;          //prazos atendidos
+    uint32_t missed;           //prazos pulados (ciclo anterior terminou mais de MAX_LATE_MS depois deles)
+    int32_t lateness_us;       //última amostra: início - prazo (latência do IRQ + despertar)
+    int32_t lateness_min_us;
+    int32_t lateness_max_us;
+    uint64_t lateness_sum_us;
+    int32_t period_err_min_us; //(início k - início k-1) - período
+    int32_t period_err_max_us;
+    int64_t drift_us;          //(início k - início 0) - k * período: desvio acumulado da grade
+    uint32_t seq;              //k da última amostra iniciada, no prazo dela (prazos perdidos contam na grade)
+} sample_scheduler_stats_t;
+
+//t0 = agora + first_delay_ms; chamar no núcleo que espera (o IRQ do alarme fica nele)
+void sample_scheduler_init(uint32_t period_ms, uint32_t first_delay_ms);
+//dorme até o prazo da próxima amostra ou até timeout_ms (tarefas periódicas do laço, como os
+//comandos do serial); true se a amostra é devida: o início é registrado e o próximo prazo armado
+bool sample_scheduler_wait(uint32_t timeout_ms);
+const sample_scheduler_stats_t* sample_scheduler_stats(void);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,45 @@
+#include "sensor_acquisition.h"
+#include <string.h>
+
+void sensor_acquisition_init(sensor_acquisition_t* a, i2c_inst_t* i2c, struct bmp280_calib_param* bmp_params) {
+    memset(a, 0, sizeof(*a));
+    a->i2c = i2c;
+    a->bmp_params = bmp_params;
+}
+
+int sensor_acquisition_start(sensor_acquisition_t* a) {
+    a->start_us = time_us_64();
+    if (!aht20_trigger(&a->aht, a->i2c)) return -1; //conversão do AHT20 começa aqui
+
+    //barramento livre durante a conversão: lê temperatura e pressão do BMP280
+    int32_t temp_raw, press_raw;
+    bmp280_read_raw(a->i2c, &temp_raw, &press_raw);
+    a->counts.v[2] = bmp280_convert_temp(temp_raw, a->bmp_params);                //°C x100
+    a->counts.v[3] = bmp280_convert_pressure(press_raw, temp_raw, a->bmp_params); //Pa
+    return 0;
+}
+
+int sensor_acquisition_poll(sensor_acquisition_t* a) {
+    AHT20_State state = aht20_poll(&a->aht);
+    if (state == AHT20_STATE_CONVERTING) return 0;
+    AHT20_Raw dados_aht;
+    if (state != AHT20_STATE_READY || !aht20_collect_raw(&a->aht, &dados_aht)) return -1;
+    a->counts.v[0] = (int32_t)dados_aht.temperature;
+    a->counts.v[1] = (int32_t)dados_aht.humidity;
+    a->sample_us = (uint32_t)(time_us_64() - a->start_us);
+    return 1;
+}
+
+absolute_time_t sensor_acquisition_next_poll(const sensor_acquisition_t* a) {
+    return aht20_next_poll(&a->aht);
+}
+
+int sensor_acquisition_read(sensor_acquisition_t* a, sensor_counts_t* counts) {
+    if (sensor_acquisition_start(a) != 0) return -1;
+    int rc;
+    while ((rc = sensor_acquisition_poll(a)) == 0)
+        sleep_until(sensor_acquisition_next_poll(a)); //nada mais usa o I2C0 até o AHT20 terminar
+    if (rc < 0) return -1;
+    *counts = a->counts;
+    return 0;
+}
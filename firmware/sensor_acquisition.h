@@ -0,0 +1,40 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/time.h"
+#include "hardware/i2c.h"
+#include "aht20.h"
+#include "bmp280.h"
+#include "sensor_window.h" //NUM_FEATURES
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//leituras de uma amostra como saem dos drivers, ainda inteiras: a conversão para unidades físicas e a
+//normalização ficam para o caminho float (main.c) ou inteiro (sensor_fixed.c)
+typedef struct {
+    int32_t v[NUM_FEATURES]; //AHT20 T e UR (contagens de 20 bits), BMP280 °C x100 e Pa (compensação inteira)
+} sensor_counts_t;
+
+//aquisição sobreposta no I2C0 compartilhado: dispara a conversão do AHT20 (~80 ms), lê o burst
+//de medição do BMP280 (0xF7..0xFC) enquanto o AHT20 converte e só então coleta o AHT20.
+//O BMP280 fica em modo normal, então seus registradores já têm a última medição
+typedef struct {
+    i2c_inst_t* i2c;
+    struct bmp280_calib_param* bmp_params;
+    AHT20_Measurement aht;
+    sensor_counts_t counts;  //última amostra
+    uint64_t start_us;
+    uint32_t sample_us;      //duração da última aquisição (disparo -> AHT20 coletado)
+} sensor_acquisition_t;
+
+void sensor_acquisition_init(sensor_acquisition_t* a, i2c_inst_t* i2c, struct bmp280_calib_param* bmp_params);
+int  sensor_acquisition_start(sensor_acquisition_t* a); //dispara AHT20 e lê BMP280; 0 se OK
+int  sensor_acquisition_poll(sensor_acquisition_t* a);  //1 amostra pronta em counts, 0 convertendo, -1 erro
+absolute_time_t sensor_acquisition_next_poll(const sensor_acquisition_t* a); //próxima consulta útil
+int  sensor_acquisition_read(sensor_acquisition_t* a, sensor_counts_t* counts); //bloqueante; 0 se OK
+
+#ifdef __cplusplus
+}
+#endif
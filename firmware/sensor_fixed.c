@@ -0,0 +1,44 @@
+#include "sensor_fixed.h"
+#include <math.h>
+
+typedef struct {
+    int32_t multiplier; //em [2^30, 2^31): precisão de ~30 bits para qualquer escala
+    int64_t offset;     //média na mesma escala, já com o meio LSB do arredondamento
+    uint8_t shift;
+} fixed_feature_t;
+
+static fixed_feature_t features[NUM_FEATURES];
+
+//valor físico = contagem * unidade + origem (AHT20: datasheet; BMP280: °C x100 e Pa -> hPa)
+static const double unit[NUM_FEATURES]   = {200.0 / 1048576.0, 100.0 / 1048576.0, 0.01, 0.01};
+static const double origin[NUM_FEATURES] = {-50.0, 0.0, 0.0, 0.0};
+
+void sensor_fixed_init(const float mean[NUM_FEATURES], const float scale[NUM_FEATURES]) {
+    for (int f = 0; f < NUM_FEATURES; f++) {
+        //z = (contagem * unidade + origem - média) / escala, em unidades de 2^-16
+        double m = unit[f] / scale[f] * (1 << SENSOR_FIXED_FRAC_BITS);
+        int shift = 0;
+        while (m * 2.0 < 2147483647.0 && shift < 48) { //normaliza o multiplicador para 31 bits
+            m *= 2.0;
+            shift++;
+        }
+        double off = ldexp((mean[f] - origin[f]) / scale[f] * (1 << SENSOR_FIXED_FRAC_BITS), shift);
+        features[f].multiplier = (int32_t)llround(m);
+        features[f].offset = llround(off) - (shift ? (int64_t)1 << (shift - 1) : 0);
+        features[f].shift = (uint8_t)shift;
+    }
+}
+
+void sensor_fixed_normalize(const sensor_counts_t* c, int32_t z[NUM_FEATURES]) {
+    for (int f = 0; f < NUM_FEATURES; f++) {
+        const fixed_feature_t* p = &features[f];
+        z[f] = (int32_t)(((int64_t)c->v[f] * p->multiplier - p->offset) >> p->shift); //32x32 -> 64 bits
+    }
+}
+
+void sensor_fixed_centi(const sensor_counts_t* c, int32_t centi[NUM_FEATURES]) {
+    centi[0] = ((c->v[0] * 625 + (1 << 14)) >> 15) - 5000; //c * 20000 / 2^20 - 5000
+    centi[1] = (c->v[1] * 625 + (1 << 15)) >> 16;          //c * 10000 / 2^20
+    centi[2] = c->v[2];                                    //BMP280 já em °C x100
+    centi[3] = c->v[3];                                    //Pa = hPa x100
+}
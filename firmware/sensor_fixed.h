@@ -0,0 +1,20 @@
+#pragma once
+#include <stdint.h>
+#include "sensor_acquisition.h" //sensor_counts_t, NUM_FEATURES
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//caminho inteiro sensor -> tensor: unidade do driver, média e escala do scaler são dobradas em um
+//multiplicador inteiro + deslocamento por feature (como os multiplicadores quantizados do TFLite),
+//z = (x * multiplier - offset) >> shift, com z em Q15.16. Só sensor_fixed_init() usa ponto flutuante
+#define SENSOR_FIXED_FRAC_BITS 16
+
+void sensor_fixed_init(const float mean[NUM_FEATURES], const float scale[NUM_FEATURES]);
+void sensor_fixed_normalize(const sensor_counts_t* c, int32_t z[NUM_FEATURES]); //z-score em Q15.16
+void sensor_fixed_centi(const sensor_counts_t* c, int32_t centi[NUM_FEATURES]); //°C, %RH, °C, hPa x100
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,21 @@
+#include "sensor_window.h"
+#include <string.h>
+
+void sensor_window_init(sensor_window_t* w) {
+    memset(w, 0, sizeof(*w));
+}
+
+void sensor_window_push(sensor_window_t* w, const float sample[NUM_FEATURES]) {
+    memcpy(w->rows[w->head], sample, sizeof(w->rows[0]));               //posição no anel
+    memcpy(w->rows[w->head + WINDOW_SIZE], sample, sizeof(w->rows[0])); //espelho
+    w->head = (w->head + 1) % WINDOW_SIZE; //a mais antiga passa a ser a seguinte
+    if (w->count < WINDOW_SIZE) w->count++;
+}
+
+const float* sensor_window_view(const sensor_window_t* w) {
+    return &w->rows[w->head][0]; //rows[head .. head+9]: mais antiga -> mais recente
+}
+
+bool sensor_window_full(const sensor_window_t* w) {
+    return w->count == WINDOW_SIZE;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+
+#define WINDOW_SIZE        10    //tamanho da janela temporal usada pelo modelo
+#define NUM_FEATURES       4     //Temp_AHT20, Umid_AHT20, Temp_BMP280, Press_BMP280
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//janela deslizante em anel espelhado: cada amostra é gravada em rows[pos] e em
+//rows[pos + WINDOW_SIZE], então as WINDOW_SIZE linhas a partir de rows[head] estão
+//sempre contíguas e em ordem cronológica (mais antiga -> mais recente), no mesmo
+//layout [10][4] do tensor de entrada e das sequências do create_sequences() do treino
+typedef struct {
+    float rows[2 * WINDOW_SIZE][NUM_FEATURES];
+    int head;  //índice da amostra mais antiga (e da próxima a ser sobrescrita)
+    int count; //amostras válidas, satura em WINDOW_SIZE
+} sensor_window_t;
+
+void sensor_window_init(sensor_window_t* w);
+void sensor_window_push(sensor_window_t* w, const float sample[NUM_FEATURES]); //insere amostra normalizada
+const float* sensor_window_view(const sensor_window_t* w); //float[10][4] cronológico, sem cópia
+bool sensor_window_full(const sensor_window_t* w);
+
+#ifdef __cplusplus
+}
+#endif
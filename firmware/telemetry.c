@@ -0,0 +1,129 @@
+#include "telemetry.h"
+#include "crc.h"
+#include "cycle_counter.h"
+#include "pico/stdlib.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define MAX_RECORD   36                          //maior registro (telemetry_sample_t)
+#define MAX_RAW      (1 + MAX_RECORD + 4)        //tipo + registro + CRC-32
+#define MAX_FRAME    (1 + MAX_RAW + 1 + 1)       //0x00 + COBS (1 byte de overhead até 254) + 0x00
+
+_Static_assert(sizeof(telemetry_sample_t) == 36, "registro sem preenchimento");
+_Static_assert(sizeof(telemetry_prediction_t) == 24, "registro sem preenchimento");
+_Static_assert(sizeof(telemetry_timing_t) == 24, "registro sem preenchimento");
+_Static_assert(sizeof(telemetry_error_record_t) == 12, "registro sem preenchimento");
+
+static volatile telemetry_mode_t mode = TELEMETRY_MODE_TEXT;
+static volatile uint32_t seq = 0;
+//totais por núcleo (cada um só escreve o seu): core0 imprime a aquisição no pipeline em dois núcleos
+static volatile uint32_t total_bytes[2], total_cycles[2];
+static uint32_t cycle_bytes_mark, cycle_cycles_mark; //totais no fim do ciclo anterior
+
+static void account(uint32_t bytes, uint32_t start) {
+    unsigned core = get_core_num();
+    total_cycles[core] += cycle_counter_elapsed(start, cycle_counter_read());
+    total_bytes[core] += bytes;
+}
+
+void telemetry_init(telemetry_mode_t m) {
+    mode = m;
+}
+
+telemetry_mode_t telemetry_mode(void) {
+    return mode;
+}
+
+void telemetry_set_mode(telemetry_mode_t m) {
+    mode = m;
+}
+
+int telemetry_printf(const char* fmt, ...) {
+    if (mode != TELEMETRY_MODE_TEXT) return 0; //sem formatação (nem de float) no modo binário
+    uint32_t start = cycle_counter_read();
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vprintf(fmt, ap);
+    va_end(ap);
+    account(n > 0 ? (uint32_t)n : 0, start);
+    return n;
+}
+
+//COBS: troca cada 0x00 pela distância até o próximo, então 0x00 só aparece como delimitador
+static size_t cobs_encode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t code_pos = 0, o = 1;
+    uint8_t code = 1;
+    for (size_t i = 0; i < len; i++) {
+        if (in[i] == 0) {
+            out[code_pos] = code;
+            code_pos = o++;
+            code = 1;
+        } else {
+            out[o++] = in[i];
+            if (++code == 0xFF) { //bloco cheio (254 bytes): nunca acontece nos registros atuais
+                out[code_pos] = code;
+                code_pos = o++;
+                code = 1;
+            }
+        }
+    }
+    out[code_pos] = code;
+    return o;
+}
+
+static void send_frame(telemetry_type_t type, const void* record, size_t len) {
+    uint32_t start = cycle_counter_read();
+    uint8_t raw[MAX_RAW], frame[MAX_FRAME];
+    raw[0] = (uint8_t)type;
+    memcpy(raw + 1, record, len);
+    uint32_t crc = crc32_update(0, raw, 1 + len);
+    memcpy(raw + 1 + len, &crc, sizeof(crc)); //little-endian, como os registros
+    frame[0] = 0;
+    size_t n = 1 + cobs_encode(raw, 1 + len + sizeof(crc), frame + 1);
+    frame[n++] = 0;
+    stdio_put_string((const char*)frame, (int)n, false, false); //sem tradução de \n para \r\n
+    account((uint32_t)n, start);
+}
+
+void telemetry_sample(const telemetry_sample_t* r) {
+    seq++;
+    if (mode != TELEMETRY_MODE_BINARY) return;
+    telemetry_sample_t rec = *r;
+    rec.seq = seq;
+    send_frame(TELEMETRY_SAMPLE, &rec, sizeof(rec));
+}
+
+void telemetry_prediction(const telemetry_prediction_t* r) {
+    if (mode != TELEMETRY_MODE_BINARY) return;
+    telemetry_prediction_t rec = *r;
+    rec.seq = seq;
+    send_frame(TELEMETRY_PREDICTION, &rec, sizeof(rec));
+}
+
+void telemetry_error(telemetry_error_t code, int32_t detail) {
+    if (mode != TELEMETRY_MODE_BINARY) return;
+    telemetry_error_record_t rec = {seq, (int16_t)code, 0, detail};
+    send_frame(TELEMETRY_ERROR, &rec, sizeof(rec));
+}
+
+void telemetry_cycle_end(const telemetry_timing_t* timing) {
+    uint32_t bytes = total_bytes[0] + total_bytes[1], cycles = total_cycles[0] + total_cycles[1];
+    uint32_t cycle_bytes = bytes - cycle_bytes_mark, cycle_cycles = cycles - cycle_cycles_mark;
+    cycle_bytes_mark = bytes;
+    cycle_cycles_mark = cycles;
+    if (mode == TELEMETRY_MODE_TEXT) {
+        telemetry_printf("Saída: %lu bytes de texto, %lu ciclos\n", (unsigned long)cycle_bytes,
+                         (unsigned long)cycle_cycles);
+        return;
+    }
+    telemetry_timing_t rec;
+    if (timing)
+        rec = *timing;
+    else
+        memset(&rec, 0, sizeof(rec));
+    rec.seq = seq;
+    rec.output_bytes = cycle_bytes;
+    rec.output_cycles = cycle_cycles;
+    send_frame(TELEMETRY_TIMING, &rec, sizeof(rec));
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_acquisition.h" //sensor_counts_t
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//saída do ciclo de amostragem em dois modos, escolhidos no build (-DTELEMETRY_BINARY=ON) e trocados em
+//execução pelo comando 't' no serial:
+//  texto:   as linhas de sempre (telemetry_printf), legíveis no monitor serial
+//  binário: registros fixos em quadros COBS (0x00 delimita) com CRC-32, sem formatação de float;
+//           host/telemetry_decode.cpp converte o fluxo em CSV ou colunas binárias
+//Nos dois modos os bytes e os ciclos gastos na saída são contados por ciclo de amostragem e
+//reportados em telemetry_cycle_end (linha "Saída:" ou registro TELEMETRY_TIMING)
+//
+//Quadro: 0x00 | COBS(tipo u8, registro, CRC-32 de tipo+registro) | 0x00. O 0x00 inicial isola o
+//quadro de texto que tenha saído antes (boot, dumps de comandos), que o decodificador descarta
+
+typedef enum {
+    TELEMETRY_MODE_TEXT = 0,
+    TELEMETRY_MODE_BINARY,
+} telemetry_mode_t;
+
+typedef enum {
+    TELEMETRY_SAMPLE = 1,
+    TELEMETRY_PREDICTION,
+    TELEMETRY_TIMING,
+    TELEMETRY_ERROR,
+} telemetry_type_t;
+
+typedef enum {
+    TELEMETRY_ERR_SENSOR = 1,  //leitura do AHT20/BMP280 falhou
+    TELEMETRY_ERR_INVOKE,      //invoke do modelo retornou erro (detail = código)
+    TELEMETRY_ERR_QUEUE_FULL,  //pipeline em dois núcleos: amostra descartada (detail = descartes)
+    TELEMETRY_ERR_FLASH,       //gravação na flash (checkpoint ou log) falhou
+} telemetry_error_t;
+
+//registros little-endian, sem preenchimento entre campos
+typedef struct {
+    uint32_t seq;              //amostra desde o boot
+    uint32_t t_ms;             //ms desde o boot na leitura
+    sensor_counts_t counts;    //leituras inteiras dos drivers (AHT20 contagens, BMP280 °C x100 e Pa)
+    uint32_t acquisition_us;   //disparo do AHT20 -> amostra pronta
+    uint32_t normalize_cycles; //conversão + normalização (ciclos; ns no host)
+    int32_t lateness_us;       //início da amostra - prazo t0 + k * período (sample_scheduler)
+} telemetry_sample_t;
+
+typedef struct {
+    uint32_t seq;              //amostra que completou a janela da previsão
+    float pred[3];             //+5/+10/+15 min em °C, float32 como sai do modelo
+    uint32_t invoke_us;
+    uint8_t model;             //índice no registro de modelos (tflm_active_model)
+    uint8_t reserved[3];
+} telemetry_prediction_t;
+
+typedef struct {
+    uint32_t seq;
+    uint32_t display_cpu_us;   //CPU no envio do display
+    uint16_t display_bytes;    //bytes no I2C1 (só os retângulos sujos)
+    uint16_t display_rects;
+    uint32_t latency_us;       //amostra -> display (pipeline em dois núcleos; 0 em um núcleo)
+    uint32_t output_bytes;     //bytes de saída do ciclo até este registro (ele entra no próximo)
+    uint32_t output_cycles;    //ciclos gastos nessa saída (ns no host)
+} telemetry_timing_t;
+
+typedef struct {
+    uint32_t seq;
+    int16_t code;              //telemetry_error_t
+    uint16_t reserved;
+    int32_t detail;
+} telemetry_error_record_t;
+
+void telemetry_init(telemetry_mode_t mode);
+telemetry_mode_t telemetry_mode(void);
+void telemetry_set_mode(telemetry_mode_t mode);
+static inline bool telemetry_text(void) { return telemetry_mode() == TELEMETRY_MODE_TEXT; }
+
+int  telemetry_printf(const char* fmt, ...) __attribute__((format(printf, 1, 2))); //só no modo texto
+void telemetry_sample(const telemetry_sample_t* r);
+void telemetry_prediction(const telemetry_prediction_t* r);
+void telemetry_error(telemetry_error_t code, int32_t detail);
+//fim do ciclo de amostragem: bytes e ciclos de saída do ciclo (linha "Saída:" ou registro TIMING).
+//timing pode ser NULL (ciclo sem predição: só a linha/registro de saída)
+void telemetry_cycle_end(const telemetry_timing_t* timing);
+
+#ifdef __cplusplus
+}
+#endif
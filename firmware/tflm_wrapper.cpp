@@ -1,34 +1,134 @@
 #include "tflm_wrapper.h"
-#include "temperature_model.h" //modelo CNN 1D embarcado na flash
+#include "model_registry_data.h" //flatbuffers e descritores gerados por tools/gen_model_registry.py
+#include "pico/time.h"
+#include "tensorflow/lite/micro/micro_allocator.h"
 #include "tensorflow/lite/micro/micro_interpreter.h"
 #include "tensorflow/lite/micro/micro_mutable_op_resolver.h"
 #include "tensorflow/lite/schema/schema_generated.h"
+#ifdef OP_PROFILER
+#include "tensorflow/lite/micro/micro_profiler_interface.h"
+#include "op_profiler.h"
+
+//encaminha os eventos por operador do MicroInterpreter para o op_profiler
+class OpProfilerAdapter : public tflite::MicroProfilerInterface {
+public:
+    uint32_t BeginEvent(const char* tag) override { return op_profiler_begin(tag); }
+    void EndEvent(uint32_t event_handle) override { op_profiler_end(event_handle); }
+};
+static OpProfilerAdapter op_profiler_adapter;
+#endif
+#include <new>
 #include <stdio.h>
+#include <string.h>
+
+static_assert(MODEL_REGISTRY_COUNT <= MODEL_REGISTRY_MAX, "registro maior que MODEL_REGISTRY_MAX");
 
-static constexpr int kTensorArenaSize = 60 * 1024;
+//o maior entre o plano de tools/plan_arena.py (ativações com reuso + persistente de cada modelo + margem,
+//MODEL_REGISTRY_PLANNED_ARENA_BYTES) e TFLM_ARENA_MIN: o plano estima a parte persistente, e a arena só
+//desce para ele com o host/tests/test_tflm_arena.cpp passando no TFLM real
+static constexpr int kTensorArenaSize = MODEL_REGISTRY_ARENA_BYTES;
 alignas(16) static uint8_t tensor_arena[kTensorArenaSize]; //alinhado em 16 bytes para performance
 
-static const tflite::Model*    model_ptr       = nullptr;
-static tflite::MicroInterpreter* interpreter_ptr = nullptr;
-static TfLiteTensor* input_ptr  = nullptr; //tensor de entrada [1, 10, 4] float32
-static TfLiteTensor* output_ptr = nullptr; //tensor de saída [1, 3] float32
+//um interpretador por modelo sobre o mesmo MicroAllocator (multi-tenant do TFLM): a parte persistente
+//de cada modelo (tensores, nós, dados dos kernels) fica no fim da arena, uma atrás da outra, e a área de
+//ativações do início é compartilhada, com o tamanho da maior. Um invoke sobrescreve as ativações dos
+//outros modelos, inclusive entrada e saída: a entrada é copiada da janela e a saída para output_staging
+//a cada invoke, e a API nunca expõe os tensores da arena
+struct tflm_model_t {
+    tflite::MicroInterpreter* interpreter;
+    TfLiteTensor* input;  //tensor de entrada [1, 10, 4] float32 ou int8
+    TfLiteTensor* output; //tensor de saída [1, 3] float32 ou int8
+    bool int8;            //a API continua float, quantização/dequantização acontece nas bordas do invoke
+};
+alignas(tflite::MicroInterpreter) static uint8_t interpreter_storage[MODEL_REGISTRY_COUNT][sizeof(tflite::MicroInterpreter)];
+static tflm_model_t models[MODEL_REGISTRY_COUNT];
+static tflite::MicroAllocator* allocator = nullptr;
+static int active = -1;
 
-extern "C" int tflm_init(void) {
-    printf("[TFLM] Carregando modelo...\n");
-    model_ptr = tflite::GetModel(temperature_model);
-    if (!model_ptr) {
+static float input_staging[MODEL_REGISTRY_WINDOW * MODEL_REGISTRY_FEATURES]; //janela normalizada (sem tflm_bind_input)
+static float output_staging[MODEL_REGISTRY_HORIZONS];                       //previsões já dequantizadas em °C
+static uint32_t last_invoke_us = 0;
+static const float* bound_input = nullptr; //janela externa (sensor_window_view), lida a cada invoke
+
+static inline int8_t quantize_int8(float x, float inv_scale, int32_t zero_point) {
+    float q = x * inv_scale;
+    int32_t v = (int32_t)(q >= 0.0f ? q + 0.5f : q - 0.5f) + zero_point; //round half away from zero (igual ao TFLM)
+    if (v < -128) v = -128;
+    if (v > 127) v = 127;
+    return (int8_t)v;
+}
+
+//carrega model_registry[idx] num interpretador próprio sobre o alocador compartilhado
+static int init_model(int idx, const tflite::MicroOpResolver& resolver) {
+    const model_descriptor_t* desc = &model_registry[idx];
+    tflm_model_t* m = &models[idx];
+    printf("[TFLM] Carregando modelo %s (%lu bytes)...\n", desc->name, (unsigned long)desc->tflite_len);
+    const tflite::Model* model = tflite::GetModel(desc->tflite);
+    if (!model) {
         printf("[TFLM] ERRO: Modelo nao encontrado!\n");
         return 1;
     }
-    printf("[TFLM] Modelo carregado OK\n");
-
-    printf("[TFLM] Verificando versao do schema...\n");
-    if (model_ptr->version() != TFLITE_SCHEMA_VERSION) {
-        printf("[TFLM] ERRO: Schema v%d, esperado v%d\n", model_ptr->version(), TFLITE_SCHEMA_VERSION);
+    if (model->version() != TFLITE_SCHEMA_VERSION) {
+        printf("[TFLM] ERRO: Schema v%d, esperado v%d\n", model->version(), TFLITE_SCHEMA_VERSION);
         return 2;
     }
-    printf("[TFLM] Schema OK (v%d)\n", TFLITE_SCHEMA_VERSION);
+#ifdef OP_PROFILER
+    m->interpreter = new (interpreter_storage[idx])
+        tflite::MicroInterpreter(model, resolver, allocator, nullptr, &op_profiler_adapter);
+#else
+    m->interpreter = new (interpreter_storage[idx]) tflite::MicroInterpreter(model, resolver, allocator);
+#endif
+    if (m->interpreter->AllocateTensors() != kTfLiteOk) {
+        printf("[TFLM] ERRO: AllocateTensors falhou!\n");
+        return 3;
+    }
+    m->input  = m->interpreter->input(0);
+    m->output = m->interpreter->output(0);
+    if (!m->input || !m->output) {
+        printf("[TFLM] ERRO: Tensores nulos!\n");
+        return 4;
+    }
+    printf("[TFLM] Input type: %d, Output type: %d (esperado: %d=float32 ou %d=int8)\n",
+           m->input->type, m->output->type, kTfLiteFloat32, kTfLiteInt8);
+    if (m->input->type != kTfLiteFloat32 && m->input->type != kTfLiteInt8) {
+        printf("[TFLM] ERRO: Tipo do input incorreto!\n");
+        return 5;
+    }
+    if (m->output->type != m->input->type) {
+        printf("[TFLM] ERRO: Tipo do output incorreto!\n");
+        return 6;
+    }
+    m->int8 = (m->input->type == kTfLiteInt8);
+    size_t elem = m->int8 ? 1 : sizeof(float);
+    if (m->input->bytes != sizeof(input_staging) / sizeof(float) * elem ||
+        m->output->bytes != sizeof(output_staging) / sizeof(float) * elem) {
+        printf("[TFLM] ERRO: Forma dos tensores incompativel com o registro!\n");
+        return 8;
+    }
+    if (m->int8)
+        printf("[TFLM] Modelo int8: in scale=%f zp=%d | out scale=%f zp=%d\n",
+               m->input->params.scale, (int)m->input->params.zero_point,
+               m->output->params.scale, (int)m->output->params.zero_point);
+    printf("[TFLM] %s OK (%d ops), arena usada ate aqui: %d bytes\n", desc->name, desc->num_ops,
+           (int)allocator->used_bytes());
+    return 0;
+}
+
+extern "C" int tflm_init(void) {
+    return tflm_init_models((1u << MODEL_REGISTRY_COUNT) - 1);
+}
+
+extern "C" int tflm_init_models(uint32_t mask) {
+    mask &= (1u << MODEL_REGISTRY_COUNT) - 1;
+    if (!mask || allocator) { //os interpretadores vivem até o reset: um subconjunto por boot
+        printf("[TFLM] ERRO: selecao de modelos vazia ou TFLM ja inicializado\n");
+        return 7;
+    }
 
+#ifdef TFLM_FIXED_RESOLVER
+    //resolver fixo de antes do gerado, com os mesmos 11 operadores: só no temperature_prediction_fixed_resolver
+    //(TFLM_FLASH_BASELINE), o "antes" do tools/op_flash_report.py. Sem Shape/StridedSlice/Pack, não carrega o
+    //MLP: a imagem serve só para o mapa do link
     static tflite::MicroMutableOpResolver<11> resolver;
     resolver.AddConv2D();        //Conv1D implementado como Conv2D com width=1
     resolver.AddMean();          //GlobalAveragePooling1D
@@ -41,62 +141,112 @@ extern "C" int tflm_init(void) {
     resolver.AddMaxPool2D();     //max pooling
     resolver.AddSoftmax();       //softmax
     resolver.AddExpandDims();    //ExpandDims
+#else
+    //só os operadores dos modelos do registro, lidos dos flatbuffers no build: kernel fora do resolver não
+    //entra na imagem, e um operador sem kernel no TFLM falha o gen_model_registry.py
+    static tflite::MicroMutableOpResolver<MODEL_REGISTRY_OP_COUNT> resolver;
+    model_registry_add_ops(resolver);
+#endif
 
-    printf("[TFLM] Criando interpretador (arena=%d KB)...\n", kTensorArenaSize / 1024);
-    static tflite::MicroInterpreter static_interpreter(model_ptr, resolver, tensor_arena, kTensorArenaSize);
-    interpreter_ptr = &static_interpreter;
-    printf("[TFLM] Interpretador criado OK\n");
-
-    printf("[TFLM] Alocando tensores...\n");
-    if (interpreter_ptr->AllocateTensors() != kTfLiteOk) {
-        printf("[TFLM] ERRO: AllocateTensors falhou!\n");
+    printf("[TFLM] Criando alocador (arena=%d bytes, %d modelo(s) no registro)...\n",
+           kTensorArenaSize, MODEL_REGISTRY_COUNT);
+#ifdef OP_PROFILER
+    op_profiler_init();
+#endif
+    allocator = tflite::MicroAllocator::Create(tensor_arena, kTensorArenaSize);
+    if (!allocator) {
+        printf("[TFLM] ERRO: arena pequena para o alocador!\n");
         return 3;
     }
-    printf("[TFLM] Tensores alocados OK\n");
-
-    printf("[TFLM] Obtendo ponteiros dos tensores...\n");
-    input_ptr  = interpreter_ptr->input(0);
-    output_ptr = interpreter_ptr->output(0);
-    if (!input_ptr || !output_ptr) {
-        printf("[TFLM] ERRO: Tensores nulos!\n");
-        return 4;
+    for (int i = 0; i < MODEL_REGISTRY_COUNT; i++) {
+        if (!(mask & (1u << i))) continue;
+        int rc = init_model(i, resolver);
+        if (rc != 0) return rc;
+        if (active < 0) active = i; //o primeiro do registro começa ativo
     }
-    printf("[TFLM] Input: %p, Output: %p\n", input_ptr, output_ptr);
+    printf("[TFLM] Inicializacao completa! Arena usado: %d bytes (%d planejados, %d alocados)\n",
+           (int)allocator->used_bytes(), MODEL_REGISTRY_PLANNED_ARENA_BYTES, kTensorArenaSize);
+    return 0;
+}
 
-    printf("[TFLM] Validando tipos dos tensores...\n");
-    printf("[TFLM] Input type: %d (esperado: %d=float32)\n", input_ptr->type, kTfLiteFloat32);
-    printf("[TFLM] Output type: %d (esperado: %d=float32)\n", output_ptr->type, kTfLiteFloat32);
-    if (input_ptr->type != kTfLiteFloat32) {
-        printf("[TFLM] ERRO: Tipo do input incorreto!\n");
-        return 5;
-    }
-    if (output_ptr->type != kTfLiteFloat32) {
-        printf("[TFLM] ERRO: Tipo do output incorreto!\n");
-        return 6;
-    }
+extern "C" int tflm_model_count(void) {
+    return MODEL_REGISTRY_COUNT;
+}
 
-    printf("[TFLM] Inicializacao completa! Arena usado: %d bytes\n", (int)interpreter_ptr->arena_used_bytes());
+extern "C" const model_descriptor_t* tflm_model_info(int idx) {
+    return idx >= 0 && idx < MODEL_REGISTRY_COUNT ? &model_registry[idx] : nullptr;
+}
+
+extern "C" int tflm_select_model(int idx) {
+    if (idx < 0 || idx >= MODEL_REGISTRY_COUNT) return 1;
+    if (!models[idx].interpreter) return 2;
+    active = idx;
     return 0;
 }
 
+extern "C" int tflm_active_model(void) {
+    return active;
+}
+
 extern "C" float* tflm_input_ptr(int* nfloats) {
-    if (!input_ptr) return nullptr;
-    if (nfloats) *nfloats = input_ptr->bytes / sizeof(float); //40 floats: 10 timesteps * 4 features
-    return input_ptr->data.f;
+    if (active < 0) return nullptr;
+    if (nfloats) *nfloats = (int)(sizeof(input_staging) / sizeof(float)); //40 floats: 10 timesteps * 4 features
+    return input_staging; //copiado (ou quantizado) para o tensor do modelo ativo em tflm_invoke()
 }
 
 extern "C" float* tflm_output_ptr(int* nfloats) {
-    if (!output_ptr) return nullptr;
-    if (nfloats) *nfloats = output_ptr->bytes / sizeof(float); //3 floats: previsões 5, 10, 15 min
-    return output_ptr->data.f;
+    if (active < 0) return nullptr;
+    if (nfloats) *nfloats = MODEL_REGISTRY_HORIZONS; //3 floats: previsões 5, 10, 15 min
+    return output_staging; //copiado (ou dequantizado) em tflm_invoke()
 }
 
 extern "C" int tflm_invoke(void) {
-    if (!interpreter_ptr) return 1;
-    return (interpreter_ptr->Invoke() == kTfLiteOk) ? 0 : 2;
+    if (active < 0) return 1;
+    tflm_model_t* m = &models[active];
+    uint32_t start = time_us_32();
+    const float* src = bound_input ? bound_input : input_staging;
+    if (m->int8) { //float normalizado -> int8: q = round(x / scale) + zero_point
+        const float inv_scale = 1.0f / m->input->params.scale;
+        const int32_t zp = m->input->params.zero_point;
+        for (int i = 0; i < MODEL_REGISTRY_WINDOW * MODEL_REGISTRY_FEATURES; i++)
+            m->input->data.int8[i] = quantize_int8(src[i], inv_scale, zp);
+    } else {
+        //o tensor vive na arena do TFLM (compartilhada) e não pode apontar para fora dela: uma cópia contígua
+        memcpy(m->input->data.f, src, m->input->bytes);
+    }
+#ifdef OP_PROFILER
+    op_profiler_begin_invoke();
+    TfLiteStatus status = m->interpreter->Invoke();
+    op_profiler_end_invoke();
+    if (status != kTfLiteOk) return 2;
+#else
+    if (m->interpreter->Invoke() != kTfLiteOk) return 2;
+#endif
+    if (m->int8) { //int8 -> °C: (q - zero_point) * scale
+        const float scale = m->output->params.scale;
+        const int32_t zp = m->output->params.zero_point;
+        for (int i = 0; i < MODEL_REGISTRY_HORIZONS; i++)
+            output_staging[i] = (float)(m->output->data.int8[i] - zp) * scale;
+    } else {
+        memcpy(output_staging, m->output->data.f, sizeof(output_staging));
+    }
+    last_invoke_us = time_us_32() - start;
+    return 0;
+}
+
+extern "C" void tflm_bind_input(const float* window) {
+    bound_input = window;
+}
+
+extern "C" int tflm_model_is_int8(void) {
+    return active >= 0 && models[active].int8 ? 1 : 0;
+}
+
+extern "C" uint32_t tflm_last_invoke_us(void) {
+    return last_invoke_us;
 }
 
 extern "C" int tflm_arena_used_bytes(void) {
-    if (!interpreter_ptr) return -1;
-    return (int)interpreter_ptr->arena_used_bytes();
+    if (!allocator) return -1;
+    return (int)allocator->used_bytes();
 }
@@ -1,15 +1,43 @@
 #pragma once
 #include <stdint.h>
+#include "model_registry.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
-int tflm_init(void); //inicializa TFLM e carrega modelo, retorna 0 se OK
-float* tflm_input_ptr(int* nfloats); //buffer de entrada float32[10][4] = 40 floats
+//códigos de retorno de tflm_init() e tflm_init_models():
+//  0 OK
+//  1 modelo não encontrado no flatbuffer
+//  2 versão do schema incompatível
+//  3 arena pequena (alocador ou AllocateTensors)
+//  4 tensor de entrada ou de saída nulo
+//  5 tipo do input diferente de float32 e int8
+//  6 tipo do output diferente do input
+//  7 seleção de modelos vazia ou TFLM já inicializado
+//  8 forma dos tensores diferente da janela [10][4] e das 3 previsões do registro
+//O motor CODEGEN (codegen_wrapper.cpp) só retorna 0 e 7
+int tflm_init(void); //inicializa TFLM e carrega todos os modelos do registro
+int tflm_init_models(uint32_t mask); //só os modelos com o bit i (model_registry[i]) na arena compartilhada
+int tflm_model_count(void); //modelos embarcados no registro (inicializados ou não)
+const model_descriptor_t* tflm_model_info(int idx); //descritor do modelo idx, NULL fora do registro
+int tflm_select_model(int idx); //troca o modelo ativo: 0 OK, 1 fora do registro, 2 não inicializado
+int tflm_active_model(void); //índice do modelo usado por tflm_invoke()
+float* tflm_input_ptr(int* nfloats); //buffer de entrada float32[10][4] = 40 floats (normalizado)
 float* tflm_output_ptr(int* nfloats); //buffer de saída float32[3]: previsões 5, 10, 15 min
 int tflm_invoke(void); //executa inferência, retorna 0 se OK
-int tflm_arena_used_bytes(void); //bytes usados da arena
+void tflm_bind_input(const float* window); //lê a entrada de uma janela externa float[10][4] cronológica (NULL = tflm_input_ptr)
+int tflm_arena_used_bytes(void); //bytes usados da arena (compartilhada pelos modelos inicializados)
+int tflm_model_is_int8(void); //1 se o modelo ativo é int8 (quantização feita dentro do invoke)
+uint32_t tflm_last_invoke_us(void); //duração do último tflm_invoke() em µs
+
+#ifdef TFLM_STREAMING
+//modo incremental (apenas motor CODEGEN): cada amostra normalizada calcula só a coluna
+//nova de cada Conv1D; o invoke refaz apenas GlobalAveragePooling + camadas densas
+int tflm_stream_push(const float* sample); //insere amostra [4] normalizada, retorna 0 se OK
+int tflm_stream_invoke(void); //executa a cabeça sobre a janela em cache, 3 = janela incompleta
+int tflm_macs_per_invoke(void); //MACs do último invoke (janela completa ou incremental)
+#endif
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,230 @@
+#include "window_checkpoint.h"
+#include "sensor_fixed.h" //sensor_fixed_centi: continuidade em unidades físicas x100
+#include "crc.h"
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "pico/flash.h"
+#include "pico/time.h"
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECKPOINT_MAGIC   0x57434B50u //"WCKP" nos scratch 0..3 (o SDK usa 4..7 no watchdog_reboot)
+#define RECORD_SIZE        32
+#define RECORDS_PER_SECTOR (FLASH_SECTOR_SIZE / RECORD_SIZE)
+#define NUM_RECORDS        (WINDOW_CHECKPOINT_SECTORS * RECORDS_PER_SECTOR)
+#define REGION_OFFSET      WINDOW_CHECKPOINT_OFFSET
+#define SEQ_ERASED         0xFFFFFFFFu
+
+typedef struct {
+    uint64_t t_ms;          //relógio persistente no instante da leitura
+    uint32_t seq;           //crescente entre boots; SEQ_ERASED = slot livre
+    sensor_counts_t counts;
+    uint32_t crc;           //CRC-32 dos 28 bytes anteriores
+} checkpoint_record_t;
+_Static_assert(sizeof(checkpoint_record_t) == RECORD_SIZE, "registro deve ocupar 32 bytes");
+
+static bool enabled = false;
+static uint32_t interval_ms;
+static uint64_t epoch_ms;    //relógio persistente no boot
+static uint32_t next_slot;
+static uint32_t next_seq = 1;
+static bool restore_pending = false;
+static checkpoint_record_t newest;
+static sensor_counts_t tail[WINDOW_SIZE - 1]; //amostras contíguas mais recentes, em ordem cronológica
+static window_checkpoint_result_t result = WINDOW_CHECKPOINT_EMPTY;
+static window_checkpoint_info_t info;
+
+static const checkpoint_record_t* slot_ptr(uint32_t slot) {
+    return (const checkpoint_record_t*)(XIP_BASE + REGION_OFFSET) + slot; //leitura direto pelo XIP
+}
+
+static uint32_t record_crc(const checkpoint_record_t* r) {
+    return crc32_update(0, r, offsetof(checkpoint_record_t, crc));
+}
+
+static bool record_valid(const checkpoint_record_t* r) {
+    return r->seq != SEQ_ERASED && r->crc == record_crc(r);
+}
+
+static bool slot_blank(uint32_t slot) {
+    const uint32_t* w = (const uint32_t*)slot_ptr(slot);
+    for (int i = 0; i < RECORD_SIZE / 4; i++)
+        if (w[i] != 0xFFFFFFFFu) return false;
+    return true;
+}
+
+static bool sector_blank(uint32_t first_slot) {
+    for (uint32_t s = first_slot; s < first_slot + RECORDS_PER_SECTOR; s++)
+        if (!slot_blank(s)) return false;
+    return true;
+}
+
+static uint32_t max_gap_ms(void) {
+    return interval_ms * WINDOW_CHECKPOINT_MAX_GAP_PCT / 100;
+}
+
+//relógio dos scratch do watchdog: zerados na queda de energia, mantidos em reset por watchdog/software
+static bool load_clock(uint64_t* ms) {
+    uint32_t lo = watchdog_hw->scratch[1], hi = watchdog_hw->scratch[2];
+    if (watchdog_hw->scratch[0] != CHECKPOINT_MAGIC || watchdog_hw->scratch[3] != ~(lo ^ hi ^ CHECKPOINT_MAGIC))
+        return false;
+    *ms = ((uint64_t)hi << 32) | lo;
+    return true;
+}
+
+void window_checkpoint_init(uint32_t sample_interval_ms) {
+    interval_ms = sample_interval_ms;
+    memset(&info, 0, sizeof(info));
+    info.age_ms = -1;
+#if PICO_ON_DEVICE
+    extern char __flash_binary_end;
+    if ((uintptr_t)&__flash_binary_end > XIP_BASE + REGION_OFFSET) //binário invadiria a partição
+        return;
+#endif
+    enabled = true;
+
+    //registro mais recente: maior seq válida (o log é circular, a posição não diz nada)
+    uint32_t newest_slot = 0;
+    bool found = false;
+    for (uint32_t s = 0; s < NUM_RECORDS; s++) {
+        const checkpoint_record_t* r = slot_ptr(s);
+        if (!record_valid(r)) continue;
+        info.records++;
+        if (!found || r->seq > newest.seq) {
+            newest = *r;
+            newest_slot = s;
+            found = true;
+        }
+    }
+    if (found) {
+        next_seq = newest.seq + 1;
+        next_slot = (newest_slot + 1) % NUM_RECORDS;
+        //anda para trás enquanto seq e instantes forem contíguos (um reset no meio corta a cadeia)
+        checkpoint_record_t chain[WINDOW_SIZE - 1];
+        int n = 0;
+        chain[n++] = newest;
+        uint32_t s = newest_slot;
+        while (n < WINDOW_SIZE - 1) {
+            s = (s + NUM_RECORDS - 1) % NUM_RECORDS;
+            const checkpoint_record_t* r = slot_ptr(s);
+            const checkpoint_record_t* later = &chain[n - 1];
+            if (!record_valid(r) || r->seq != later->seq - 1 || later->t_ms - r->t_ms > max_gap_ms())
+                break;
+            chain[n++] = *r;
+        }
+        for (int i = 0; i < n; i++)
+            tail[i] = chain[n - 1 - i].counts;
+        info.saved = (uint8_t)n;
+        restore_pending = true;
+    }
+
+    info.warm = load_clock(&epoch_ms);
+    if (!info.warm) //queda de energia: continua depois da última amostra, duração desconhecida
+        epoch_ms = found ? newest.t_ms + interval_ms : 0;
+    if (!info.warm && !WINDOW_CHECKPOINT_COLD_RESTORE && restore_pending) {
+        restore_pending = false;
+        result = WINDOW_CHECKPOINT_COLD;
+    }
+    window_checkpoint_heartbeat();
+}
+
+uint64_t window_checkpoint_clock_ms(void) {
+    return epoch_ms + time_us_64() / 1000;
+}
+
+void window_checkpoint_heartbeat(void) {
+    uint64_t ms = window_checkpoint_clock_ms();
+    uint32_t lo = (uint32_t)ms, hi = (uint32_t)(ms >> 32);
+    watchdog_hw->scratch[0] = CHECKPOINT_MAGIC;
+    watchdog_hw->scratch[1] = lo;
+    watchdog_hw->scratch[2] = hi;
+    watchdog_hw->scratch[3] = ~(lo ^ hi ^ CHECKPOINT_MAGIC);
+}
+
+uint32_t window_checkpoint_first_delay_ms(void) {
+    if (!restore_pending) return interval_ms; //nada a restaurar: janela recomeça como antes
+    if (!info.warm) return 0;                 //a frio: amostra já para testar a continuidade
+    uint64_t due = newest.t_ms + interval_ms, now = window_checkpoint_clock_ms();
+    return due > now ? (uint32_t)(due - now) : 0; //mantém t0 + k * intervalo através do reset
+}
+
+int window_checkpoint_restore(const sensor_counts_t* first, uint64_t t_ms, sensor_counts_t saved[WINDOW_SIZE - 1]) {
+    if (!restore_pending) return 0;
+    restore_pending = false;
+    if (info.warm) {
+        info.age_ms = (int64_t)(t_ms - newest.t_ms);
+        if (info.age_ms > (int64_t)max_gap_ms()) {
+            result = WINDOW_CHECKPOINT_STALE;
+            return 0;
+        }
+    } else {
+        static const int32_t max_step[NUM_FEATURES] = WINDOW_CHECKPOINT_MAX_STEP;
+        int32_t a[NUM_FEATURES], b[NUM_FEATURES];
+        sensor_fixed_centi(&newest.counts, a);
+        sensor_fixed_centi(first, b);
+        for (int f = 0; f < NUM_FEATURES; f++) {
+            if (abs(b[f] - a[f]) > max_step[f]) {
+                result = WINDOW_CHECKPOINT_STEP;
+                return 0;
+            }
+        }
+    }
+    memcpy(saved, tail, info.saved * sizeof(sensor_counts_t));
+    result = WINDOW_CHECKPOINT_RESTORED;
+    return info.saved;
+}
+
+window_checkpoint_result_t window_checkpoint_result(void) {
+    return result;
+}
+
+typedef struct {
+    uint32_t erase_offset; //0: sem apagamento
+    uint32_t page_offset;
+    const uint8_t* page;
+} flash_op_t;
+
+//roda com as interrupções desligadas e o outro núcleo parado fora da flash (flash_safe_execute)
+static void flash_op(void* param) {
+    const flash_op_t* op = (const flash_op_t*)param;
+    if (op->erase_offset)
+        flash_range_erase(op->erase_offset, FLASH_SECTOR_SIZE);
+    flash_range_program(op->page_offset, op->page, FLASH_PAGE_SIZE);
+}
+
+int window_checkpoint_append(const sensor_counts_t* s, uint64_t t_ms) {
+    if (!enabled) return -1;
+    //registro rasgado por um reset no meio da gravação: pula até um slot livre
+    while (next_slot % RECORDS_PER_SECTOR && !slot_blank(next_slot))
+        next_slot = (next_slot + 1) % NUM_RECORDS;
+
+    checkpoint_record_t r;
+    r.t_ms = t_ms;
+    r.seq = next_seq;
+    r.counts = *s;
+    r.crc = record_crc(&r);
+
+    //NOR: programar 0xFF não altera a célula, então a página é gravada com só este registro
+    //preenchido e os vizinhos já gravados ficam intactos (um apagamento a cada 128 amostras)
+    static uint8_t page[FLASH_PAGE_SIZE];
+    uint32_t offset = REGION_OFFSET + next_slot * RECORD_SIZE;
+    flash_op_t op = {0, offset & ~(uint32_t)(FLASH_PAGE_SIZE - 1), page};
+    memset(page, 0xFF, sizeof(page));
+    memcpy(page + (offset - op.page_offset), &r, sizeof(r));
+    if (next_slot % RECORDS_PER_SECTOR == 0 && !sector_blank(next_slot))
+        op.erase_offset = offset; //entra no setor mais antigo: apaga antes do primeiro registro
+
+    uint64_t start = time_us_64();
+    if (flash_safe_execute(flash_op, &op, 100) != PICO_OK) return -1;
+    info.last_write_us = (uint32_t)(time_us_64() - start);
+    if (op.erase_offset) info.erases++;
+    info.writes++;
+    next_seq++;
+    next_slot = (next_slot + 1) % NUM_RECORDS;
+    return 0;
+}
+
+const window_checkpoint_info_t* window_checkpoint_info(void) {
+    return &info;
+}
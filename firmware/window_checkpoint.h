@@ -0,0 +1,65 @@
+#pragma once
+#include <stdint.h>
+#include <stdbool.h>
+#include "sensor_acquisition.h" //sensor_counts_t, WINDOW_SIZE, NUM_FEATURES
+#include "flash_layout.h"       //WINDOW_CHECKPOINT_SECTORS e WINDOW_CHECKPOINT_OFFSET
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//checkpoint da janela entre resets: cada amostra inserida vira um registro de 32 bytes (contagens
+//dos drivers + instante) num log circular em WINDOW_CHECKPOINT_SECTORS setores reservados no fim da
+//flash. Só o setor mais antigo é apagado quando o atual enche, então os registros da janela anterior
+//continuam válidos durante o apagamento. No boot as últimas amostras contíguas do log são reinseridas
+//pelo caminho normal (conversão, normalização e colunas do motor incremental) junto com a primeira
+//amostra nova, e a predição volta na primeira amostra em vez de depois de 10.
+//
+//O instante vem de um relógio em ms que continua entre resets: os registradores scratch do watchdog
+//guardam o último valor (window_checkpoint_heartbeat) e sobrevivem a reset por watchdog/software, mas
+//não a queda de energia. Reset a quente: a idade das amostras salvas é conhecida e a primeira
+//amostra nova mantém a cadência. Boot a frio: a idade é desconhecida e a janela só é aceita se a
+//primeira amostra nova for contínua com a última salva (WINDOW_CHECKPOINT_MAX_STEP)
+
+#ifndef WINDOW_CHECKPOINT_MAX_GAP_PCT
+#define WINDOW_CHECKPOINT_MAX_GAP_PCT 150 //maior espaçamento aceito entre amostras da janela, % do intervalo
+#endif
+#ifndef WINDOW_CHECKPOINT_COLD_RESTORE
+#define WINDOW_CHECKPOINT_COLD_RESTORE 1  //0: após queda de energia sempre recomeça a janela
+#endif
+#ifndef WINDOW_CHECKPOINT_MAX_STEP
+#define WINDOW_CHECKPOINT_MAX_STEP {50, 500, 50, 50} //x100: 0,5 °C, 5 %RH, 0,5 °C, 0,5 hPa
+#endif
+
+typedef enum {
+    WINDOW_CHECKPOINT_EMPTY = 0, //log vazio ou sem registros válidos
+    WINDOW_CHECKPOINT_RESTORED,  //amostras devolvidas por window_checkpoint_restore
+    WINDOW_CHECKPOINT_STALE,     //reset a quente, mas a primeira amostra nova chegou tarde demais
+    WINDOW_CHECKPOINT_STEP,      //boot a frio e a amostra nova não continua a última salva
+    WINDOW_CHECKPOINT_COLD,      //boot a frio com WINDOW_CHECKPOINT_COLD_RESTORE=0
+} window_checkpoint_result_t;
+
+typedef struct {
+    bool warm;             //relógio recuperado dos registradores scratch (reset sem queda de energia)
+    uint8_t saved;         //amostras contíguas (seq e intervalo) no fim do log, até WINDOW_SIZE - 1
+    uint32_t records;      //registros válidos no log
+    int64_t age_ms;        //última amostra salva -> primeira nova (-1: desconhecida)
+    uint32_t writes;       //registros gravados desde o boot
+    uint32_t erases;       //setores apagados desde o boot
+    uint32_t last_write_us; //duração do último registro (inclui o apagamento, quando houve)
+} window_checkpoint_info_t;
+
+void window_checkpoint_init(uint32_t interval_ms); //lê o log e o relógio; chamar uma vez no boot
+uint64_t window_checkpoint_clock_ms(void);         //relógio persistente entre resets
+void window_checkpoint_heartbeat(void);            //grava o relógio nos scratch do watchdog (a cada volta do laço)
+uint32_t window_checkpoint_first_delay_ms(void);   //espera até a primeira amostra (mantém a cadência a quente)
+//uma vez, na primeira amostra após o boot: copia para saved as amostras a reinserir antes dela, em
+//ordem cronológica, e devolve quantas (0 se o checkpoint não vale; ver window_checkpoint_result)
+int window_checkpoint_restore(const sensor_counts_t* first, uint64_t t_ms, sensor_counts_t saved[WINDOW_SIZE - 1]);
+window_checkpoint_result_t window_checkpoint_result(void);
+int window_checkpoint_append(const sensor_counts_t* s, uint64_t t_ms); //grava a amostra; 0 se OK
+const window_checkpoint_info_t* window_checkpoint_info(void);
+
+#ifdef __cplusplus
+}
+#endif
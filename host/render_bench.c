@@ -0,0 +1,106 @@
+#include "ssd1306.h"
+#include "font.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+//benchmark do texto do display: desenha as linhas de previsão de main.c ("+10m: 23.45C") com o
+//blitter do atlas (ssd1306_draw_string) e com o desenho antigo pixel a pixel (referência abaixo,
+//cópia do ssd1306_draw_char original sobre font.h), confere que a GDDRAM resultante é idêntica e
+//imprime o tempo por linha. y=16 e y=40 são alinhados a página; y=28 exercita o caminho deslocado
+
+#define BENCH_VALUES 16
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+//desenho antigo: if-chain por caractere, rotação em tempo de execução e ssd1306_pixel por pixel
+static void legacy_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y) {
+    uint16_t index = 0;
+    bool rotate = false;
+    if (c == ' ') index = 0;
+    else if (c >= '0' && c <= '9') index = (c - '0' + 1) * 8;
+    else if (c >= 'A' && c <= 'Z') index = (c - 'A' + 11) * 8;
+    else if (c >= 'a' && c <= 'z') index = (c - 'a' + 37) * 8;
+    else if (c == ':') { index = 64 * 8; rotate = true; }
+    else if (c == '.') { index = 65 * 8; rotate = true; }
+    else if (c == '>') { index = 66 * 8; rotate = true; }
+    else if (c == '-') { index = 67 * 8; rotate = true; }
+    else if (c == 127) index = 68 * 8;
+    else if (c == '!') { index = 69 * 8; rotate = true; }
+    else if (c == '%') { index = 70 * 8; rotate = true; }
+    else if (c == '/') { index = 71 * 8; rotate = true; }
+    else return;
+    for (uint8_t i = 0; i < 8; ++i) {
+        uint8_t line = font[index + i];
+        for (uint8_t j = 0; j < 8; ++j)
+            ssd1306_pixel(ssd, x + (rotate ? (7 - j) : i), y + (rotate ? i : j), (line >> j) & 0x01);
+    }
+}
+
+static void legacy_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+    for (; *str; str++, x += 8) {
+        if (x + 8 > ssd->width) {
+            x = 0;
+            y += 8;
+            if (y + 8 > ssd->height) break;
+        }
+        legacy_draw_char(ssd, *str, x, y);
+    }
+}
+
+typedef void (*draw_fn)(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
+
+static void atlas_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y) {
+    ssd1306_draw_string(ssd, str, x, y, false);
+}
+
+static const uint8_t rows[3] = {16, 28, 40}; //linhas +5m, +10m e +15m de run_temperature_prediction()
+static const char *labels[3] = {"+5m:  ", "+10m: ", "+15m: "};
+static char lines[BENCH_VALUES][3][24];
+
+//desenha iters atualizações completas (3 linhas) e devolve ns por linha em cada y
+static void run(ssd1306_t *ssd, draw_fn draw, long iters, double ns_per_line[3]) {
+    for (int r = 0; r < 3; r++) {
+        uint64_t start = now_ns();
+        for (long i = 0; i < iters; i++)
+            draw(ssd, lines[i % BENCH_VALUES][r], 0, rows[r]);
+        ns_per_line[r] = (double)(now_ns() - start) / (double)iters;
+    }
+}
+
+int main(int argc, char **argv) {
+    long iters = argc > 1 ? atol(argv[1]) : 200000;
+    for (int v = 0; v < BENCH_VALUES; v++) //valores variados para que os dígitos mudem a cada linha
+        for (int r = 0; r < 3; r++)
+            snprintf(lines[v][r], sizeof(lines[v][r]), "%s%.2fC", labels[r], 18.5 + v * 1.37 + r * 0.11);
+
+    ssd1306_t atlas, legacy;
+    ssd1306_init(&atlas, 128, 64, false, 0x3C, i2c1);
+    ssd1306_init(&legacy, 128, 64, false, 0x3C, i2c1);
+
+    //mesma sequência nos dois caminhos: a GDDRAM deve ficar idêntica a cada passo
+    for (int v = 0; v < BENCH_VALUES; v++) {
+        for (int r = 0; r < 3; r++) {
+            atlas_draw_string(&atlas, lines[v][r], 0, rows[r]);
+            legacy_draw_string(&legacy, lines[v][r], 0, rows[r]);
+        }
+        if (memcmp(atlas.ram_buffer, legacy.ram_buffer, atlas.bufsize) != 0) {
+            fprintf(stderr, "[render] GDDRAM difere do desenho antigo em \"%s\"\n", lines[v][0]);
+            return 1;
+        }
+    }
+
+    double t_atlas[3], t_legacy[3];
+    run(&legacy, legacy_draw_string, iters, t_legacy);
+    run(&atlas, atlas_draw_string, iters, t_atlas);
+    printf("[render] \"%s\" e demais linhas de previsão, %ld repetições (GDDRAM idêntica)\n", lines[0][1], iters);
+    for (int r = 0; r < 3; r++)
+        printf("  y=%-2u (%s)  pixel a pixel %8.1f ns/linha  atlas %7.1f ns/linha  %5.1fx\n", rows[r],
+               rows[r] % 8 ? "deslocada" : "alinhada ", t_legacy[r], t_atlas[r], t_legacy[r] / t_atlas[r]);
+    return 0;
+}
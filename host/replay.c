@@ -0,0 +1,319 @@
+#include "fake_devices.h"
+#include "tflm_wrapper.h"
+#include "cycle_counter.h"
+#ifdef MODEL_CASCADE
+#include "model_cascade.h"
+#endif
+#include "pico/time.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+//replay de um CSV gravado (data/temp.csv) pelo pipeline real do firmware: o main.c sem modificação
+//lê os sensores falsos alimentados pelo roteiro (PICO_SHIM_SCRIPT), e o shim pula os 31 s entre
+//amostras. As chamadas ao motor são interceptadas com -Wl,--wrap e os eventos dos dispositivos
+//marcam os estágios; no fim, relatório de vazão, latência por estágio e MAE por horizonte. Com mais
+//de um modelo no registro (-DMODEL_REGISTRY="Conv1D;MLP"), cada janela também passa pelos outros
+//modelos (A/B sobre as mesmas entradas), fora dos tempos dos estágios. Com MODEL_CASCADE a previsão
+//do firmware é a da cascata, comparada com cada modelo sozinho nas mesmas janelas. A previsão é
+//atribuída à linha que fechou a janela
+
+#define REPLAY_HORIZONS 3
+static const int horizons[REPLAY_HORIZONS] = {10, 19, 29}; //HORIZONS do treino: amostras após a janela
+
+typedef struct {
+    uint64_t n, sum, min, max;
+} stage_stat_t;
+
+enum { STAGE_ACQUIRE, STAGE_PREPROCESS, STAGE_INFERENCE, STAGE_OUTPUT, STAGE_TOTAL, NUM_STAGES };
+static const char *stage_names[NUM_STAGES] = {
+    "aquisição (I2C + conversão)", "normalização + janela", "inferência", "saída (serial + display)", "total (disparo -> display)",
+};
+static stage_stat_t stages[NUM_STAGES];
+
+static uint64_t t_trigger, t_sensors, t_inference_end, t_output_end;
+static uint64_t inference_us;  //push incremental + invoke da janela vinculada
+static size_t collected_row;   //linha do roteiro da última coleta do AHT20
+static size_t window_row;      //linha que fechou a janela vinculada (alvo das previsões)
+static uint64_t window_trigger; //disparo da amostra que fechou a janela vinculada
+static uint64_t t_window;       //disparo da amostra que fechou a janela da predição atual
+static int predicted = 0;      //amostra atual já executou o invoke e aguarda o flush do display
+static uint64_t display_wire0; //bytes no fio do I2C1 antes do flush da amostra atual
+static uint64_t display_wire_sum = 0, display_updates = 0;
+static int sensors_seen = 0;   //bits: 1 = BMP280 lido, 2 = AHT20 coletado
+static size_t overlapped = 0;  //amostras em que o BMP280 foi lido durante a conversão do AHT20
+static size_t fresh = 0;       //predições no ciclo da amostra que fechou a janela (depois da coleta)
+static size_t acquired = 0;
+static float (*predictions)[REPLAY_HORIZONS] = NULL;
+static size_t num_predictions = 0;
+static float (*model_predictions[MODEL_REGISTRY_MAX])[REPLAY_HORIZONS]; //A/B: previsões de cada modelo
+static uint64_t model_invoke_us[MODEL_REGISTRY_MAX], model_invokes[MODEL_REGISTRY_MAX];
+static uint64_t model_cycles[MODEL_REGISTRY_MAX]; //ciclos (ns no host) só do invoke de cada modelo
+static uint32_t invoke_cycles = 0; //último invoke do firmware
+static int in_cascade = 0;         //invokes internos da cascata não são previsões
+static uint64_t shadow_us = 0; //tempo dos invokes de A/B na amostra atual (descontado do total)
+static uint64_t wall_start_ns = 0;
+
+static uint64_t wall_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static void stage_add(int stage, uint64_t us) {
+    stage_stat_t *s = &stages[stage];
+    if (s->n == 0 || us < s->min) s->min = us;
+    if (us > s->max) s->max = us;
+    s->sum += us;
+    s->n++;
+}
+
+//bytes no fio de um barramento: dados + um byte de endereço por transação
+static uint64_t bus_wire_bytes(int bus) {
+    const fake_bus_stats_t *s = fake_i2c_stats(bus);
+    return (uint64_t)s->bytes + s->transactions;
+}
+
+//fecha o estágio de saída da amostra anterior: o flush parcial pode ter zero ou várias transações de
+//dados, então o fim é o último evento do SSD1306 antes do próximo disparo do AHT20
+static void finish_output(void) {
+    if (!predicted) return;
+    stage_add(STAGE_OUTPUT, t_output_end - t_inference_end);
+    stage_add(STAGE_TOTAL, t_output_end - t_window - shadow_us);
+    display_wire_sum += bus_wire_bytes(1) - display_wire0;
+    display_updates++;
+    predicted = 0;
+}
+
+static void on_device_event(fake_event_t event, uint64_t t_us) {
+    switch (event) {
+    case FAKE_EVT_AHT20_TRIGGER:
+        if (!wall_start_ns) wall_start_ns = wall_ns();
+        finish_output();
+        t_trigger = t_us;
+        shadow_us = 0;
+        predicted = 0;
+        sensors_seen = 0;
+        break;
+    case FAKE_EVT_BMP280_DATA:
+    case FAKE_EVT_AHT20_DATA:
+        if (event == FAKE_EVT_AHT20_DATA && (sensors_seen & 1))
+            overlapped++; //BMP280 lido antes da coleta do AHT20, isto é, durante a conversão
+        if (event == FAKE_EVT_AHT20_DATA)
+            collected_row = fake_env_row_index();
+        sensors_seen |= event == FAKE_EVT_BMP280_DATA ? 1 : 2;
+        if (sensors_seen != 3) break;
+        t_sensors = t_us; //aquisição termina com o último dos dois sensores
+        stage_add(STAGE_ACQUIRE, t_sensors - t_trigger);
+        acquired++;
+        break;
+    case FAKE_EVT_SSD1306_DATA:
+        if (predicted) t_output_end = t_us; //flushes da inicialização são ignorados
+        break;
+    }
+}
+
+static void store_output(float (*dst)[REPLAY_HORIZONS], size_t row) {
+    int n;
+    const float *out = tflm_output_ptr(&n);
+    for (int h = 0; h < REPLAY_HORIZONS; h++)
+        dst[row][h] = h < n ? out[h] : NAN;
+}
+
+int __real_tflm_invoke(void);
+
+//A/B: os outros modelos do registro sobre a mesma janela vinculada; o ativo é restaurado e a saída
+//dele volta ao buffer lido pelo firmware
+static void shadow_models(size_t row) {
+    int active = tflm_active_model();
+    model_invoke_us[active] += tflm_last_invoke_us();
+    model_cycles[active] += invoke_cycles;
+    model_invokes[active]++;
+    store_output(model_predictions[active], row);
+    uint64_t start = time_us_64();
+    for (int m = 0; m < tflm_model_count(); m++) {
+        if (m == active || tflm_select_model(m) != 0) continue;
+        uint32_t c0 = cycle_counter_read();
+        if (__real_tflm_invoke() == 0) {
+            model_cycles[m] += cycle_counter_elapsed(c0, cycle_counter_read());
+            model_invoke_us[m] += tflm_last_invoke_us();
+            model_invokes[m]++;
+            store_output(model_predictions[m], row);
+        }
+    }
+    tflm_select_model(active);
+    float *out = tflm_output_ptr(NULL);
+    for (int h = 0; h < REPLAY_HORIZONS; h++)
+        out[h] = model_predictions[active][row][h];
+    shadow_us += time_us_64() - start;
+}
+
+//registra a saída do invoke para a linha do roteiro que fechou a janela
+static void record_prediction(uint64_t start, int rc) {
+    uint64_t end = time_us_64();
+    inference_us += end - start;
+    if (rc != 0) return;
+    stage_add(STAGE_INFERENCE, inference_us);
+    if (sensors_seen == 3 && window_trigger == t_trigger)
+        fresh++; //mesmo ciclo da coleta que fechou a janela, antes do próximo disparo
+    size_t row = window_row;
+    store_output(predictions, row);
+    num_predictions++;
+    if (tflm_model_count() > 1)
+        shadow_models(row);
+    t_window = window_trigger;
+    t_inference_end = t_output_end = time_us_64();
+    display_wire0 = bus_wire_bytes(1);
+    predicted = 1;
+}
+
+void __real_tflm_bind_input(const float *window);
+void __wrap_tflm_bind_input(const float *window) {
+    if (window) { //ingest_sensor_sample vinculou a janela da amostra recém-coletada
+        stage_add(STAGE_PREPROCESS, time_us_64() - t_sensors);
+        window_row = collected_row;
+        window_trigger = t_trigger;
+        inference_us = 0;
+    }
+    __real_tflm_bind_input(window);
+}
+
+int __wrap_tflm_invoke(void) {
+    uint64_t start = time_us_64();
+    uint32_t c0 = cycle_counter_read();
+    int rc = __real_tflm_invoke();
+    invoke_cycles = cycle_counter_elapsed(c0, cycle_counter_read());
+    if (!in_cascade) record_prediction(start, rc);
+    return rc;
+}
+
+#ifdef TFLM_STREAMING
+int __real_tflm_stream_push(const float *sample);
+int __wrap_tflm_stream_push(const float *sample) {
+    uint64_t start = time_us_64();
+    int rc = __real_tflm_stream_push(sample);
+    inference_us += time_us_64() - start;
+    return rc;
+}
+
+int __real_tflm_stream_invoke(void);
+int __wrap_tflm_stream_invoke(void) {
+    uint64_t start = time_us_64();
+    uint32_t c0 = cycle_counter_read();
+    int rc = __real_tflm_stream_invoke();
+    invoke_cycles = cycle_counter_elapsed(c0, cycle_counter_read());
+    if (!in_cascade) record_prediction(start, rc);
+    return rc;
+}
+#endif
+
+#ifdef MODEL_CASCADE
+//a previsão do firmware é a saída da cascata, com um ou dois invokes dentro
+int __real_model_cascade_invoke(const float *window, uint32_t seq);
+int __wrap_model_cascade_invoke(const float *window, uint32_t seq) {
+    uint64_t start = time_us_64();
+    in_cascade = 1;
+    int rc = __real_model_cascade_invoke(window, seq);
+    in_cascade = 0;
+    record_prediction(start, rc);
+    return rc;
+}
+#endif
+
+//MAE de um horizonte sobre as linhas com previsão; opcionalmente a persistência nas mesmas linhas
+static double horizon_mae(float (*pred)[REPLAY_HORIZONS], const fake_env_row_t *rows, size_t num_rows, int h,
+                          double *persist, size_t *count) {
+    double err = 0.0, err_persist = 0.0;
+    size_t n = 0;
+    for (size_t row = 0; row < num_rows; row++) {
+        size_t target = row + 1 + (size_t)horizons[h];
+        if (target >= num_rows || isnan(pred[row][h])) continue;
+        err += fabs(pred[row][h] - rows[target].temp_aht20);
+        err_persist += fabs(rows[row].temp_aht20 - rows[target].temp_aht20);
+        n++;
+    }
+    if (persist) *persist = n ? err_persist / n : 0.0;
+    if (count) *count = n;
+    return n ? err / n : 0.0;
+}
+
+static void replay_report(void) {
+    size_t num_rows;
+    const fake_env_row_t *rows = fake_env_rows(&num_rows);
+    double wall_s = wall_start_ns ? (wall_ns() - wall_start_ns) / 1e9 : 0.0;
+    finish_output();
+    fprintf(stderr, "\n[replay] %zu previsões em %.2f s de parede: %.0f previsões/s\n",
+            num_predictions, wall_s, wall_s > 0 ? num_predictions / wall_s : 0.0);
+    fprintf(stderr, "[replay] latência por estágio (us; tempo de CPU + I2C/conversão simulados):\n");
+    for (int i = 0; i < NUM_STAGES; i++) {
+        const stage_stat_t *s = &stages[i];
+        fprintf(stderr, "  %-28s n=%-7llu min=%-8llu média=%-10.1f máx=%llu\n", stage_names[i],
+                (unsigned long long)s->n, (unsigned long long)s->min,
+                s->n ? (double)s->sum / (double)s->n : 0.0, (unsigned long long)s->max);
+    }
+    fprintf(stderr, "[replay] display: %.1f bytes no fio do I2C1 por atualização (n=%llu)\n",
+            display_updates ? (double)display_wire_sum / (double)display_updates : 0.0,
+            (unsigned long long)display_updates);
+    fprintf(stderr, "[replay] BMP280 lido durante a conversão do AHT20 em %zu/%zu amostras\n", overlapped, acquired);
+    fprintf(stderr, "[replay] predição no ciclo da amostra que fechou a janela em %zu/%zu\n", fresh,
+            num_predictions);
+    //alvo do treino: janela termina na linha L -> alvo na linha L + 1 + h
+    fprintf(stderr, "[replay] MAE por horizonte contra os valores gravados (persistência = última leitura):\n");
+    for (int h = 0; h < REPLAY_HORIZONS; h++) {
+        double err_persist;
+        size_t n;
+        double mae = horizon_mae(predictions, rows, num_rows, h, &err_persist, &n);
+        fprintf(stderr, "  +%-2d amostras (%4.1f min): MAE %.4f °C  persistência %.4f °C  (n=%zu)\n",
+                horizons[h], horizons[h] * 31 / 60.0, mae, err_persist, n);
+    }
+    if (tflm_model_count() > 1) {
+        fprintf(stderr, "[replay] A/B dos modelos do registro sobre as mesmas janelas:\n");
+        for (int m = 0; m < tflm_model_count(); m++) {
+            const model_descriptor_t *d = tflm_model_info(m);
+            if (!model_invokes[m]) continue;
+            fprintf(stderr, "  %-8s invoke %7.1f us %8.0f ciclos  %5lu MACs  MAE", d->name,
+                    (double)model_invoke_us[m] / (double)model_invokes[m],
+                    (double)model_cycles[m] / (double)model_invokes[m], (unsigned long)d->macs);
+            for (int h = 0; h < REPLAY_HORIZONS; h++)
+                fprintf(stderr, " %.4f", horizon_mae(model_predictions[m], rows, num_rows, h, NULL, NULL));
+            fprintf(stderr, " °C  (n=%llu)\n", (unsigned long long)model_invokes[m]);
+            free(model_predictions[m]);
+        }
+#ifdef MODEL_CASCADE
+        //a cascata é a previsão do firmware (MAE principal acima); ciclos incluem os sinais e os dois invokes
+        const cascade_stats_t *c = model_cascade_stats();
+        double n = c->predictions ? (double)c->predictions : 1.0;
+        fprintf(stderr, "  %-8s %.1f%% escaladas para %s (variação %.1f%%, resíduo %.1f%%) %8.0f ciclos  %7.0f MACs  MAE",
+                "cascata", 100.0 * c->escalations / n, tflm_model_info(model_cascade_full())->name,
+                100.0 * c->by_slope / n, 100.0 * c->by_residual / n, (double)c->cycles / n, (double)c->macs / n);
+        for (int h = 0; h < REPLAY_HORIZONS; h++)
+            fprintf(stderr, " %.4f", horizon_mae(predictions, rows, num_rows, h, NULL, NULL));
+        fprintf(stderr, " °C  (n=%lu)\n", (unsigned long)c->predictions);
+#endif
+    }
+    free(predictions);
+}
+
+//roda antes do main() do firmware: carrega o roteiro e instala os observadores
+__attribute__((constructor)) static void replay_setup(void) {
+    const char *path = getenv("PICO_SHIM_SCRIPT");
+    if (!path || !fake_env_load_csv(path)) {
+        fprintf(stderr, "[replay] defina PICO_SHIM_SCRIPT com um CSV legível (ex.: data/temp.csv)\n");
+        exit(1);
+    }
+    size_t num_rows;
+    fake_env_rows(&num_rows);
+    predictions = malloc(num_rows * sizeof(*predictions));
+    for (size_t i = 0; i < num_rows; i++)
+        for (int h = 0; h < REPLAY_HORIZONS; h++)
+            predictions[i][h] = NAN;
+    for (int m = 0; m < tflm_model_count() && tflm_model_count() > 1; m++) {
+        model_predictions[m] = malloc(num_rows * sizeof(*predictions));
+        for (size_t i = 0; i < num_rows; i++)
+            for (int h = 0; h < REPLAY_HORIZONS; h++)
+                model_predictions[m][i][h] = NAN;
+    }
+    fake_devices_set_observer(on_device_event);
+    atexit(replay_report);
+}
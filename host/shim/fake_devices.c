@@ -0,0 +1,401 @@
+#include "fake_devices.h"
+#include "pico/time.h"
+#include "bmp280.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_SCRIPT_COLUMNS 32
+
+//roteiro de medições
+static fake_env_row_t default_row = {25.0f, 60.0f, 25.5f, 918.0f};
+static fake_env_row_t *rows = NULL;
+static size_t num_rows = 0;
+static size_t row_index = 0;       //próxima linha a ser servida
+static size_t samples_served = 0;
+static size_t max_samples = 30;    //limite quando não há roteiro (ou quando dado por PICO_SHIM_MAX_SAMPLES)
+static bool max_samples_set = false;
+static bool owns_rows = false;
+
+static fake_bus_stats_t bus_stats[2];
+static bool trace = false;
+static bool show_display = false;
+static bool present_aht20 = true, present_bmp280 = true, present_ssd1306 = true;
+static fake_observer_t observer = NULL;
+static int pending_event = -1; //entregue em fake_i2c_complete(), depois do tempo de fio
+
+static void notify(fake_event_t event) {
+    pending_event = (int)event;
+}
+
+int fake_i2c_take_event(void) {
+    int event = pending_event;
+    pending_event = -1;
+    return event;
+}
+
+void fake_i2c_deliver(int event, uint64_t t_us) {
+    if (event >= 0 && observer) observer((fake_event_t)event, t_us);
+}
+
+void fake_i2c_complete(void) {
+    fake_i2c_deliver(fake_i2c_take_event(), time_us_64());
+}
+
+static const fake_env_row_t *current_row(void) {
+    if (!num_rows) return &default_row;
+    return &rows[row_index ? row_index - 1 : 0];
+}
+
+//avança o roteiro a cada disparo de medição; fim do roteiro encerra a simulação
+static void next_sample(void) {
+    if ((num_rows && row_index >= num_rows) ||
+        ((!num_rows || max_samples_set) && max_samples && samples_served >= max_samples)) {
+        shim_drain_cores(); //core1 termina as amostras já publicadas
+        fprintf(stderr, "[shim] fim do roteiro após %zu amostras\n", samples_served);
+        exit(0);
+    }
+    if (num_rows) row_index++;
+    samples_served++;
+}
+
+/* ---------------------------------------------------------------- AHT20 */
+
+static uint32_t aht20_measure_us = 80000;
+static uint64_t aht20_ready_us = 0;
+static uint8_t aht20_data[6] = {0x18, 0, 0, 0, 0, 0}; //calibrado (0x08) + bit 4 de fábrica
+
+static void aht20_latch(const fake_env_row_t *r) {
+    double h = r->hum_aht20, t = r->temp_aht20;
+    if (h < 0) h = 0;
+    if (h > 100) h = 100;
+    uint32_t raw_h = (uint32_t)lround(h * 1048576.0 / 100.0);
+    uint32_t raw_t = (uint32_t)lround((t + 50.0) * 1048576.0 / 200.0);
+    if (raw_h > 0xFFFFF) raw_h = 0xFFFFF;
+    if (raw_t > 0xFFFFF) raw_t = 0xFFFFF;
+    aht20_data[1] = (uint8_t)(raw_h >> 12);
+    aht20_data[2] = (uint8_t)(raw_h >> 4);
+    aht20_data[3] = (uint8_t)(((raw_h & 0x0F) << 4) | (raw_t >> 16));
+    aht20_data[4] = (uint8_t)(raw_t >> 8);
+    aht20_data[5] = (uint8_t)raw_t;
+}
+
+static int aht20_write(const uint8_t *src, size_t len) {
+    if (len >= 1 && src[0] == 0xAC) { //disparo de medição
+        next_sample();
+        aht20_latch(current_row());
+        aht20_ready_us = time_us_64() + aht20_measure_us;
+        notify(FAKE_EVT_AHT20_TRIGGER);
+    } else if (len >= 1 && src[0] == 0xBA) { //soft reset
+        aht20_ready_us = time_us_64() + 20000;
+    }
+    return (int)len;
+}
+
+static int aht20_read(uint8_t *dst, size_t len) {
+    uint8_t status = 0x18;
+    if (time_us_64() < aht20_ready_us) status |= 0x80; //ocupado
+    for (size_t i = 0; i < len; i++)
+        dst[i] = i == 0 ? status : (i < 6 ? aht20_data[i] : 0xFF);
+    if (len >= 6) notify(FAKE_EVT_AHT20_DATA);
+    return (int)len;
+}
+
+/* --------------------------------------------------------------- BMP280 */
+
+//parâmetros de calibração do exemplo do datasheet (seção 8.1)
+static struct bmp280_calib_param bmp_calib = {
+    27504, 26435, -1000, 36477, -10685, 3024, 2855, 140, -7, 15500, -14600, 6000
+};
+static uint8_t bmp_regs[256];
+static uint8_t bmp_pointer = 0;
+
+//inverte a compensação do driver por busca binária para achar os valores brutos (20 bits)
+static int32_t bmp280_raw_temp(float celsius) {
+    int32_t target = (int32_t)lroundf(celsius * 100.0f), lo = 0, hi = 0xFFFFF;
+    while (lo < hi) { //convert_temp é crescente no valor bruto
+        int32_t mid = (lo + hi) / 2;
+        if (bmp280_convert_temp(mid, &bmp_calib) < target) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static int32_t bmp280_raw_pressure(float hpa, int32_t raw_temp) {
+    int32_t target = (int32_t)lroundf(hpa * 100.0f), lo = 0, hi = 0xFFFFF;
+    while (lo < hi) { //convert_pressure é decrescente no valor bruto
+        int32_t mid = (lo + hi) / 2;
+        if (bmp280_convert_pressure(mid, raw_temp, &bmp_calib) > target) lo = mid + 1; else hi = mid;
+    }
+    return lo;
+}
+
+static void bmp280_reset_regs(void) {
+    memset(bmp_regs, 0, sizeof(bmp_regs));
+    const uint16_t calib[12] = {
+        bmp_calib.dig_t1, (uint16_t)bmp_calib.dig_t2, (uint16_t)bmp_calib.dig_t3,
+        bmp_calib.dig_p1, (uint16_t)bmp_calib.dig_p2, (uint16_t)bmp_calib.dig_p3,
+        (uint16_t)bmp_calib.dig_p4, (uint16_t)bmp_calib.dig_p5, (uint16_t)bmp_calib.dig_p6,
+        (uint16_t)bmp_calib.dig_p7, (uint16_t)bmp_calib.dig_p8, (uint16_t)bmp_calib.dig_p9,
+    };
+    for (int i = 0; i < 12; i++) { //little-endian a partir de 0x88
+        bmp_regs[0x88 + 2 * i] = (uint8_t)calib[i];
+        bmp_regs[0x89 + 2 * i] = (uint8_t)(calib[i] >> 8);
+    }
+    bmp_regs[0xD0] = 0x58; //chip id
+}
+
+static void bmp280_update_data(void) {
+    const fake_env_row_t *r = current_row();
+    int32_t raw_t = bmp280_raw_temp(r->temp_bmp280);
+    int32_t raw_p = bmp280_raw_pressure(r->press_bmp280, raw_t);
+    bmp_regs[0xF7] = (uint8_t)(raw_p >> 12);
+    bmp_regs[0xF8] = (uint8_t)(raw_p >> 4);
+    bmp_regs[0xF9] = (uint8_t)((raw_p & 0x0F) << 4);
+    bmp_regs[0xFA] = (uint8_t)(raw_t >> 12);
+    bmp_regs[0xFB] = (uint8_t)(raw_t >> 4);
+    bmp_regs[0xFC] = (uint8_t)((raw_t & 0x0F) << 4);
+}
+
+static int bmp280_write(const uint8_t *src, size_t len) {
+    if (len == 0) return 0;
+    bmp_pointer = src[0];
+    for (size_t i = 0; i + 1 < len; i += 2) { //escrita em pares registrador/valor
+        if (src[i] == 0xE0 && src[i + 1] == 0xB6) bmp280_reset_regs();
+        else bmp_regs[src[i]] = src[i + 1];
+    }
+    return (int)len;
+}
+
+static int bmp280_read(uint8_t *dst, size_t len) {
+    bool data = bmp_pointer <= 0xFC && bmp_pointer + len > 0xF7;
+    if (data) bmp280_update_data();
+    for (size_t i = 0; i < len; i++) //auto-incremento do ponteiro de registrador
+        dst[i] = bmp_regs[(uint8_t)(bmp_pointer + i)];
+    if (data) notify(FAKE_EVT_BMP280_DATA);
+    return (int)len;
+}
+
+/* -------------------------------------------------------------- SSD1306 */
+
+static uint8_t gddram[FAKE_SSD1306_PAGES][FAKE_SSD1306_WIDTH];
+static uint8_t ssd_col = 0, ssd_page = 0;
+static uint8_t ssd_col_start = 0, ssd_col_end = FAKE_SSD1306_WIDTH - 1;
+static uint8_t ssd_page_start = 0, ssd_page_end = FAKE_SSD1306_PAGES - 1;
+static uint8_t ssd_pending_cmd = 0; //comando aguardando argumentos (persiste entre transações)
+static int ssd_pending_args = 0, ssd_arg_index = 0;
+
+static int ssd1306_cmd_args(uint8_t cmd) {
+    switch (cmd) {
+    case 0x21: case 0x22: return 2; //janela de colunas / páginas
+    case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3:
+    case 0xD5: case 0xD9: case 0xDA: case 0xDB: return 1;
+    default: return 0;
+    }
+}
+
+static void ssd1306_command(uint8_t byte) {
+    if (ssd_pending_args) {
+        if (ssd_pending_cmd == 0x21) {
+            if (ssd_arg_index == 0) ssd_col_start = ssd_col = byte & 0x7F;
+            else ssd_col_end = byte & 0x7F;
+        } else if (ssd_pending_cmd == 0x22) {
+            if (ssd_arg_index == 0) ssd_page_start = ssd_page = byte & 0x07;
+            else ssd_page_end = byte & 0x07;
+        }
+        ssd_arg_index++;
+        ssd_pending_args--;
+        return;
+    }
+    ssd_pending_cmd = byte;
+    ssd_pending_args = ssd1306_cmd_args(byte);
+    ssd_arg_index = 0;
+}
+
+static void ssd1306_data(uint8_t byte) { //endereçamento horizontal dentro da janela
+    gddram[ssd_page][ssd_col] = byte;
+    if (ssd_col++ >= ssd_col_end) {
+        ssd_col = ssd_col_start;
+        ssd_page = ssd_page >= ssd_page_end ? ssd_page_start : ssd_page + 1;
+    }
+}
+
+static int ssd1306_write(const uint8_t *src, size_t len) {
+    bool data = false;
+    size_t i = 0;
+    while (i < len) { //byte de controle: Co (só o próximo byte) e D/C#
+        uint8_t control = src[i++];
+        bool is_data = (control & 0x40) != 0;
+        size_t end = (control & 0x80) ? (i < len ? i + 1 : len) : len;
+        for (; i < end; i++) {
+            if (is_data) ssd1306_data(src[i]);
+            else ssd1306_command(src[i]);
+        }
+        data |= is_data;
+    }
+    if (data) notify(FAKE_EVT_SSD1306_DATA);
+    return (int)len;
+}
+
+/* ------------------------------------------------------------ barramento */
+
+static void trace_transaction(int bus, uint8_t addr, char dir, size_t len, const uint8_t *buf, int ret) {
+    if (!trace) return;
+    fprintf(stderr, "[i2c%d] %10llu us 0x%02X %c %3zu", bus, (unsigned long long)time_us_64(), addr, dir, len);
+    for (size_t i = 0; i < len && i < 8 && ret >= 0; i++) fprintf(stderr, " %02X", buf[i]);
+    fprintf(stderr, "%s%s\n", len > 8 && ret >= 0 ? " ..." : "", ret < 0 ? " NACK" : "");
+}
+
+static int account(int bus, uint8_t addr, char dir, size_t len, const uint8_t *buf, int ret) {
+    fake_bus_stats_t *s = &bus_stats[bus & 1];
+    s->transactions++;
+    if (ret < 0) s->nacks++;
+    else s->bytes += (uint32_t)len;
+    trace_transaction(bus, addr, dir, len, buf, ret);
+    return ret;
+}
+
+int fake_i2c_write(int bus, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    (void)nostop;
+    int ret = PICO_ERROR_GENERIC;
+    if (bus == 0 && addr == FAKE_AHT20_ADDR && present_aht20) ret = aht20_write(src, len);
+    else if (bus == 0 && addr == FAKE_BMP280_ADDR && present_bmp280) ret = bmp280_write(src, len);
+    else if (bus == 1 && addr == FAKE_SSD1306_ADDR && present_ssd1306) ret = ssd1306_write(src, len);
+    return account(bus, addr, 'W', len, src, ret);
+}
+
+int fake_i2c_read(int bus, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    (void)nostop;
+    int ret = PICO_ERROR_GENERIC;
+    if (bus == 0 && addr == FAKE_AHT20_ADDR && present_aht20) ret = aht20_read(dst, len);
+    else if (bus == 0 && addr == FAKE_BMP280_ADDR && present_bmp280) ret = bmp280_read(dst, len);
+    return account(bus, addr, 'R', len, dst, ret);
+}
+
+/* --------------------------------------------------------------- roteiro */
+
+static bool parse_float(const char *s, float *out) {
+    char *end;
+    float v = strtof(s, &end);
+    if (end == s) return false;
+    *out = v;
+    return true;
+}
+
+bool fake_env_load_csv(const char *path) {
+    static const char *names[4] = {"Temp_AHT20_C", "Umid_AHT20_pct", "Temp_BMP280_C", "Press_BMP280_hPa"};
+    FILE *f = fopen(path, "r");
+    if (!f) return false;
+    char line[1024];
+    int col_of[4] = {-1, -1, -1, -1};
+    size_t cap = 0, n = 0;
+    fake_env_row_t *buf = NULL;
+    bool header_seen = false;
+    while (fgets(line, sizeof(line), f)) {
+        char *fields[MAX_SCRIPT_COLUMNS];
+        int nf = 0;
+        for (char *tok = strtok(line, ",\r\n"); tok && nf < MAX_SCRIPT_COLUMNS; tok = strtok(NULL, ",\r\n"))
+            fields[nf++] = tok;
+        if (nf == 0) continue;
+        float tmp;
+        if (!header_seen && !parse_float(fields[nf - 1], &tmp)) { //cabeçalho: localiza as colunas pelo nome
+            header_seen = true;
+            for (int k = 0; k < 4; k++)
+                for (int i = 0; i < nf; i++)
+                    if (strcmp(fields[i], names[k]) == 0) col_of[k] = i;
+            continue;
+        }
+        header_seen = true;
+        if (col_of[0] < 0) { //sem cabeçalho reconhecido: 4 primeiras colunas numéricas
+            for (int i = 0, k = 0; i < nf && k < 4; i++)
+                if (parse_float(fields[i], &tmp)) col_of[k++] = i;
+        }
+        float v[4];
+        bool ok = true;
+        for (int k = 0; k < 4; k++)
+            ok = ok && col_of[k] >= 0 && col_of[k] < nf && parse_float(fields[col_of[k]], &v[k]);
+        if (!ok) continue; //linha incompleta no log: ignorada
+        if (n == cap) {
+            cap = cap ? cap * 2 : 1024;
+            buf = realloc(buf, cap * sizeof(*buf));
+        }
+        buf[n++] = (fake_env_row_t){v[0], v[1], v[2], v[3]};
+    }
+    fclose(f);
+    if (!n) {
+        free(buf);
+        return false;
+    }
+    if (owns_rows) free(rows);
+    rows = buf;
+    num_rows = n;
+    row_index = 0;
+    owns_rows = true;
+    return true;
+}
+
+void fake_env_set_rows(const fake_env_row_t *r, size_t count) {
+    if (owns_rows) free(rows);
+    rows = (fake_env_row_t *)r;
+    num_rows = count;
+    row_index = 0;
+    owns_rows = false;
+}
+
+const fake_env_row_t *fake_env_rows(size_t *count) {
+    if (count) *count = num_rows;
+    return rows;
+}
+
+void fake_devices_set_observer(fake_observer_t cb) { observer = cb; }
+
+size_t fake_env_row_index(void) { return row_index ? row_index - 1 : 0; }
+void fake_env_set_max_samples(size_t n) { max_samples = n; }
+
+void fake_device_set_present(uint8_t addr, bool present) {
+    if (addr == FAKE_AHT20_ADDR) present_aht20 = present;
+    else if (addr == FAKE_BMP280_ADDR) present_bmp280 = present;
+    else if (addr == FAKE_SSD1306_ADDR) present_ssd1306 = present;
+}
+
+void fake_aht20_set_measure_us(uint32_t us) { aht20_measure_us = us; }
+
+const fake_bus_stats_t *fake_i2c_stats(int bus) { return &bus_stats[bus & 1]; }
+const uint8_t *fake_ssd1306_gddram(void) { return &gddram[0][0]; }
+
+void fake_ssd1306_print(FILE *out) {
+    for (int y = 0; y < FAKE_SSD1306_PAGES * 8; y++) {
+        for (int x = 0; x < FAKE_SSD1306_WIDTH; x++)
+            fputc(gddram[y / 8][x] & (1u << (y % 8)) ? '#' : '.', out);
+        fputc('\n', out);
+    }
+}
+
+void fake_devices_init(void) {
+    const char *env;
+    trace = (env = getenv("PICO_SHIM_TRACE_I2C")) && env[0] == '1';
+    show_display = (env = getenv("PICO_SHIM_DISPLAY")) && env[0] == '1';
+    if ((env = getenv("PICO_SHIM_MAX_SAMPLES"))) {
+        max_samples = (size_t)strtoul(env, NULL, 10);
+        max_samples_set = true;
+    }
+    if (!num_rows && (env = getenv("PICO_SHIM_SCRIPT")) && env[0]) { //roteiro ainda não carregado em código
+        if (!fake_env_load_csv(env)) {
+            fprintf(stderr, "[shim] roteiro %s não pôde ser lido\n", env);
+            exit(1);
+        }
+        fprintf(stderr, "[shim] roteiro %s: %zu linhas\n", env, num_rows);
+    }
+    if (num_rows && (env = getenv("PICO_SHIM_SCRIPT_START"))) { //continua um roteiro (ex.: após um reboot)
+        row_index = (size_t)strtoul(env, NULL, 10);
+        if (row_index > num_rows) row_index = num_rows;
+    }
+    bmp280_reset_regs();
+}
+
+void fake_devices_report(FILE *out) {
+    fprintf(out, "[shim] tempo virtual: %.1f s, amostras: %zu\n", time_us_64() / 1e6, samples_served);
+    for (int b = 0; b < 2; b++)
+        fprintf(out, "[shim] i2c%d: %u transações, %u bytes, %u NACKs\n", b,
+                bus_stats[b].transactions, bus_stats[b].bytes, bus_stats[b].nacks);
+    if (show_display) fake_ssd1306_print(out);
+}
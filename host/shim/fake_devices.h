@@ -0,0 +1,95 @@
+#ifndef FAKE_DEVICES_H
+#define FAKE_DEVICES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+//dispositivos I2C falsos do build host: AHT20 (0x38), BMP280 (0x76) e SSD1306 (0x3C).
+//Os valores medidos vêm de um roteiro: PICO_SHIM_SCRIPT=<csv> com as colunas do dataset
+//(Temp_AHT20_C, Umid_AHT20_pct, Temp_BMP280_C, Press_BMP280_hPa) ou as 4 primeiras colunas
+//numéricas. Cada disparo de medição do AHT20 avança uma linha; quando o roteiro acaba o
+//processo termina com o relatório do shim. Sem roteiro, os valores são constantes e o
+//processo termina após PICO_SHIM_MAX_SAMPLES amostras (padrão 30); com roteiro, a variável
+//também limita as amostras e PICO_SHIM_SCRIPT_START=<linha> começa no meio do roteiro.
+//PICO_SHIM_TRACE_I2C=1 imprime cada transação em stderr; PICO_SHIM_DISPLAY=1 desenha o
+//conteúdo final do SSD1306 no relatório; PICO_SHIM_QUIET=1 descarta o stdout do firmware (as
+//mensagens do shim vão para stderr).
+
+#define FAKE_AHT20_ADDR   0x38
+#define FAKE_BMP280_ADDR  0x76
+#define FAKE_SSD1306_ADDR 0x3C
+
+#define FAKE_SSD1306_WIDTH  128
+#define FAKE_SSD1306_PAGES  8
+
+typedef struct {
+    float temp_aht20;   //°C
+    float hum_aht20;    //%RH
+    float temp_bmp280;  //°C
+    float press_bmp280; //hPa
+} fake_env_row_t;
+
+typedef struct {
+    uint32_t transactions;
+    uint32_t bytes;         //bytes de dados (sem o byte de endereço)
+    uint32_t nacks;
+} fake_bus_stats_t;
+
+struct i2c_inst;
+struct uart_inst;
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void fake_devices_init(void);           //lê as variáveis de ambiente (chamado por stdio_init_all)
+void fake_devices_report(FILE *out);    //tempo virtual, tráfego I2C por barramento e display
+
+//roteiro de medições: também pode ser montado em código antes de stdio_init_all()
+bool fake_env_load_csv(const char *path);
+void fake_env_set_rows(const fake_env_row_t *rows, size_t count);
+size_t fake_env_row_index(void);        //linha servida pelo último disparo do AHT20
+void fake_env_set_max_samples(size_t n);
+
+//comportamento dos dispositivos
+void fake_device_set_present(uint8_t addr, bool present); //ausente -> NACK no endereço
+void fake_aht20_set_measure_us(uint32_t us);               //tempo de conversão (padrão 80 ms)
+
+//eventos dos dispositivos, para medir estágios do pipeline (ex.: host/replay.c)
+typedef enum {
+    FAKE_EVT_AHT20_TRIGGER, //início de uma amostra (linha do roteiro já avançada)
+    FAKE_EVT_BMP280_DATA,   //leitura dos registradores de medição do BMP280
+    FAKE_EVT_AHT20_DATA,    //leitura do resultado (6 bytes) do AHT20
+    FAKE_EVT_SSD1306_DATA,  //escrita de dados na GDDRAM (flush do display)
+} fake_event_t;
+typedef void (*fake_observer_t)(fake_event_t event, uint64_t t_us);
+void fake_devices_set_observer(fake_observer_t observer);
+
+//inspeção
+const fake_env_row_t *fake_env_rows(size_t *count);
+const fake_bus_stats_t *fake_i2c_stats(int bus);
+const uint8_t *fake_ssd1306_gddram(void);                  //[FAKE_SSD1306_PAGES][FAKE_SSD1306_WIDTH]
+void fake_ssd1306_print(FILE *out);
+
+//pontos de entrada usados pelo shim de hardware/i2c.h
+int fake_i2c_write(int bus, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int fake_i2c_read(int bus, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+void fake_i2c_complete(void); //fim da transação no fio: entrega o evento pendente ao observador
+int  fake_i2c_take_event(void);                 //evento gerado pela última transação (-1 se nenhum)
+void fake_i2c_deliver(int event, uint64_t t_us); //entrega adiada (modelo de DMA)
+
+//relógio virtual (pico_shim.c): avança o tempo; espera o outro núcleo esvaziar o trabalho pendente
+void shim_advance_us(uint64_t us);
+void shim_drain_cores(void);
+uint64_t shim_i2c_wire_us(const struct i2c_inst *i2c, size_t len); //tempo de fio de uma transação
+unsigned shim_uart_baud(const struct uart_inst *uart); //baudrate da UART no clk_peri atual
+extern void (*shim_irq_hook)(void); //chamado em sleeps e __wfe, onde IRQs seriam atendidos
+void shim_flash_init(void); //flash_shim.c: carrega PICO_SHIM_FLASH e os scratch do watchdog
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif //FAKE_DEVICES_H
@@ -0,0 +1,82 @@
+#include "hardware/flash.h"
+#include "hardware/watchdog.h"
+#include "fake_devices.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+//flash e scratch do watchdog do shim. Cada execução do binário é um boot: com PICO_SHIM_FLASH=<arquivo>
+//o conteúdo da flash é carregado no início e cada apagamento/gravação é escrito de volta no arquivo;
+//os scratch vão para <arquivo>.scratch na saída e só voltam com PICO_SHIM_WARM_BOOT=1 (reset por
+//watchdog). Apagar um setor e gravar uma página avançam o relógio virtual pelos tempos típicos da
+//W25Q16 da placa, com a CPU parada como no RP2040 (XIP desligado durante a operação)
+
+#define SHIM_FLASH_ERASE_US   45000
+#define SHIM_FLASH_PROGRAM_US 700
+
+uint8_t shim_flash[PICO_FLASH_SIZE_BYTES];
+watchdog_hw_t shim_watchdog;
+
+static FILE *flash_file = NULL;
+static char scratch_path[512];
+
+static void sync_range(uint32_t offs, size_t count) {
+    if (!flash_file) return;
+    fseek(flash_file, (long)offs, SEEK_SET);
+    fwrite(&shim_flash[offs], 1, count, flash_file);
+    fflush(flash_file);
+}
+
+static void save_scratch(void) {
+    FILE *f = fopen(scratch_path, "wb");
+    if (!f) return;
+    fwrite((const void *)shim_watchdog.scratch, sizeof(shim_watchdog.scratch), 1, f);
+    fclose(f);
+}
+
+void shim_flash_init(void) {
+    memset(shim_flash, 0xFF, sizeof(shim_flash));
+    const char *path = getenv("PICO_SHIM_FLASH");
+    if (!path || !path[0]) return;
+    flash_file = fopen(path, "r+b");
+    if (flash_file) {
+        if (fread(shim_flash, 1, sizeof(shim_flash), flash_file) != sizeof(shim_flash))
+            fprintf(stderr, "[shim] flash %s incompleta: resto apagado\n", path);
+    } else if ((flash_file = fopen(path, "w+b"))) {
+        sync_range(0, sizeof(shim_flash)); //flash nova, toda apagada
+    } else {
+        fprintf(stderr, "[shim] flash %s não pôde ser aberta\n", path);
+        exit(1);
+    }
+    snprintf(scratch_path, sizeof(scratch_path), "%s.scratch", path);
+    const char *warm = getenv("PICO_SHIM_WARM_BOOT");
+    FILE *f;
+    if (warm && warm[0] == '1' && (f = fopen(scratch_path, "rb"))) {
+        if (fread((void *)shim_watchdog.scratch, sizeof(shim_watchdog.scratch), 1, f) != 1)
+            memset((void *)shim_watchdog.scratch, 0, sizeof(shim_watchdog.scratch));
+        fclose(f);
+    }
+    atexit(save_scratch);
+}
+
+static void check_range(uint32_t offs, size_t count, uint32_t align) {
+    if (offs % align || count % align || offs + count > PICO_FLASH_SIZE_BYTES) {
+        fprintf(stderr, "[shim] operação de flash inválida: offset 0x%x, %zu bytes\n", offs, count);
+        abort();
+    }
+}
+
+void flash_range_erase(uint32_t flash_offs, size_t count) {
+    check_range(flash_offs, count, FLASH_SECTOR_SIZE);
+    memset(&shim_flash[flash_offs], 0xFF, count);
+    sync_range(flash_offs, count);
+    shim_advance_us(SHIM_FLASH_ERASE_US * (count / FLASH_SECTOR_SIZE));
+}
+
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count) {
+    check_range(flash_offs, count, FLASH_PAGE_SIZE);
+    for (size_t i = 0; i < count; i++)
+        shim_flash[flash_offs + i] &= data[i]; //NOR: gravar só leva bits de 1 para 0
+    sync_range(flash_offs, count);
+    shim_advance_us(SHIM_FLASH_PROGRAM_US * (count / FLASH_PAGE_SIZE));
+}
@@ -0,0 +1,128 @@
+#include "i2c_dma.h"
+#include "fake_devices.h"
+#include "pico/time.h"
+#include <pthread.h>
+
+//modelo host do I2C_DMA: a transação é aplicada aos dispositivos falsos na submissão, mas resultado,
+//callback e evento do dispositivo só são entregues quando o relógio virtual passa do fim do tempo de
+//fio (fila serial por barramento), nos pontos em que o firmware atenderia o IRQ: chamadas i2c_dma_*,
+//sleeps e __wfe. Ao contrário do shim bloqueante, o tempo de fio não é cobrado da CPU
+
+typedef struct {
+    i2c_dma_xfer_t *xfer;
+    uint64_t done_at;
+    int result;
+    int event;
+} pending_xfer_t;
+
+typedef struct {
+    pending_xfer_t queue[I2C_DMA_QUEUE_LEN];
+    uint32_t head, tail;
+    uint64_t free_at; //fim da última transação enfileirada
+} dma_bus_t;
+
+static dma_bus_t buses[2];
+static pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t total_cpu_us = 0;
+
+static void deliver_due(void) {
+    for (int b = 0; b < 2; b++) {
+        while (1) {
+            pthread_mutex_lock(&lock);
+            dma_bus_t *bus = &buses[b];
+            if (bus->head == bus->tail || bus->queue[bus->tail % I2C_DMA_QUEUE_LEN].done_at > time_us_64()) {
+                pthread_mutex_unlock(&lock);
+                break;
+            }
+            pending_xfer_t p = bus->queue[bus->tail % I2C_DMA_QUEUE_LEN];
+            bus->tail++;
+            pthread_mutex_unlock(&lock);
+            fake_i2c_deliver(p.event, p.done_at); //callback fora do lock: pode submeter outra transação
+            p.xfer->result = p.result;
+            if (p.xfer->callback) p.xfer->callback(p.xfer);
+        }
+    }
+}
+
+int i2c_dma_init(i2c_inst_t *i2c) {
+    (void)i2c;
+    shim_irq_hook = deliver_due;
+    return 0;
+}
+
+int i2c_dma_submit(i2c_dma_xfer_t *x) {
+    if (x->tx_len + x->rx_len == 0 || x->tx_len + x->rx_len > I2C_DMA_MAX_BYTES) return -1;
+    deliver_due();
+    uint64_t start = time_us_64();
+    pthread_mutex_lock(&lock);
+    dma_bus_t *bus = &buses[x->i2c->index & 1];
+    if (bus->head - bus->tail == I2C_DMA_QUEUE_LEN) {
+        pthread_mutex_unlock(&lock);
+        return -1;
+    }
+    x->result = I2C_DMA_PENDING;
+    int result = 0;
+    if (x->tx_len)
+        result = fake_i2c_write(x->i2c->index, x->addr, x->tx, x->tx_len, x->rx_len != 0);
+    if (result >= 0 && x->rx_len)
+        result = fake_i2c_read(x->i2c->index, x->addr, x->rx, x->rx_len, false);
+    uint64_t wire = shim_i2c_wire_us(x->i2c, result < 0 ? 0 : x->tx_len);
+    if (result >= 0 && x->rx_len) wire += shim_i2c_wire_us(x->i2c, x->rx_len);
+    uint64_t begin = bus->free_at > start ? bus->free_at : start;
+    pending_xfer_t *p = &bus->queue[bus->head % I2C_DMA_QUEUE_LEN];
+    p->xfer = x;
+    p->done_at = bus->free_at = begin + wire;
+    p->result = result < 0 ? PICO_ERROR_GENERIC : (int)(x->rx_len ? x->rx_len : x->tx_len);
+    p->event = fake_i2c_take_event();
+    bus->head++;
+    x->cpu_us = (uint32_t)(time_us_64() - start); //só a montagem; o fio corre em paralelo
+    total_cpu_us += x->cpu_us;
+    pthread_mutex_unlock(&lock);
+    return 0;
+}
+
+int i2c_dma_wait(i2c_dma_xfer_t *x) {
+    while (x->result == I2C_DMA_PENDING) {
+        uint64_t done_at = time_us_64();
+        pthread_mutex_lock(&lock);
+        dma_bus_t *bus = &buses[x->i2c->index & 1];
+        for (uint32_t i = bus->tail; i != bus->head; i++)
+            if (bus->queue[i % I2C_DMA_QUEUE_LEN].xfer == x) done_at = bus->queue[i % I2C_DMA_QUEUE_LEN].done_at;
+        pthread_mutex_unlock(&lock);
+        sleep_until(done_at); //CPU ociosa (__wfe) até o IRQ de conclusão
+        deliver_due();
+    }
+    return x->result;
+}
+
+bool i2c_dma_idle(i2c_inst_t *i2c) {
+    deliver_due();
+    pthread_mutex_lock(&lock);
+    bool idle = buses[i2c->index & 1].head == buses[i2c->index & 1].tail;
+    pthread_mutex_unlock(&lock);
+    return idle;
+}
+
+uint32_t i2c_dma_cpu_us(void) {
+    return total_cpu_us;
+}
+
+static int transfer_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t src_len,
+                             uint8_t *dst, size_t dst_len) {
+    i2c_dma_xfer_t x = {i2c, addr, src, src_len, dst, dst_len, NULL, NULL, I2C_DMA_PENDING, 0};
+    if (i2c_dma_submit(&x) != 0) return PICO_ERROR_GENERIC;
+    return i2c_dma_wait(&x);
+}
+
+int i2c_dma_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len) {
+    return transfer_blocking(i2c, addr, src, len, NULL, 0);
+}
+
+int i2c_dma_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len) {
+    return transfer_blocking(i2c, addr, NULL, 0, dst, len);
+}
+
+int i2c_dma_write_read_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t src_len,
+                                uint8_t *dst, size_t dst_len) {
+    return transfer_blocking(i2c, addr, src, src_len, dst, dst_len);
+}
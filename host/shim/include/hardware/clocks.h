@@ -0,0 +1,39 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//clocks do RP2040: só as frequências e as fontes que as propagam são registradas. O clk_sys pode vir
+//do pll_sys (que precisa estar ligado), e o clk_peri no clk_sys (como o clocks_init do SDK o deixa)
+//segue cada troca do clk_sys. clk_sys escala o tempo de fio do I2C quando o baudrate foi calculado
+//para outro clk_sys (como o divisor real), clk_peri escala o baudrate da UART do stdio, e o
+//relatório do shim conta as trocas e as transações feitas com baudrate desatualizado
+typedef enum clock_num_rp2040 {
+    clk_gpout0 = 0, clk_gpout1, clk_gpout2, clk_gpout3,
+    clk_ref, clk_sys, clk_peri, clk_usb, clk_adc, clk_rtc,
+    CLK_COUNT
+} clock_num_t;
+typedef clock_num_t clock_handle_t;
+
+#define KHZ 1000
+#define MHZ 1000000
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLK_REF              0x0
+#define CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX   0x1
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS    0x0
+#define CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB    0x1
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS          0x0
+#define CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB   0x2
+
+uint32_t clock_get_hz(clock_handle_t clock);
+bool clock_configure(clock_handle_t clock, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq);
+//como no SDK 2.1.0: ambas deixam o clk_peri no clk_sys (o set_sys_clock_48mhz o põe lá a 48 MHz, e o
+//set_sys_clock_khz não o tira de lá), então a UART muda de baudrate a cada chamada
+bool check_sys_clock_khz(uint32_t freq_khz, uint* vco_freq_out, uint* post_div1_out, uint* post_div2_out);
+bool set_sys_clock_khz(uint32_t freq_khz, bool required);
+void set_sys_clock_48mhz(void);
+
+#ifdef __cplusplus
+}
+#endif
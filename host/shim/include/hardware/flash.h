@@ -0,0 +1,22 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//flash de 2 MB em memória, lida pelo "XIP" como um ponteiro comum e apagada em 0xFF;
+//PICO_SHIM_FLASH=<arquivo> a mantém entre execuções (cada execução é um boot)
+#define PICO_FLASH_SIZE_BYTES (2 * 1024 * 1024)
+#define FLASH_PAGE_SIZE       (1u << 8)
+#define FLASH_SECTOR_SIZE     (1u << 12)
+
+extern uint8_t shim_flash[PICO_FLASH_SIZE_BYTES];
+#define XIP_BASE ((uintptr_t)shim_flash)
+
+void flash_range_erase(uint32_t flash_offs, size_t count);
+void flash_range_program(uint32_t flash_offs, const uint8_t *data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+#include "pico.h"
+
+enum gpio_function { GPIO_FUNC_I2C = 3, GPIO_FUNC_SIO = 5, GPIO_FUNC_NULL = 0x1f };
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+static inline void gpio_set_function(unsigned gpio, enum gpio_function fn) { (void)gpio; (void)fn; }
+static inline void gpio_pull_up(unsigned gpio) { (void)gpio; }
+static inline void gpio_init(unsigned gpio) { (void)gpio; }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,28 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//cada barramento encaminha as transações para os dispositivos falsos (fake_devices.c)
+//e avança o relógio virtual pelo tempo de fio: (bytes + endereço) × 9 bits / baudrate
+typedef struct i2c_inst {
+    int      index;
+    unsigned baudrate;
+    uint32_t clk_sys_hz; //clk_sys quando o divisor foi calculado (i2c_init/i2c_set_baudrate)
+} i2c_inst_t;
+
+extern i2c_inst_t i2c0_inst, i2c1_inst;
+#define i2c0 (&i2c0_inst)
+#define i2c1 (&i2c1_inst)
+
+unsigned i2c_init(i2c_inst_t *i2c, unsigned baudrate);
+unsigned i2c_set_baudrate(i2c_inst_t *i2c, unsigned baudrate);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop);
+static inline unsigned i2c_hw_index(i2c_inst_t *i2c) { return (unsigned)i2c->index; }
+
+#ifdef __cplusplus
+}
+#endif
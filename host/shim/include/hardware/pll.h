@@ -0,0 +1,20 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct shim_pll { bool on; uint32_t hz; } *PLL;
+extern struct shim_pll shim_pll_sys, shim_pll_usb;
+#define pll_sys (&shim_pll_sys)
+#define pll_usb (&shim_pll_usb)
+
+#define PLL_COMMON_REFDIV 1
+
+void pll_init(PLL pll, uint ref_div, uint vco_freq, uint post_div1, uint post_div2);
+void pll_deinit(PLL pll);
+
+#ifdef __cplusplus
+}
+#endif
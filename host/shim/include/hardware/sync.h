@@ -0,0 +1,13 @@
+#pragma once
+#include "pico.h"
+#include <sched.h>
+
+void shim_wfe(void); //núcleo ocioso até o próximo evento (pico_shim.c)
+void shim_sev(void);
+
+static inline void __mem_fence_release(void) { __atomic_thread_fence(__ATOMIC_RELEASE); }
+static inline void __mem_fence_acquire(void) { __atomic_thread_fence(__ATOMIC_ACQUIRE); }
+static inline void __dmb(void) { __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+static inline void __wfe(void) { shim_wfe(); } //núcleos são threads no host
+static inline void __sev(void) { shim_sev(); }
+static inline void __wfi(void) { shim_wfe(); }
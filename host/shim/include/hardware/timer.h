@@ -0,0 +1,24 @@
+#pragma once
+#include "pico.h"
+#include "pico/time.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//alarmes de hardware do timer sobre o relógio virtual: o "IRQ" roda no núcleo que armou o alarme,
+//nos pontos em que ele atenderia interrupções (sleeps, __wfe e best_effort_wfe_or_timeout), e um
+//núcleo ocioso esperando por ele pula o tempo até o prazo, como num sleep
+#define NUM_GENERIC_TIMERS 4
+
+typedef void (*hardware_alarm_callback_t)(uint alarm_num);
+
+int  hardware_alarm_claim_unused(bool required);
+void hardware_alarm_unclaim(uint alarm_num);
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback);
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t); //true se t já passou (sem IRQ)
+void hardware_alarm_cancel(uint alarm_num);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//UART do stdio (o firmware liga stdio UART e USB): o texto sai no terminal, e só o divisor é
+//registrado. Ele é calculado do clk_peri no uart_set_baudrate (o do boot, pelo stdio_uart_init do
+//SDK, sobre o clk_peri do clocks_init); com o clk_peri trocado depois, a UART roda na proporção
+typedef struct uart_inst {
+    unsigned baudrate;
+    uint32_t clk_peri_hz; //clk_peri quando o divisor foi calculado
+} uart_inst_t;
+
+extern uart_inst_t uart0_inst;
+#define uart0 (&uart0_inst)
+#define uart_default uart0
+#ifndef PICO_DEFAULT_UART_BAUD_RATE
+#define PICO_DEFAULT_UART_BAUD_RATE 115200
+#endif
+
+unsigned uart_set_baudrate(uart_inst_t *uart, unsigned baudrate);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,20 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//registradores scratch do watchdog: zerados em cada execução (queda de energia), a menos que
+//PICO_SHIM_WARM_BOOT=1 simule um reset por watchdog e recupere os valores da execução anterior
+//(guardados em <PICO_SHIM_FLASH>.scratch)
+typedef struct {
+    volatile uint32_t scratch[8];
+} watchdog_hw_t;
+
+extern watchdog_hw_t shim_watchdog;
+#define watchdog_hw (&shim_watchdog)
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+//shim host do Pico SDK: apenas o subconjunto usado pelo firmware deste repositório
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifndef PICO_ON_DEVICE
+#define PICO_ON_DEVICE 0
+#endif
+
+#define _u(x) x##u
+typedef unsigned int uint; //como no SDK (mesmo typedef da glibc)
+
+#define PICO_OK             0
+#define PICO_ERROR_GENERIC -1
+#define PICO_ERROR_TIMEOUT -1
+
+unsigned get_core_num(void); //0 na thread principal, 1 na thread do core1
+void panic(const char *fmt, ...) __attribute__((noreturn, format(printf, 1, 2))); //mensagem em stderr e exit(1)
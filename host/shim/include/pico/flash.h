@@ -0,0 +1,18 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//no host não há XIP a proteger: a função roda direto (o tempo de apagar/gravar é cobrado em flash_shim.c)
+static inline int flash_safe_execute(void (*func)(void *), void *param, uint32_t enter_exit_timeout_ms) {
+    (void)enter_exit_timeout_ms;
+    func(param);
+    return PICO_OK;
+}
+static inline bool flash_safe_execute_core_init(void) { return true; }
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,12 @@
+#pragma once
+#include "pico.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+void multicore_launch_core1(void (*entry)(void)); //core1 vira uma thread no host
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,19 @@
+#pragma once
+#include "pico.h"
+#include "pico/time.h"
+#include "hardware/gpio.h"
+#include <stdio.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+bool stdio_init_all(void);
+int getchar_timeout_us(uint32_t timeout_us); //lê stdin sem bloquear, PICO_ERROR_TIMEOUT se vazio
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation); //bytes crus no stdout
+void stdio_flush(void);
+static inline void tight_loop_contents(void) {}
+
+#ifdef __cplusplus
+}
+#endif
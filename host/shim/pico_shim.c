@@ -0,0 +1,444 @@
+#include "pico/stdlib.h"
+#include "pico/multicore.h"
+#include "hardware/i2c.h"
+#include "hardware/timer.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/uart.h"
+#include "fake_devices.h"
+#include <poll.h>
+#include <stdarg.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+//shim host do Pico SDK: tempo virtual, I2C encaminhado aos dispositivos falsos,
+//stdio no terminal e core1 como thread
+
+i2c_inst_t i2c0_inst = {.index = 0, .baudrate = 0, .clk_sys_hz = 0};
+i2c_inst_t i2c1_inst = {.index = 1, .baudrate = 0, .clk_sys_hz = 0};
+
+static uint64_t boot_ns = 0;
+static volatile uint64_t skipped_us = 0; //tempo de sleep pulado (relógio virtual)
+static bool realtime = false;            //PICO_SHIM_REALTIME=1: sleeps dormem de verdade
+
+static uint64_t monotonic_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+uint64_t time_us_64(void) {
+    return (monotonic_ns() - boot_ns) / 1000 + __atomic_load_n(&skipped_us, __ATOMIC_RELAXED);
+}
+
+//núcleos ocupados: um sleep só pula tempo virtual quando o outro núcleo também está ocioso
+//(__wfe ou sleep); enquanto ele trabalha, o tempo passa em tempo real, como na placa
+static volatile int core_busy[2] = {1, 0};
+static volatile int core_event[2] = {0, 0}; //registrador de evento do __sev/__wfe
+static volatile uint64_t core_wake_us[2] = {UINT64_MAX, UINT64_MAX}; //prazo do núcleo ocioso em idle_until
+static pthread_mutex_t idle_lock = PTHREAD_MUTEX_INITIALIZER;
+static __thread int this_core = 0;
+
+unsigned get_core_num(void) {
+    return (unsigned)this_core;
+}
+
+static void wait_other_core_idle(uint64_t until_us) {
+    struct timespec ts = {0, 20000};
+    int other = this_core ^ 1;
+    while ((core_busy[other] || core_event[other]) && time_us_64() < until_us)
+        nanosleep(&ts, NULL);
+}
+
+void shim_drain_cores(void) {
+    wait_other_core_idle(UINT64_MAX);
+}
+
+void shim_advance_us(uint64_t us) {
+    if (realtime) {
+        struct timespec ts = { (time_t)(us / 1000000), (long)(us % 1000000) * 1000 };
+        nanosleep(&ts, NULL);
+        return;
+    }
+    __atomic_fetch_add(&skipped_us, us, __ATOMIC_RELAXED);
+}
+
+//pontos em que um IRQ do firmware seria atendido (conclusões do modelo de DMA, i2c_dma_shim.c)
+void (*shim_irq_hook)(void) = NULL;
+
+//frequências e fontes dos clocks como o clocks_init do SDK as deixa (clk_sys no pll_sys, clk_peri no
+//clk_sys)
+static uint32_t clock_hz[CLK_COUNT] = {
+    [clk_ref] = 12 * MHZ, [clk_sys] = 125 * MHZ, [clk_peri] = 125 * MHZ,
+    [clk_usb] = 48 * MHZ, [clk_adc] = 48 * MHZ, [clk_rtc] = 46875,
+};
+static bool sys_on_pll_sys = true, peri_on_sys = true;
+struct shim_pll shim_pll_sys = {true, 125 * MHZ}, shim_pll_usb = {true, 48 * MHZ};
+//UART do stdio com o divisor do stdio_uart_init no boot
+uart_inst_t uart0_inst = {.baudrate = PICO_DEFAULT_UART_BAUD_RATE, .clk_peri_hz = 125 * MHZ};
+static uint32_t clk_sys_changes = 0;
+static uint32_t stale_uart_changes = 0; //trocas do clk_sys que levaram a UART para fora do baudrate
+static volatile uint32_t stale_baud_transfers = 0;
+
+void panic(const char *fmt, ...) {
+    va_list ap;
+    va_start(ap, fmt);
+    fprintf(stderr, "[shim] panic: ");
+    vfprintf(stderr, fmt, ap);
+    fputc('\n', stderr);
+    va_end(ap);
+    exit(1);
+}
+
+static void clock_fail(const char *what) {
+    fprintf(stderr, "[shim] %s\n", what);
+    exit(1);
+}
+
+static void set_clock_hz(clock_handle_t clock, uint32_t hz) {
+    if (clock == clk_sys && hz != clock_hz[clk_sys]) clk_sys_changes++;
+    clock_hz[clock] = hz;
+    if (clock == clk_sys && peri_on_sys) {
+        clock_hz[clk_peri] = hz; //a UART só acompanha se o firmware refizer o baudrate
+        if (hz != uart0_inst.clk_peri_hz) stale_uart_changes++;
+    }
+}
+
+uint32_t clock_get_hz(clock_handle_t clock) {
+    return clock_hz[clock];
+}
+
+bool clock_configure(clock_handle_t clock, uint32_t src, uint32_t auxsrc, uint32_t src_freq, uint32_t freq) {
+    if (freq > src_freq) return false;
+    if (clock == clk_sys) {
+        sys_on_pll_sys = src == CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX &&
+                         auxsrc == CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS;
+        if (sys_on_pll_sys && (!shim_pll_sys.on || src_freq != shim_pll_sys.hz))
+            clock_fail("clk_sys no pll_sys desligado ou em outra frequência");
+    } else if (clock == clk_peri) {
+        peri_on_sys = auxsrc == CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS;
+    }
+    set_clock_hz(clock, freq);
+    return true;
+}
+
+//mesma busca do SDK: VCO de 750 a 1600 MHz sobre a referência de 12 MHz, postdiv2 <= postdiv1
+bool check_sys_clock_khz(uint32_t freq_khz, uint *vco_out, uint *postdiv1_out, uint *postdiv2_out) {
+    for (uint fbdiv = 320; fbdiv >= 16; fbdiv--) {
+        uint vco_khz = fbdiv * 12000;
+        if (vco_khz < 750000 || vco_khz > 1600000) continue;
+        for (uint pd1 = 7; pd1 >= 1; pd1--) {
+            for (uint pd2 = pd1; pd2 >= 1; pd2--) {
+                if (vco_khz / (pd1 * pd2) == freq_khz && !(vco_khz % (pd1 * pd2))) {
+                    *vco_out = vco_khz * KHZ;
+                    *postdiv1_out = pd1;
+                    *postdiv2_out = pd2;
+                    return true;
+                }
+            }
+        }
+    }
+    return false;
+}
+
+//set_sys_clock_pll() do SDK 2.1.0: clk_sys passa pelo pll_usb enquanto o pll_sys trava, e o clk_peri
+//continua no clk_sys, agora na frequência nova
+bool set_sys_clock_khz(uint32_t freq_khz, bool required) {
+    uint vco, pd1, pd2;
+    if (!check_sys_clock_khz(freq_khz, &vco, &pd1, &pd2)) {
+        if (required) {
+            fprintf(stderr, "[shim] clk_sys de %u kHz inatingível\n", (unsigned)freq_khz);
+            exit(1);
+        }
+        return false;
+    }
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    pll_init(pll_sys, PLL_COMMON_REFDIV, vco, pd1, pd2);
+    uint32_t freq = vco / (pd1 * pd2);
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_SYS, freq, freq);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, freq, freq);
+    return true;
+}
+
+//SDK 2.1.0: clk_sys no pll_usb, pll_sys desligado e clk_peri de volta no clk_sys, a 48 MHz
+void set_sys_clock_48mhz(void) {
+    clock_configure(clk_sys, CLOCKS_CLK_SYS_CTRL_SRC_VALUE_CLKSRC_CLK_SYS_AUX,
+                    CLOCKS_CLK_SYS_CTRL_AUXSRC_VALUE_CLKSRC_PLL_USB, 48 * MHZ, 48 * MHZ);
+    pll_deinit(pll_sys);
+    clock_configure(clk_peri, 0, CLOCKS_CLK_PERI_CTRL_AUXSRC_VALUE_CLK_SYS, 48 * MHZ, 48 * MHZ);
+}
+
+void pll_init(PLL pll, uint ref_div, uint vco_freq, uint post_div1, uint post_div2) {
+    if (pll == pll_sys && sys_on_pll_sys) clock_fail("pll_init do pll_sys com o clk_sys nele");
+    pll->on = true;
+    (void)ref_div;
+    pll->hz = vco_freq / (post_div1 * post_div2);
+}
+
+void pll_deinit(PLL pll) {
+    if (pll == pll_sys && sys_on_pll_sys) clock_fail("pll_deinit do pll_sys com o clk_sys nele");
+    pll->on = false;
+}
+
+unsigned uart_set_baudrate(uart_inst_t *uart, unsigned baudrate) {
+    uart->baudrate = baudrate;
+    uart->clk_peri_hz = clock_hz[clk_peri];
+    return baudrate;
+}
+
+unsigned shim_uart_baud(const uart_inst_t *uart) {
+    return (unsigned)((uint64_t)uart->baudrate * clock_hz[clk_peri] / uart->clk_peri_hz);
+}
+
+//alarmes de hardware: cada um dispara no núcleo que o armou
+typedef struct {
+    bool claimed, armed;
+    int core;
+    uint64_t target;
+    hardware_alarm_callback_t callback;
+} shim_alarm_t;
+
+static shim_alarm_t alarms[NUM_GENERIC_TIMERS];
+static pthread_mutex_t alarm_lock = PTHREAD_MUTEX_INITIALIZER;
+
+int hardware_alarm_claim_unused(bool required) {
+    pthread_mutex_lock(&alarm_lock);
+    for (int i = 0; i < NUM_GENERIC_TIMERS; i++) {
+        if (!alarms[i].claimed) {
+            alarms[i].claimed = true;
+            pthread_mutex_unlock(&alarm_lock);
+            return i;
+        }
+    }
+    pthread_mutex_unlock(&alarm_lock);
+    if (required) {
+        fprintf(stderr, "[shim] nenhum alarme de hardware livre\n");
+        exit(1);
+    }
+    return -1;
+}
+
+void hardware_alarm_unclaim(uint alarm_num) {
+    pthread_mutex_lock(&alarm_lock);
+    alarms[alarm_num].claimed = alarms[alarm_num].armed = false;
+    pthread_mutex_unlock(&alarm_lock);
+}
+
+void hardware_alarm_set_callback(uint alarm_num, hardware_alarm_callback_t callback) {
+    pthread_mutex_lock(&alarm_lock);
+    alarms[alarm_num].callback = callback;
+    pthread_mutex_unlock(&alarm_lock);
+}
+
+bool hardware_alarm_set_target(uint alarm_num, absolute_time_t t) {
+    pthread_mutex_lock(&alarm_lock);
+    shim_alarm_t *a = &alarms[alarm_num];
+    bool missed = t <= time_us_64();
+    a->armed = !missed;
+    a->core = this_core;
+    a->target = t;
+    pthread_mutex_unlock(&alarm_lock);
+    return missed;
+}
+
+void hardware_alarm_cancel(uint alarm_num) {
+    pthread_mutex_lock(&alarm_lock);
+    alarms[alarm_num].armed = false;
+    pthread_mutex_unlock(&alarm_lock);
+}
+
+//"IRQ" do timer: chama os callbacks dos alarmes vencidos deste núcleo
+static void fire_due_alarms(void) {
+    for (unsigned i = 0; i < NUM_GENERIC_TIMERS; i++) {
+        pthread_mutex_lock(&alarm_lock);
+        shim_alarm_t *a = &alarms[i];
+        bool due = a->armed && a->core == this_core && a->target <= time_us_64();
+        if (due) a->armed = false;
+        hardware_alarm_callback_t callback = a->callback;
+        pthread_mutex_unlock(&alarm_lock);
+        if (due && callback) callback(i);
+    }
+}
+
+static uint64_t next_alarm_us(void) {
+    uint64_t next = UINT64_MAX;
+    pthread_mutex_lock(&alarm_lock);
+    for (int i = 0; i < NUM_GENERIC_TIMERS; i++)
+        if (alarms[i].armed && alarms[i].core == this_core && alarms[i].target < next)
+            next = alarms[i].target;
+    pthread_mutex_unlock(&alarm_lock);
+    return next;
+}
+
+//núcleo ocioso até stop (ou até um __sev, se wake_on_event): o tempo virtual pula quando o outro
+//núcleo também está ocioso, e só até o prazo mais próximo dos dois (o núcleo que acorda primeiro
+//avança o relógio; o outro espera em tempo real enquanto ele trabalha)
+static void idle_until(uint64_t stop, bool wake_on_event) {
+    struct timespec ts = {0, 20000};
+    int other = this_core ^ 1;
+    core_wake_us[this_core] = stop;
+    core_busy[this_core] = 0;
+    while (time_us_64() < stop && !(wake_on_event && core_event[this_core])) {
+        pthread_mutex_lock(&idle_lock);
+        uint64_t now = time_us_64();
+        if (!core_busy[other] && !core_event[other] && stop <= core_wake_us[other] && stop > now)
+            shim_advance_us(stop - now);
+        pthread_mutex_unlock(&idle_lock);
+        if (time_us_64() < stop) nanosleep(&ts, NULL);
+    }
+    core_busy[this_core] = 1;
+    core_wake_us[this_core] = UINT64_MAX;
+}
+
+void sleep_until(absolute_time_t t) {
+    while (1) { //alarmes que vencem durante o sleep disparam no prazo, como o IRQ
+        uint64_t alarm = next_alarm_us();
+        idle_until(alarm < t ? alarm : t, false);
+        fire_due_alarms();
+        if (time_us_64() >= t) break;
+    }
+    if (shim_irq_hook) shim_irq_hook();
+}
+
+bool best_effort_wfe_or_timeout(absolute_time_t t) {
+    if (shim_irq_hook) shim_irq_hook();
+    fire_due_alarms();
+    if (!core_event[this_core]) { //sem evento pendente: dorme até o próximo alarme ou o timeout
+        uint64_t alarm = next_alarm_us();
+        idle_until(alarm < t ? alarm : t, true);
+        fire_due_alarms();
+        if (shim_irq_hook) shim_irq_hook();
+    }
+    core_event[this_core] = 0;
+    return time_us_64() >= t;
+}
+
+void sleep_us(uint64_t us) { sleep_until(time_us_64() + us); }
+void sleep_ms(uint32_t ms) { sleep_until(time_us_64() + (uint64_t)ms * 1000); }
+
+void shim_wfe(void) {
+    struct timespec ts = {0, 20000};
+    if (shim_irq_hook) shim_irq_hook();
+    fire_due_alarms();
+    if (core_event[this_core]) { //evento pendente: retorna sem dormir
+        core_event[this_core] = 0;
+        return;
+    }
+    core_busy[this_core] = 0;
+    nanosleep(&ts, NULL);
+    core_busy[this_core] = 1;
+}
+
+void shim_sev(void) {
+    core_event[0] = core_event[1] = 1;
+}
+
+static void shim_exit_report(void) {
+    fflush(stdout);
+    fake_devices_report(stderr);
+    if (clk_sys_changes)
+        fprintf(stderr, "[shim] clk_sys: %u trocas, %u kHz no fim (pll_sys %s); %u transferências I2C com "
+                "baudrate de outro clk_sys\n", (unsigned)clk_sys_changes, (unsigned)(clock_hz[clk_sys] / KHZ),
+                shim_pll_sys.on ? "ligado" : "desligado", (unsigned)stale_baud_transfers);
+    if (clk_sys_changes || stale_uart_changes)
+        fprintf(stderr, "[shim] clk_peri: %u kHz no fim, UART a %u baud; %u trocas do clk_sys com a UART fora do "
+                "baudrate\n", (unsigned)(clock_hz[clk_peri] / KHZ), shim_uart_baud(uart0),
+                (unsigned)stale_uart_changes);
+}
+
+bool stdio_init_all(void) {
+    boot_ns = monotonic_ns();
+    const char *rt = getenv("PICO_SHIM_REALTIME");
+    realtime = rt && rt[0] == '1';
+    const char *quiet = getenv("PICO_SHIM_QUIET");
+    if (quiet && quiet[0] == '1' && !freopen("/dev/null", "w", stdout)) //descarta o log do firmware
+        return false;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+    fake_devices_init();
+    shim_flash_init();
+    atexit(shim_exit_report);
+    return true;
+}
+
+int getchar_timeout_us(uint32_t timeout_us) {
+    struct pollfd pfd = { STDIN_FILENO, POLLIN, 0 };
+    if (poll(&pfd, 1, (int)(timeout_us / 1000)) <= 0 || !(pfd.revents & POLLIN))
+        return PICO_ERROR_TIMEOUT;
+    unsigned char c;
+    if (read(STDIN_FILENO, &c, 1) != 1) return PICO_ERROR_TIMEOUT; //EOF: sem comandos
+    return c;
+}
+
+void stdio_flush(void) {
+    fflush(stdout);
+}
+
+int stdio_put_string(const char *s, int len, bool newline, bool cr_translation) {
+    (void)cr_translation; //o terminal do host não traduz \n
+    fwrite(s, 1, (size_t)len, stdout);
+    if (newline) putchar('\n');
+    fflush(stdout); //quadros binários não terminam em \n: o buffer de linha não os enviaria
+    return len;
+}
+
+//tempo de fio de uma transação: START + endereço + dados (9 bits por byte com ACK) + STOP. O SCL sai
+//de contagens do clk_sys: com o clk_sys trocado depois do i2c_set_baudrate, o bus roda na proporção
+uint64_t shim_i2c_wire_us(const i2c_inst_t *i2c, size_t len) {
+    if (!i2c->baudrate) return 0;
+    uint64_t baud = i2c->baudrate;
+    if (i2c->clk_sys_hz && i2c->clk_sys_hz != clock_hz[clk_sys]) {
+        baud = baud * clock_hz[clk_sys] / i2c->clk_sys_hz;
+        __atomic_fetch_add(&stale_baud_transfers, 1, __ATOMIC_RELAXED);
+    }
+    uint64_t bits = (len + 1) * 9 + 2;
+    return (bits * 1000000ull + baud - 1) / baud;
+}
+
+static void i2c_wire_time(i2c_inst_t *i2c, size_t len) {
+    shim_advance_us(shim_i2c_wire_us(i2c, len)); //CPU presa no laço de polling do SDK
+}
+
+unsigned i2c_init(i2c_inst_t *i2c, unsigned baudrate) {
+    return i2c_set_baudrate(i2c, baudrate);
+}
+
+unsigned i2c_set_baudrate(i2c_inst_t *i2c, unsigned baudrate) {
+    i2c->baudrate = baudrate;
+    i2c->clk_sys_hz = clock_hz[clk_sys];
+    return baudrate;
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+    int ret = fake_i2c_write(i2c->index, addr, src, len, nostop);
+    i2c_wire_time(i2c, ret < 0 ? 0 : len); //NACK no endereço: apenas o byte de endereço vai ao fio
+    fake_i2c_complete();
+    return ret;
+}
+
+int i2c_read_blocking(i2c_inst_t *i2c, uint8_t addr, uint8_t *dst, size_t len, bool nostop) {
+    int ret = fake_i2c_read(i2c->index, addr, dst, len, nostop);
+    i2c_wire_time(i2c, ret < 0 ? 0 : len);
+    fake_i2c_complete();
+    return ret;
+}
+
+static void *core1_thread(void *arg) {
+    this_core = 1;
+    ((void (*)(void))arg)();
+    return NULL;
+}
+
+void multicore_launch_core1(void (*entry)(void)) {
+    pthread_t t;
+    core_busy[1] = 1;
+    if (pthread_create(&t, NULL, core1_thread, (void *)entry) != 0) {
+        fprintf(stderr, "[shim] falha ao criar thread do core1\n");
+        exit(1);
+    }
+    pthread_detach(t);
+}
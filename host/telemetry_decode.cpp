@@ -0,0 +1,292 @@
+#include "telemetry.h" //registros e tipos, os mesmos structs do firmware
+#include "crc.h"
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+//decodificador da telemetria binária (firmware/telemetry.c): separa o fluxo nos delimitadores 0x00,
+//desfaz o COBS, confere o CRC-32 e junta os registros de cada amostra (SAMPLE, PREDICTION, TIMING,
+//ERROR com a mesma seq) numa linha. Texto misturado ao fluxo (mensagens de boot, dumps de comandos)
+//falha no COBS/CRC e é descartado. Saídas:
+//  CSV: leituras em unidades físicas com os nomes de coluna de data/temp.csv (reproduzível pelo
+//       replay), previsões, tempos e bytes/ciclos de saída; vazio onde o registro não veio
+//  --columns DIR: um arquivo binário little-endian por coluna (DIR/<nome>.<i32|u32|f32>, lido com
+//       numpy.fromfile), com as contagens cruas dos drivers; NaN/0 onde o registro não veio
+//
+//Uso: telemetry_decode <captura|-> [saida.csv] [--columns DIR]
+
+namespace {
+
+struct Row {
+    uint32_t boot = 0;
+    bool has_sample = false, has_prediction = false, has_timing = false;
+    telemetry_sample_t sample{};
+    telemetry_prediction_t prediction{};
+    telemetry_timing_t timing{};
+    std::string errors; //"código:detalhe" separados por ';'
+};
+
+struct Stats {
+    size_t frames = 0, bad_frames = 0, junk_bytes = 0;
+    size_t by_type[TELEMETRY_ERROR + 1] = {};
+};
+
+//COBS inverso; false se o bloco não for COBS válido (ex.: texto)
+bool cobs_decode(const std::vector<uint8_t>& in, std::vector<uint8_t>& out) {
+    out.clear();
+    size_t i = 0;
+    while (i < in.size()) {
+        uint8_t code = in[i++];
+        if (code == 0 || i + code - 1 > in.size()) return false;
+        out.insert(out.end(), in.begin() + i, in.begin() + i + code - 1);
+        i += code - 1;
+        if (code < 0xFF && i < in.size()) out.push_back(0);
+    }
+    return true;
+}
+
+size_t record_size(uint8_t type) {
+    switch (type) {
+        case TELEMETRY_SAMPLE: return sizeof(telemetry_sample_t);
+        case TELEMETRY_PREDICTION: return sizeof(telemetry_prediction_t);
+        case TELEMETRY_TIMING: return sizeof(telemetry_timing_t);
+        case TELEMETRY_ERROR: return sizeof(telemetry_error_record_t);
+        default: return 0;
+    }
+}
+
+class Decoder {
+public:
+    std::vector<Row> rows;
+    Stats stats;
+
+    void feed(const std::vector<uint8_t>& chunk) {
+        if (chunk.empty()) return; //entre dois quadros (0x00 final + 0x00 inicial)
+        std::vector<uint8_t> raw;
+        size_t size = cobs_decode(chunk, raw) && !raw.empty() ? record_size(raw[0]) : 0;
+        uint32_t crc;
+        if (!size || raw.size() != 1 + size + sizeof(crc)) {
+            stats.junk_bytes += chunk.size();
+            return;
+        }
+        memcpy(&crc, raw.data() + 1 + size, sizeof(crc));
+        if (crc != crc32_update(0, raw.data(), 1 + size)) {
+            stats.bad_frames++;
+            return;
+        }
+        stats.frames++;
+        stats.by_type[raw[0]]++;
+        const uint8_t* rec = raw.data() + 1;
+        switch (raw[0]) {
+            case TELEMETRY_SAMPLE: {
+                telemetry_sample_t s;
+                memcpy(&s, rec, sizeof(s));
+                if (!rows.empty() && rows.back().has_sample && s.seq <= rows.back().sample.seq)
+                    boot++; //seq recomeçou: reset do firmware
+                Row r;
+                r.boot = boot;
+                r.has_sample = true;
+                r.sample = s;
+                rows.push_back(r);
+                break;
+            }
+            case TELEMETRY_PREDICTION: {
+                telemetry_prediction_t p;
+                memcpy(&p, rec, sizeof(p));
+                Row& r = row_for(p.seq);
+                r.has_prediction = true;
+                r.prediction = p;
+                break;
+            }
+            case TELEMETRY_TIMING: {
+                telemetry_timing_t t;
+                memcpy(&t, rec, sizeof(t));
+                Row& r = row_for(t.seq);
+                r.has_timing = true;
+                r.timing = t;
+                break;
+            }
+            case TELEMETRY_ERROR: {
+                telemetry_error_record_t e;
+                memcpy(&e, rec, sizeof(e));
+                Row& r = row_for(e.seq);
+                if (!r.errors.empty()) r.errors += ';';
+                r.errors += std::to_string(e.code) + ":" + std::to_string(e.detail);
+                break;
+            }
+        }
+    }
+
+private:
+    uint32_t boot = 0;
+
+    //registro da amostra seq no boot atual; erros antes da primeira amostra ganham uma linha própria
+    Row& row_for(uint32_t seq) {
+        for (size_t i = rows.size(); i-- > 0 && rows[i].boot == boot;)
+            if (rows[i].has_sample && rows[i].sample.seq == seq) return rows[i];
+        Row r;
+        r.boot = boot;
+        r.sample.seq = seq;
+        rows.push_back(r);
+        return rows.back();
+    }
+};
+
+//mesmas contas de counts_to_physical() em main.c (°C, %RH, °C, hPa)
+void counts_to_physical(const sensor_counts_t& c, double out[NUM_FEATURES]) {
+    out[0] = c.v[0] * 200.0 / 1048576.0 - 50.0;
+    out[1] = c.v[1] * 100.0 / 1048576.0;
+    out[2] = c.v[2] / 100.0;
+    out[3] = c.v[3] / 100.0;
+}
+
+bool write_csv(const std::vector<Row>& rows, FILE* out) {
+    fprintf(out, "boot,seq,t_ms,Temp_AHT20_C,Umid_AHT20_pct,Temp_BMP280_C,Press_BMP280_hPa,acquisition_us,"
+                 "normalize_cycles,lateness_us,pred_5min_C,pred_10min_C,pred_15min_C,invoke_us,model,display_bytes,"
+                 "display_rects,display_cpu_us,latency_us,output_bytes,output_cycles,errors\n");
+    for (const Row& r : rows) {
+        fprintf(out, "%u,%u,", r.boot, r.sample.seq);
+        if (r.has_sample) {
+            double v[NUM_FEATURES];
+            counts_to_physical(r.sample.counts, v);
+            fprintf(out, "%u,%.4f,%.4f,%.2f,%.2f,%u,%u,%d,", r.sample.t_ms, v[0], v[1], v[2], v[3],
+                    r.sample.acquisition_us, r.sample.normalize_cycles, r.sample.lateness_us);
+        } else {
+            fputs(",,,,,,,,", out);
+        }
+        if (r.has_prediction)
+            fprintf(out, "%.4f,%.4f,%.4f,%u,%u,", r.prediction.pred[0], r.prediction.pred[1], r.prediction.pred[2],
+                    r.prediction.invoke_us, r.prediction.model);
+        else
+            fputs(",,,,,", out);
+        if (r.has_timing) {
+            const telemetry_timing_t& t = r.timing;
+            if (r.has_prediction)
+                fprintf(out, "%u,%u,%u,%u,", t.display_bytes, t.display_rects, t.display_cpu_us, t.latency_us);
+            else
+                fputs(",,,,", out);
+            fprintf(out, "%u,%u,", t.output_bytes, t.output_cycles);
+        } else {
+            fputs(",,,,,,", out);
+        }
+        fprintf(out, "%s\n", r.errors.c_str());
+    }
+    return !ferror(out);
+}
+
+template <typename T, typename F>
+bool write_column(const std::string& dir, const char* name, const char* dtype, const std::vector<Row>& rows, F get) {
+    std::string path = dir + "/" + name + "." + dtype;
+    FILE* f = fopen(path.c_str(), "wb");
+    if (!f) {
+        fprintf(stderr, "[telemetry] não foi possível criar %s\n", path.c_str());
+        return false;
+    }
+    for (const Row& r : rows) {
+        T v = get(r);
+        fwrite(&v, sizeof(v), 1, f); //little-endian no host x86/ARM, como no RP2040
+    }
+    return fclose(f) == 0;
+}
+
+bool write_columns(const std::vector<Row>& rows, const std::string& dir) {
+    const float nan = NAN;
+    bool ok = write_column<uint32_t>(dir, "boot", "u32", rows, [](const Row& r) { return r.boot; });
+    ok &= write_column<uint32_t>(dir, "seq", "u32", rows, [](const Row& r) { return r.sample.seq; });
+    ok &= write_column<uint32_t>(dir, "t_ms", "u32", rows, [](const Row& r) { return r.sample.t_ms; });
+    static const char* const counts[NUM_FEATURES] = {"aht20_t_raw", "aht20_rh_raw", "bmp280_t_centi", "bmp280_p_pa"};
+    for (int f = 0; f < NUM_FEATURES; f++)
+        ok &= write_column<int32_t>(dir, counts[f], "i32", rows, [f](const Row& r) { return r.sample.counts.v[f]; });
+    ok &= write_column<uint32_t>(dir, "acquisition_us", "u32", rows,
+                                 [](const Row& r) { return r.sample.acquisition_us; });
+    ok &= write_column<uint32_t>(dir, "normalize_cycles", "u32", rows,
+                                 [](const Row& r) { return r.sample.normalize_cycles; });
+    ok &= write_column<int32_t>(dir, "lateness_us", "i32", rows, [](const Row& r) { return r.sample.lateness_us; });
+    static const char* const preds[3] = {"pred_5min_C", "pred_10min_C", "pred_15min_C"};
+    for (int h = 0; h < 3; h++)
+        ok &= write_column<float>(dir, preds[h], "f32", rows,
+                                  [h, nan](const Row& r) { return r.has_prediction ? r.prediction.pred[h] : nan; });
+    ok &= write_column<uint32_t>(dir, "invoke_us", "u32", rows, [](const Row& r) { return r.prediction.invoke_us; });
+    ok &= write_column<uint8_t>(dir, "model", "u8", rows, [](const Row& r) { return r.prediction.model; });
+    ok &= write_column<uint32_t>(dir, "output_bytes", "u32", rows, [](const Row& r) { return r.timing.output_bytes; });
+    ok &= write_column<uint32_t>(dir, "output_cycles", "u32", rows,
+                                 [](const Row& r) { return r.timing.output_cycles; });
+    return ok;
+}
+
+void print_summary(const Decoder& d) {
+    const Stats& s = d.stats;
+    fprintf(stderr, "[telemetry] %zu quadros (%zu amostras, %zu previsões, %zu tempos, %zu erros), "
+                    "%zu com CRC inválido, %zu bytes fora de quadros descartados\n",
+            s.frames, s.by_type[TELEMETRY_SAMPLE], s.by_type[TELEMETRY_PREDICTION], s.by_type[TELEMETRY_TIMING],
+            s.by_type[TELEMETRY_ERROR], s.bad_frames, s.junk_bytes);
+    //regime: ciclos com previsão, excluindo o primeiro (inclui a saída do boot/troca de modo)
+    double bytes = 0, cycles = 0;
+    size_t n = 0;
+    for (size_t i = 1; i < d.rows.size(); i++) {
+        const Row& r = d.rows[i];
+        if (!r.has_timing || !r.has_prediction) continue;
+        bytes += r.timing.output_bytes;
+        cycles += r.timing.output_cycles;
+        n++;
+    }
+    if (n)
+        fprintf(stderr, "[telemetry] saída por ciclo com previsão: %.1f bytes, %.0f ciclos (n=%zu)\n", bytes / n,
+                cycles / n, n);
+}
+
+} //namespace
+
+int main(int argc, char** argv) {
+    const char* input = nullptr;
+    const char* output = nullptr;
+    std::string columns;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--columns") == 0 && i + 1 < argc)
+            columns = argv[++i];
+        else if (!input)
+            input = argv[i];
+        else if (!output)
+            output = argv[i];
+        else
+            input = nullptr, i = argc; //argumento a mais: mostra o uso
+    }
+    if (!input) {
+        fprintf(stderr, "uso: %s <captura|-> [saida.csv] [--columns DIR]\n", argv[0]);
+        return 2;
+    }
+    FILE* in = strcmp(input, "-") == 0 ? stdin : fopen(input, "rb");
+    if (!in) {
+        fprintf(stderr, "[telemetry] não foi possível abrir %s\n", input);
+        return 1;
+    }
+
+    Decoder decoder;
+    std::vector<uint8_t> chunk;
+    uint8_t buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), in)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (buf[i] == 0) {
+                decoder.feed(chunk);
+                chunk.clear();
+            } else {
+                chunk.push_back(buf[i]);
+            }
+        }
+    }
+    decoder.stats.junk_bytes += chunk.size(); //sobra sem delimitador (texto final ou quadro cortado)
+    if (in != stdin) fclose(in);
+
+    FILE* out = output ? fopen(output, "w") : stdout;
+    if (!out || !write_csv(decoder.rows, out)) {
+        fprintf(stderr, "[telemetry] falha ao escrever %s\n", output ? output : "stdout");
+        return 1;
+    }
+    if (output) fclose(out);
+    if (!columns.empty() && !write_columns(decoder.rows, columns)) return 1;
+    print_summary(decoder);
+    return 0;
+}
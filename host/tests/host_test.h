@@ -0,0 +1,22 @@
+#pragma once
+#include <stdio.h>
+
+//verificação dos testes host (ctest): imprime a falha com o local e segue, para que uma execução
+//mostre todas as divergências; o main termina com HOST_TEST_END() (código 1 se alguma falhou)
+static int host_test_failures = 0;
+
+#define CHECK(cond, ...)                                                          \
+    do {                                                                          \
+        if (!(cond)) {                                                            \
+            fprintf(stderr, "%s:%d: FALHOU: ", __FILE__, __LINE__);               \
+            fprintf(stderr, __VA_ARGS__);                                         \
+            fputc('\n', stderr);                                                  \
+            host_test_failures++;                                                 \
+        }                                                                         \
+    } while (0)
+
+#define HOST_TEST_END(name)                                                       \
+    do {                                                                          \
+        printf("[%s] %s\n", name, host_test_failures ? "FALHOU" : "OK");           \
+        return host_test_failures ? 1 : 0;                                        \
+    } while (0)
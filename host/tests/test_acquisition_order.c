@@ -0,0 +1,75 @@
+#include <stdlib.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "fake_devices.h"
+#include "sensor_window.h" //WINDOW_SIZE
+
+//ordem das transações do ciclo sobreposto no barramento falso, com o main.c do firmware sem
+//modificação (os eventos dos dispositivos chegam ao observador na ordem do fio). Em cada amostra:
+//disparo do AHT20 -> leitura do BMP280 -> coleta do AHT20, e o flush do display da previsão no
+//mesmo ciclo, logo depois da coleta da amostra que fechou a janela e antes do próximo disparo: a
+//previsão não espera o alarme seguinte. O roteiro acaba no disparo da amostra NUM_ROWS + 1, depois
+//do flush da última janela
+#define NUM_ROWS 25
+
+enum { IDLE, TRIGGERED, BMP_READ }; //estado da amostra atual no fio
+
+static fake_env_row_t rows[NUM_ROWS];
+static int state = IDLE;
+static int samples = 0;     //amostras coletadas (disparo + BMP280 + AHT20)
+static int flush_sample = -1; //amostra coletada antes do último flush
+static int flushes = 0;     //ciclos com flush de previsão
+static int triggered = 0;   //disparos; os flushes antes do primeiro são as telas de inicialização
+
+static void on_device_event(fake_event_t event, uint64_t t_us) {
+    switch (event) {
+    case FAKE_EVT_AHT20_TRIGGER:
+        CHECK(state == IDLE, "%llu us: disparo da amostra %d antes da coleta da anterior",
+              (unsigned long long)t_us, samples + 1);
+        state = TRIGGERED;
+        triggered++;
+        break;
+    case FAKE_EVT_BMP280_DATA:
+        CHECK(state == TRIGGERED, "%llu us: leitura do BMP280 fora da conversão do AHT20 (amostra %d)",
+              (unsigned long long)t_us, samples + 1);
+        state = BMP_READ;
+        break;
+    case FAKE_EVT_AHT20_DATA:
+        CHECK(state == BMP_READ, "%llu us: coleta do AHT20 sem disparo e BMP280 antes (amostra %d)",
+              (unsigned long long)t_us, samples + 1);
+        state = IDLE;
+        samples++;
+        break;
+    case FAKE_EVT_SSD1306_DATA:
+        if (!triggered) break; //telas de inicialização
+        //a previsão da janela da amostra k sai no ciclo dela, depois da coleta do AHT20
+        CHECK(samples >= WINDOW_SIZE, "%llu us: flush do display com %d amostras coletadas",
+              (unsigned long long)t_us, samples);
+        CHECK(state == IDLE, "%llu us: flush do display durante a conversão da amostra %d, esperado depois da coleta",
+              (unsigned long long)t_us, samples + 1);
+        if (flush_sample != samples) flushes++; //um flush parcial pode ter várias transações de dados
+        flush_sample = samples;
+        break;
+    }
+}
+
+static void order_report(void) {
+    CHECK(samples == NUM_ROWS, "%d amostras coletadas, roteiro com %d", samples, NUM_ROWS);
+    CHECK(flushes == NUM_ROWS - WINDOW_SIZE + 1, "%d flushes de previsão, esperado %d", flushes,
+          NUM_ROWS - WINDOW_SIZE + 1);
+    //stderr: com PICO_SHIM_QUIET o stdout do processo é o /dev/null
+    fprintf(stderr, "[acquisition] %d amostras na ordem disparo -> BMP280 -> AHT20, %d flushes logo após a coleta\n",
+            samples, flushes);
+    fprintf(stderr, "[acquisition] %s\n", host_test_failures ? "FALHOU" : "OK");
+    _exit(host_test_failures ? 1 : 0); //o fim do roteiro sai pelo exit(0) do shim
+}
+
+//roda antes do main() do firmware: roteiro em código e observador dos dispositivos
+__attribute__((constructor)) static void order_setup(void) {
+    for (int i = 0; i < NUM_ROWS; i++)
+        rows[i] = (fake_env_row_t){22.0f + 0.05f * i, 55.0f - 0.1f * i, 22.5f + 0.05f * i, 918.0f + 0.01f * i};
+    fake_env_set_rows(rows, NUM_ROWS);
+    fake_devices_set_observer(on_device_event);
+    setenv("PICO_SHIM_QUIET", "1", 1); //só as mensagens do teste e do shim
+    atexit(order_report);
+}
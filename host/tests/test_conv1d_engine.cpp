@@ -0,0 +1,32 @@
+#include <math.h>
+#include "host_test.h"
+#include "codegen_engine.h"
+#include "conv1d_engine_params.h"
+#include "conv1d_test_vectors.h" //janelas e saídas do interpretador de referência (tools/gen_test_vectors.py)
+
+//motor Conv1D gerado contra o interpretador de referência em Python, nas janelas fixas dos vetores.
+//A referência acumula em float32 na mesma ordem dos kernels (bias, depois kernel × canais), então a
+//diferença esperada é de poucos ULPs; a tolerância só absorve contrações em FMA do compilador
+#define TOLERANCE_C 1e-4f
+
+namespace conv1d_engine {
+extern const codegen_engine_t engine;
+}
+
+int main() {
+    static_assert(kTestWindow == conv1d_engine::kWindow && kTestFeatures == conv1d_engine::kFeatures &&
+                  kTestHorizons == conv1d_engine::kHorizons, "vetores de outro modelo");
+    float worst = 0.0f;
+    for (int w = 0; w < kTestWindows; w++) {
+        float out[kTestHorizons];
+        conv1d_engine::engine.invoke(test_windows[w], out);
+        for (int h = 0; h < kTestHorizons; h++) {
+            float diff = fabsf(out[h] - test_expected[w][h]);
+            worst = diff > worst ? diff : worst;
+            CHECK(diff <= TOLERANCE_C, "janela %d, horizonte %d: motor %.6f, referência %.6f", w, h, out[h],
+                  test_expected[w][h]);
+        }
+    }
+    printf("[conv1d] %d janelas, diferença máx %.3g °C (tolerância %.0e)\n", kTestWindows, worst, TOLERANCE_C);
+    HOST_TEST_END("conv1d");
+}
@@ -0,0 +1,61 @@
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "codegen_engine.h"
+#include "conv1d_engine_params.h"
+
+//modo incremental do motor Conv1D contra o invoke completo: amostras consecutivas de um passeio
+//aleatório entram por stream_push() e, a cada amostra com a janela cheia, stream_invoke() deve dar a
+//mesma saída que invoke() sobre as últimas kWindow amostras. São amostras suficientes para dar várias
+//voltas em todos os anéis (entrada, conv1d_1 e conv1d_2). As colunas são calculadas pelo mesmo
+//conv1d_column() nos dois caminhos, então a diferença esperada é zero
+#define NUM_SAMPLES 64
+#define TOLERANCE_C 1e-6f
+
+using namespace conv1d_engine;
+
+namespace conv1d_engine {
+extern const codegen_engine_t engine;
+}
+
+static uint32_t lcg_state = 12345;
+static float next_step(void) { //passo uniforme em [-0.2, 0.2)
+    lcg_state = lcg_state * 1664525u + 1013904223u;
+    return ((lcg_state >> 8) * (1.0f / 16777216.0f) - 0.5f) * 0.4f;
+}
+
+int main() {
+    static float samples[NUM_SAMPLES][kFeatures];
+    for (int f = 0; f < kFeatures; f++)
+        samples[0][f] = 0.5f * f - 0.75f;
+    for (int i = 1; i < NUM_SAMPLES; i++)
+        for (int f = 0; f < kFeatures; f++)
+            samples[i][f] = samples[i - 1][f] + next_step();
+
+    float worst = 0.0f;
+    int compared = 0;
+    for (int i = 0; i < NUM_SAMPLES; i++) {
+        engine.stream_push(samples[i]);
+        float stream_out[kHorizons];
+        int rc = engine.stream_invoke(stream_out);
+        if (i + 1 < kWindow) {
+            CHECK(rc == 3, "amostra %d: stream_invoke retornou %d com a janela incompleta", i, rc);
+            continue;
+        }
+        CHECK(rc == 0, "amostra %d: stream_invoke retornou %d", i, rc);
+        float full_out[kHorizons];
+        engine.invoke(&samples[i + 1 - kWindow][0], full_out); //janela contígua: as últimas kWindow amostras
+        for (int h = 0; h < kHorizons; h++) {
+            float diff = fabsf(stream_out[h] - full_out[h]);
+            worst = diff > worst ? diff : worst;
+            CHECK(diff <= TOLERANCE_C, "amostra %d, horizonte %d: incremental %.7f, completo %.7f", i, h,
+                  stream_out[h], full_out[h]);
+        }
+        compared++;
+    }
+    CHECK(engine.macs_per_stream_step < engine.macs_per_invoke, "incremental com %d MACs, completo %d",
+          engine.macs_per_stream_step, engine.macs_per_invoke);
+    printf("[conv1d-stream] %d janelas (%d amostras), diferença máx %.3g °C, %d contra %d MACs\n", compared,
+           NUM_SAMPLES, worst, engine.macs_per_stream_step, engine.macs_per_invoke);
+    HOST_TEST_END("conv1d-stream");
+}
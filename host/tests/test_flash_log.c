@@ -0,0 +1,168 @@
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "host_test.h"
+#include "flash_log.h"
+#include "hardware/flash.h"
+#include "fake_devices.h" //shim_flash_init
+
+//log em anel (firmware/flash_log.c) sobre a flash do shim: registros numerados (counts.v[0] = seq)
+//até o anel dar a volta, uma página parcial no flush, e depois reboots com páginas corrompidas
+//(CRC errado): uma no meio do anel, que só sai do log, e a mais nova, como uma gravação rasgada
+//por um reset, cujos registros se perdem e cujas seqs voltam a ser usadas na página livre seguinte.
+//Em cada boot, next_seq e o dump (do mais antigo ao mais novo, seqs contíguas) são conferidos
+#define PAGES_PER_SECTOR (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define NUM_PAGES        (FLASH_LOG_SECTORS * PAGES_PER_SECTOR)
+#define EXTRA_PAGES      40 //páginas além de uma volta no anel
+#define PARTIAL_RECORDS  3  //registros da página gravada pelo flush
+
+typedef struct {
+    uint32_t pages;
+    uint32_t first_seq; //do registro mais antigo
+    uint32_t next_seq;  //após o registro mais novo
+    uint32_t boots;     //bits dos boots presentes
+} dump_summary_t;
+
+//CRC errado numa página gravada: o pad do cabeçalho (0xFFFFFFFF, coberto pelo CRC) perde bits, como
+//numa gravação interrompida (NOR só leva bits de 1 para 0)
+static void corrupt_page(uint32_t page) {
+    uint8_t* p = (uint8_t*)(XIP_BASE + FLASH_LOG_OFFSET) + (size_t)page * FLASH_PAGE_SIZE;
+    p[offsetof(flash_log_page_header_t, pad)] = 0x00;
+}
+
+static uint32_t appended = 0; //seq do próximo registro
+
+static int append(uint32_t count) {
+    int pages = 0;
+    for (uint32_t i = 0; i < count; i++, appended++) {
+        flash_log_record_t r;
+        memset(&r, 0, sizeof(r));
+        r.counts.v[0] = (int32_t)appended;
+        for (int h = 0; h < 3; h++)
+            r.pred_centi[h] = FLASH_LOG_NO_PREDICTION;
+        int rc = flash_log_append(&r, 31ull * appended * 1000);
+        CHECK(rc >= 0, "registro %lu: flash_log_append retornou %d", (unsigned long)appended, rc);
+        pages += rc == 1;
+    }
+    return pages;
+}
+
+static int hex_nibble(char c) {
+    return c <= '9' ? c - '0' : c - 'a' + 10;
+}
+
+//executa flash_log_dump() com o stdout num arquivo temporário e confere as páginas: cabeçalho
+//válido, seqs contíguas entre páginas (exceto a página corrompida que começa em hole_seq) e registro
+//i de cada página com counts.v[0] = first_seq + i
+static dump_summary_t dump_and_check(const char* stage, uint32_t hole_seq) {
+    dump_summary_t sum = {0, 0, 0, 0};
+    FILE* tmp = tmpfile();
+    fflush(stdout);
+    int saved = dup(STDOUT_FILENO);
+    dup2(fileno(tmp), STDOUT_FILENO);
+    flash_log_dump();
+    fflush(stdout);
+    dup2(saved, STDOUT_FILENO);
+    close(saved);
+    rewind(tmp);
+
+    static char line[2 * FLASH_PAGE_SIZE + 64];
+    bool begin = false, end = false;
+    while (fgets(line, sizeof(line), tmp)) {
+        if (!strncmp(line, "FLASH_LOG BEGIN", 15)) begin = true;
+        if (!strncmp(line, "FLASH_LOG END", 13)) end = true;
+        if (line[0] != 'P') continue;
+        uint8_t bytes[FLASH_PAGE_SIZE];
+        for (size_t b = 0; b < FLASH_PAGE_SIZE; b++)
+            bytes[b] = (uint8_t)(hex_nibble(line[2 + 2 * b]) << 4 | hex_nibble(line[3 + 2 * b]));
+        flash_log_page_header_t h;
+        memcpy(&h, bytes, sizeof(h));
+        CHECK(h.count >= 1 && h.count <= FLASH_LOG_RECORDS_PER_PAGE, "%s: página %lu com %u registros", stage,
+              (unsigned long)sum.pages, h.count);
+        if (sum.pages == 0)
+            sum.first_seq = h.first_seq;
+        else if (h.first_seq != sum.next_seq)
+            CHECK(sum.next_seq == hole_seq && h.first_seq == hole_seq + FLASH_LOG_RECORDS_PER_PAGE,
+                  "%s: página %lu começa na seq %lu, esperado %lu", stage, (unsigned long)sum.pages,
+                  (unsigned long)h.first_seq, (unsigned long)sum.next_seq);
+        for (uint32_t i = 0; i < h.count && i < FLASH_LOG_RECORDS_PER_PAGE; i++) {
+            flash_log_record_t r;
+            memcpy(&r, bytes + sizeof(h) + i * sizeof(r), sizeof(r));
+            CHECK((uint32_t)r.counts.v[0] == h.first_seq + i, "%s: seq %lu com o registro %ld", stage,
+                  (unsigned long)(h.first_seq + i), (long)r.counts.v[0]);
+        }
+        sum.next_seq = h.first_seq + h.count;
+        sum.boots |= 1u << (h.boot & 31);
+        sum.pages++;
+    }
+    fclose(tmp);
+    CHECK(begin && end, "%s: dump sem FLASH_LOG BEGIN/END", stage);
+    return sum;
+}
+
+int main(void) {
+    shim_flash_init(); //flash apagada (sem PICO_SHIM_FLASH)
+
+    //boot 1: uma volta inteira no anel e mais EXTRA_PAGES páginas, depois uma página parcial
+    flash_log_init();
+    CHECK(flash_log_info()->boot == 1 && flash_log_info()->next_seq == 0 && flash_log_info()->pages == 0,
+          "flash apagada: boot %lu, next_seq %lu, %lu páginas", (unsigned long)flash_log_info()->boot,
+          (unsigned long)flash_log_info()->next_seq, (unsigned long)flash_log_info()->pages);
+    int written = append((NUM_PAGES + EXTRA_PAGES) * FLASH_LOG_RECORDS_PER_PAGE + PARTIAL_RECORDS);
+    CHECK(written == NUM_PAGES + EXTRA_PAGES, "%d páginas gravadas, esperado %d", written, NUM_PAGES + EXTRA_PAGES);
+    CHECK(flash_log_flush() == 1, "flush da página parcial");
+    uint32_t total_pages = NUM_PAGES + EXTRA_PAGES + 1;
+    //a escrita apaga o setor inteiro ao entrar nele: o setor atual só tem as páginas já gravadas
+    uint32_t live_pages = NUM_PAGES - PAGES_PER_SECTOR + total_pages % PAGES_PER_SECTOR;
+    uint32_t oldest_seq = (total_pages - live_pages) * FLASH_LOG_RECORDS_PER_PAGE;
+    //a primeira volta grava em setores apagados; depois, um apagamento por setor em que a escrita entra
+    uint32_t erases = (total_pages - NUM_PAGES + PAGES_PER_SECTOR - 1) / PAGES_PER_SECTOR;
+    CHECK(flash_log_info()->erases == erases, "%lu setores apagados, esperado %lu",
+          (unsigned long)flash_log_info()->erases, (unsigned long)erases);
+    CHECK(flash_log_info()->pages == live_pages, "%lu páginas no anel, esperado %lu",
+          (unsigned long)flash_log_info()->pages, (unsigned long)live_pages);
+    dump_summary_t d = dump_and_check("boot 1", UINT32_MAX);
+    CHECK(d.pages == live_pages && d.first_seq == oldest_seq && d.next_seq == appended,
+          "boot 1: dump com %lu páginas, seqs %lu..%lu; esperado %lu páginas, %lu..%lu", (unsigned long)d.pages,
+          (unsigned long)d.first_seq, (unsigned long)d.next_seq, (unsigned long)live_pages,
+          (unsigned long)oldest_seq, (unsigned long)appended);
+
+    //boot 2: CRC errado numa página do meio do anel (a mais antiga + 100): só ela sai do log
+    uint32_t newest = (total_pages - 1) % NUM_PAGES;
+    uint32_t middle = (newest + NUM_PAGES - live_pages + 1 + 100) % NUM_PAGES;
+    uint32_t hole_seq = oldest_seq + 100 * FLASH_LOG_RECORDS_PER_PAGE;
+    corrupt_page(middle);
+    flash_log_init();
+    CHECK(flash_log_info()->boot == 2, "boot %lu após o boot 1", (unsigned long)flash_log_info()->boot);
+    CHECK(flash_log_info()->next_seq == appended, "página do meio corrompida: next_seq %lu, esperado %lu",
+          (unsigned long)flash_log_info()->next_seq, (unsigned long)appended);
+    CHECK(flash_log_info()->pages == live_pages - 1, "%lu páginas válidas, esperado %lu",
+          (unsigned long)flash_log_info()->pages, (unsigned long)(live_pages - 1));
+    d = dump_and_check("boot 2", hole_seq); //a página corrompida abre um buraco de 7 seqs no meio
+    CHECK(d.pages == live_pages - 1 && d.first_seq == oldest_seq && d.next_seq == appended,
+          "boot 2: dump com %lu páginas, seqs %lu..%lu", (unsigned long)d.pages, (unsigned long)d.first_seq,
+          (unsigned long)d.next_seq);
+    CHECK(append(2 * FLASH_LOG_RECORDS_PER_PAGE) == 2, "boot 2: páginas cheias não gravadas");
+
+    //boot 3: a página mais nova rasgada (CRC errado): seus registros se perdem, a seq volta para o
+    //início dela e a próxima gravação vai para a página livre seguinte, não por cima da rasgada
+    corrupt_page((newest + 2) % NUM_PAGES); //segunda página do boot 2
+    flash_log_init();
+    uint32_t torn_seq = appended - FLASH_LOG_RECORDS_PER_PAGE;
+    CHECK(flash_log_info()->boot == 3 && flash_log_info()->next_seq == torn_seq,
+          "página mais nova rasgada: boot %lu, next_seq %lu, esperado 3 e %lu", (unsigned long)flash_log_info()->boot,
+          (unsigned long)flash_log_info()->next_seq, (unsigned long)torn_seq);
+    appended = torn_seq;
+    CHECK(append(FLASH_LOG_RECORDS_PER_PAGE) == 1, "boot 3: página cheia não gravada");
+    d = dump_and_check("boot 3", hole_seq);
+    //páginas: as do boot 1 menos a do meio, a primeira do boot 2 e a nova do boot 3
+    CHECK(d.next_seq == appended && d.pages == live_pages + 1,
+          "boot 3: dump termina na seq %lu com %lu páginas, esperado %lu e %lu", (unsigned long)d.next_seq,
+          (unsigned long)d.pages, (unsigned long)appended, (unsigned long)(live_pages + 1));
+    CHECK(d.boots == ((1u << 1) | (1u << 2) | (1u << 3)), "boot 3: boots no dump 0x%lx, esperado 1, 2 e 3",
+          (unsigned long)d.boots);
+    printf("[flash-log] %lu páginas gravadas (%u no anel), next_seq %lu; corrompidas: meio e mais nova\n",
+           (unsigned long)total_pages, (unsigned)live_pages, (unsigned long)flash_log_info()->next_seq);
+    HOST_TEST_END("flash-log");
+}
@@ -0,0 +1,136 @@
+#include <math.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "codegen_engine.h"
+#include "conv1d_engine_params.h"
+#include "sensor_fixed.h"
+#include "fake_devices.h" //fake_env_load_csv: linhas do dataset
+#include "scaler_params.h" //scaler do mesmo diretório do modelo, o que o fold_scaler.py dobrou
+
+//caminhos de entrada do firmware, compilados no host, sobre linhas do dataset:
+//  - z-score float (padrão): contagens -> unidades físicas em float -> (x - mean) / scale
+//  - z-score inteiro (FIXED_POINT_INPUT): sensor_fixed_normalize() com o scaler
+//  - modelo dobrado (FIXED_POINT_INPUT + MODEL_RAW_INPUT): sensor_fixed_normalize() com média 0 e
+//    escala 1 (unidades físicas em Q15.16) direto no motor gerado do modelo com o scaler dobrado
+//As features são comparadas com o z-score em double das mesmas contagens, e cada janela de 10 linhas
+//consecutivas passa pelo motor original (entrada em float) e pelo dobrado (entrada inteira).
+//As linhas vêm do CSV em argv[1] (data/temp.csv, se existir no build); sem ele, uma grade
+//determinística de ±4 desvios em torno da média do scaler, que cobre a faixa do treino
+#define NUM_GRID_ROWS 256
+#define Z_TOLERANCE   1e-4f //features normalizadas: alguns LSB de Q15.16 e o float da pressão (~918 hPa)
+#define TOLERANCE_C   1e-3f //mesma tolerância do --check do tools/fold_scaler.py
+
+namespace conv1d_engine {
+extern const codegen_engine_t engine;
+}
+namespace conv1d_raw_engine { //firmware/conv1d_engine.cpp sobre os pesos dobrados
+extern const codegen_engine_t engine;
+}
+
+using namespace conv1d_engine;
+
+//contagens como o AHT20 e o BMP280 falsos entregam ao driver: 20 bits do AHT20, °C x100 e Pa
+static sensor_counts_t row_counts(const fake_env_row_t* r) {
+    double h = fmin(fmax(r->hum_aht20, 0.0), 100.0);
+    sensor_counts_t c;
+    c.v[0] = (int32_t)fmin(lround((r->temp_aht20 + 50.0) * 1048576.0 / 200.0), 0xFFFFF);
+    c.v[1] = (int32_t)fmin(lround(h * 1048576.0 / 100.0), 0xFFFFF);
+    c.v[2] = (int32_t)lround(r->temp_bmp280 * 100.0);
+    c.v[3] = (int32_t)lround(r->press_bmp280 * 100.0);
+    return c;
+}
+
+//counts_to_physical() + normalize_feature() do main.c (aht20_convert calcula em double e grava float)
+static void float_features(const sensor_counts_t* c, float z[kFeatures]) {
+    float x[kFeatures] = {
+        (float)((float)c->v[0] * 200.0 / 1048576.0 - 50.0),
+        (float)((float)c->v[1] * 100.0 / 1048576.0),
+        c->v[2] / 100.0f,
+        c->v[3] / 100.0f,
+    };
+    for (int f = 0; f < kFeatures; f++)
+        z[f] = (x[f] - scaler_mean[f]) / scaler_scale[f];
+}
+
+static double exact_feature(const sensor_counts_t* c, int f) {
+    static const double unit[kFeatures] = {200.0 / 1048576.0, 100.0 / 1048576.0, 0.01, 0.01};
+    static const double origin[kFeatures] = {-50.0, 0.0, 0.0, 0.0};
+    return (c->v[f] * unit[f] + origin[f] - scaler_mean[f]) / scaler_scale[f];
+}
+
+static const fake_env_row_t* load_rows(const char* csv, size_t* count) {
+    if (csv) {
+        CHECK(fake_env_load_csv(csv), "CSV %s ilegível", csv);
+        return fake_env_rows(count);
+    }
+    static fake_env_row_t grid[NUM_GRID_ROWS];
+    uint32_t lcg = 2024;
+    for (int i = 0; i < NUM_GRID_ROWS; i++) {
+        float v[kFeatures];
+        for (int f = 0; f < kFeatures; f++) {
+            lcg = lcg * 1664525u + 1013904223u;
+            v[f] = scaler_mean[f] + ((lcg >> 8) * (1.0f / 16777216.0f) * 8.0f - 4.0f) * scaler_scale[f];
+        }
+        grid[i] = {v[0], v[1], v[2], v[3]};
+    }
+    *count = NUM_GRID_ROWS;
+    return grid;
+}
+
+int main(int argc, char** argv) {
+    static_assert(kFeatures == NUM_FEATURES, "motor com outras features");
+    size_t num_rows = 0;
+    const fake_env_row_t* rows = load_rows(argc > 1 ? argv[1] : NULL, &num_rows);
+    CHECK(num_rows >= (size_t)kWindow, "%zu linhas, janela de %d", num_rows, kWindow);
+
+    static const float raw_mean[NUM_FEATURES] = {0.0f, 0.0f, 0.0f, 0.0f};
+    static const float raw_scale[NUM_FEATURES] = {1.0f, 1.0f, 1.0f, 1.0f};
+    float* z_float = (float*)malloc(num_rows * kFeatures * sizeof(float));
+    float* z_fixed = (float*)malloc(num_rows * kFeatures * sizeof(float));
+    float* x_fixed = (float*)malloc(num_rows * kFeatures * sizeof(float));
+    float worst_float = 0.0f, worst_fixed = 0.0f;
+    for (size_t r = 0; r < num_rows; r++) {
+        sensor_counts_t c = row_counts(&rows[r]);
+        int32_t q[NUM_FEATURES];
+        float_features(&c, &z_float[r * kFeatures]);
+        sensor_fixed_init(scaler_mean, scaler_scale);
+        sensor_fixed_normalize(&c, q);
+        for (int f = 0; f < kFeatures; f++)
+            z_fixed[r * kFeatures + f] = (float)q[f] * (1.0f / (1 << SENSOR_FIXED_FRAC_BITS));
+        sensor_fixed_init(raw_mean, raw_scale);
+        sensor_fixed_normalize(&c, q);
+        for (int f = 0; f < kFeatures; f++)
+            x_fixed[r * kFeatures + f] = (float)q[f] * (1.0f / (1 << SENSOR_FIXED_FRAC_BITS));
+        for (int f = 0; f < kFeatures; f++) {
+            double exact = exact_feature(&c, f);
+            float d_float = (float)fabs(z_float[r * kFeatures + f] - exact);
+            float d_fixed = (float)fabs(z_fixed[r * kFeatures + f] - exact);
+            worst_float = d_float > worst_float ? d_float : worst_float;
+            worst_fixed = d_fixed > worst_fixed ? d_fixed : worst_fixed;
+            CHECK(d_float <= Z_TOLERANCE && d_fixed <= Z_TOLERANCE,
+                  "linha %zu, feature %d: z float %.6f, inteiro %.6f, exato %.6f", r, f,
+                  z_float[r * kFeatures + f], z_fixed[r * kFeatures + f], exact);
+        }
+    }
+
+    float worst_model = 0.0f;
+    int windows = 0;
+    for (size_t r = 0; r + kWindow <= num_rows; r++, windows++) {
+        float two_step[kHorizons], folded[kHorizons];
+        conv1d_engine::engine.invoke(&z_float[r * kFeatures], two_step);
+        conv1d_raw_engine::engine.invoke(&x_fixed[r * kFeatures], folded);
+        for (int h = 0; h < kHorizons; h++) {
+            float diff = fabsf(folded[h] - two_step[h]);
+            worst_model = diff > worst_model ? diff : worst_model;
+            CHECK(diff <= TOLERANCE_C, "janela %zu, horizonte %d: dobrado/inteiro %.5f, normalizado/float %.5f", r,
+                  h, folded[h], two_step[h]);
+        }
+    }
+    printf("[fold] %zu linhas (%s): z float %.2g, z inteiro %.2g do exato; %d janelas, dobrado/inteiro contra "
+           "normalizado/float %.2g °C\n", num_rows, argc > 1 ? argv[1] : "grade do scaler", worst_float,
+           worst_fixed, windows, worst_model);
+    free(z_float);
+    free(z_fixed);
+    free(x_fixed);
+    HOST_TEST_END("fold");
+}
@@ -0,0 +1,34 @@
+#include <math.h>
+#include "host_test.h"
+#include "codegen_engine.h"
+#include "gru_engine_params.h"
+#include "gru_test_vectors.h" //janelas e saídas das contas do Keras sobre os pesos crus (tools/gen_test_vectors.py)
+
+//motor GRU gerado do models/GRU/temperature_model.keras contra a referência de tools/gen_test_vectors.py:
+//GRUCell.call (reset_after) e Dense.call do Keras sobre os pesos do model.weights.h5 no layout do Keras,
+//em float64, sem passar pelo gerador do motor. Confere a transposição, a ordem dos portões z/r/h, os dois
+//bias e as densas; a tolerância cobre o float32 do motor nos 10 passos de recorrência
+#define TOLERANCE_C 1e-4f
+
+namespace gru_engine {
+extern const codegen_engine_t engine;
+}
+
+int main() {
+    static_assert(kTestWindow == gru_engine::kWindow && kTestFeatures == gru_engine::kFeatures &&
+                  kTestHorizons == gru_engine::kHorizons, "vetores de outro modelo");
+    float worst = 0.0f;
+    for (int w = 0; w < kTestWindows; w++) {
+        float out[kTestHorizons];
+        gru_engine::engine.invoke(test_windows[w], out);
+        for (int h = 0; h < kTestHorizons; h++) {
+            float diff = fabsf(out[h] - test_expected[w][h]);
+            worst = diff > worst ? diff : worst;
+            CHECK(diff <= TOLERANCE_C, "janela %d, horizonte %d: motor %.6f, Keras %.6f", w, h, out[h],
+                  test_expected[w][h]);
+        }
+    }
+    printf("[gru] %d janelas, diferença máx %.3g °C da referência do Keras (tolerância %.0e)\n", kTestWindows, worst,
+           TOLERANCE_C);
+    HOST_TEST_END("gru");
+}
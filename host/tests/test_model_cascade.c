@@ -0,0 +1,112 @@
+#include <math.h>
+#include "host_test.h"
+#include "model_cascade.h"
+#include "tflm_wrapper.h"
+
+//cascata (firmware/model_cascade.c) sobre dois modelos falsos no lugar do tflm_wrapper: temperatura
+//constante (variação zero, só o resíduo escala) e o barato errando por ERROR_C nos prazos de
+//wrong_seqs. Os prazos vêm com buracos, como falhas de leitura e prazos perdidos do agendador: o
+//resíduo do prazo s é o erro da previsão do prazo s - CASCADE_RESIDUAL_LAG, ou NAN se ela não existe,
+//nunca o da previsão feita CASCADE_RESIDUAL_LAG predições atrás
+#define NUM_SEQS    80
+#define TEMP_C      21.5f
+#define ERROR_C     1.0f //acima de CASCADE_RESIDUAL_C
+#define WINDOW      10
+#define FEATURES    4
+
+static const uint32_t missing_seqs[] = {16, 20, 21, 40, 41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51}; //buracos
+static const uint32_t wrong_seqs[] = {6, 9, 12, 33, 52, 60};
+
+static const model_descriptor_t models[2] = {
+    {.name = "barato", .window = WINDOW, .features = FEATURES, .horizons = 3, .raw_input = 1, .macs = 100},
+    {.name = "completo", .window = WINDOW, .features = FEATURES, .horizons = 3, .raw_input = 1, .macs = 1000},
+};
+static int active = 0;
+static uint32_t current_seq = 0;
+static float output[3];
+static int invokes[2];
+
+static bool listed(const uint32_t* list, size_t n, uint32_t seq) {
+    for (size_t i = 0; i < n; i++)
+        if (list[i] == seq) return true;
+    return false;
+}
+
+static bool wrong(uint32_t seq) {
+    return listed(wrong_seqs, sizeof(wrong_seqs) / sizeof(wrong_seqs[0]), seq);
+}
+
+int tflm_model_count(void) {
+    return 2;
+}
+
+const model_descriptor_t* tflm_model_info(int idx) {
+    return idx >= 0 && idx < 2 ? &models[idx] : NULL;
+}
+
+int tflm_select_model(int idx) {
+    active = idx;
+    return 0;
+}
+
+int tflm_active_model(void) {
+    return active;
+}
+
+float* tflm_output_ptr(int* nfloats) {
+    if (nfloats) *nfloats = 3;
+    return output;
+}
+
+int tflm_invoke(void) {
+    invokes[active]++;
+    for (int h = 0; h < 3; h++) //o completo acerta; o barato erra nos prazos de wrong_seqs
+        output[h] = TEMP_C + (active == 0 && wrong(current_seq) ? ERROR_C : 0.0f);
+    return 0;
+}
+
+int main(void) {
+    CHECK(model_cascade_init() == 0 && model_cascade_cheap() == 0 && model_cascade_full() == 1,
+          "barato %d, completo %d", model_cascade_cheap(), model_cascade_full());
+    float window[WINDOW * FEATURES];
+    for (int i = 0; i < WINDOW * FEATURES; i++)
+        window[i] = TEMP_C;
+
+    int predictions = 0, escalations = 0, realized = 0;
+    for (current_seq = 0; current_seq < NUM_SEQS; current_seq++) {
+        if (listed(missing_seqs, sizeof(missing_seqs) / sizeof(missing_seqs[0]), current_seq)) continue;
+        CHECK(model_cascade_invoke(window, current_seq) == 0, "prazo %lu: invoke falhou", (unsigned long)current_seq);
+        predictions++;
+        const cascade_stats_t* st = model_cascade_stats();
+        uint32_t source = current_seq - CASCADE_RESIDUAL_LAG; //prazo da previsão que realiza agora
+        bool has_source = current_seq >= CASCADE_RESIDUAL_LAG &&
+                          !listed(missing_seqs, sizeof(missing_seqs) / sizeof(missing_seqs[0]), source);
+        float expected = has_source ? (wrong(source) ? ERROR_C : 0.0f) : NAN;
+        if (has_source) {
+            realized++;
+            CHECK(fabsf(st->last_residual - expected) < 1e-5f, "prazo %lu: resíduo %.3f, esperado %.3f (prazo %lu)",
+                  (unsigned long)current_seq, st->last_residual, expected, (unsigned long)source);
+        } else {
+            CHECK(isnan(st->last_residual), "prazo %lu: resíduo %.3f sem a previsão do prazo %lu",
+                  (unsigned long)current_seq, st->last_residual, (unsigned long)source);
+        }
+        bool escalate = has_source && wrong(source);
+        escalations += escalate;
+        CHECK(st->last_escalated == escalate && tflm_active_model() == (escalate ? 1 : 0),
+              "prazo %lu: escalada %d (modelo %d), esperado %d", (unsigned long)current_seq, st->last_escalated,
+              tflm_active_model(), escalate);
+        CHECK(fabsf(output[0] - TEMP_C - (!escalate && wrong(current_seq) ? ERROR_C : 0.0f)) < 1e-5f,
+              "prazo %lu: saída %.3f do modelo errado", (unsigned long)current_seq, output[0]);
+    }
+    const cascade_stats_t* st = model_cascade_stats();
+    CHECK(st->predictions == (uint32_t)predictions && st->escalations == (uint32_t)escalations &&
+              st->by_residual == (uint32_t)escalations && st->by_slope == 0,
+          "estatísticas: %lu predições, %lu escaladas (%lu resíduo, %lu variação); esperado %d e %d",
+          (unsigned long)st->predictions, (unsigned long)st->escalations, (unsigned long)st->by_residual,
+          (unsigned long)st->by_slope, predictions, escalations);
+    CHECK(invokes[0] == predictions && invokes[1] == escalations, "invokes: barato %d, completo %d", invokes[0],
+          invokes[1]);
+    printf("[cascade] %d predições em %d prazos com buracos: %d resíduos realizados, %d escaladas\n", predictions,
+           NUM_SEQS, realized, escalations);
+    HOST_TEST_END("cascade");
+}
@@ -0,0 +1,71 @@
+#include "host_test.h"
+#include "power_manager.h"
+#include "hardware/clocks.h"
+#include "hardware/pll.h"
+#include "hardware/uart.h"
+#include "fake_devices.h" //shim_advance_us, shim_uart_baud
+
+//trocas de clock do modo LOW_POWER (firmware/power_manager.c) sobre os clocks do shim, que seguem o
+//SDK 2.1.0: clk_peri no clk_sys acompanha cada troca do clk_sys, e os set_sys_clock_* o deixam lá.
+//Em cada fase de NUM_CYCLES ciclos de amostragem: clk_sys da fase (48 MHz do pll_usb com stdio USB,
+//POWER_BOOST_KHZ do pll_sys), pll_sys desligado no clock baixo, clk_peri parado nos 48 MHz do pll_usb
+//com a UART do stdio no baudrate do boot, e os dois I2C com o divisor refeito para o clk_sys atual
+#define NUM_CYCLES   20
+#define LOW_KHZ      48000 //clock baixo com stdio USB (o shim liga UART e USB, como o firmware)
+#define I2C0_BAUD    100000
+#define I2C1_BAUD    400000
+
+static const power_phase_t cycle[] = {POWER_PHASE_ACQUIRE, POWER_PHASE_INFER, POWER_PHASE_OUTPUT,
+                                      POWER_PHASE_SLEEP};
+static const uint64_t cycle_us[] = {30000, 12000, 40000, 30900000};
+
+static void check_clocks(const char* when) {
+    uint32_t sys_khz = clock_get_hz(clk_sys) / KHZ;
+    bool boost = sys_khz == POWER_BOOST_KHZ;
+    CHECK(boost || sys_khz == LOW_KHZ, "%s: clk_sys a %lu kHz", when, (unsigned long)sys_khz);
+    CHECK(pll_sys->on == boost, "%s: pll_sys %s com clk_sys a %lu kHz", when, pll_sys->on ? "ligado" : "desligado",
+          (unsigned long)sys_khz);
+    CHECK(clock_get_hz(clk_peri) == 48 * MHZ, "%s: clk_peri a %lu Hz", when, (unsigned long)clock_get_hz(clk_peri));
+    CHECK(shim_uart_baud(uart_default) == PICO_DEFAULT_UART_BAUD_RATE, "%s: UART a %u baud, esperado %u", when,
+          shim_uart_baud(uart_default), PICO_DEFAULT_UART_BAUD_RATE);
+    CHECK(i2c0->clk_sys_hz == clock_get_hz(clk_sys) && i2c1->clk_sys_hz == clock_get_hz(clk_sys),
+          "%s: I2C com divisor de %lu/%lu Hz, clk_sys %lu Hz", when, (unsigned long)i2c0->clk_sys_hz,
+          (unsigned long)i2c1->clk_sys_hz, (unsigned long)clock_get_hz(clk_sys));
+}
+
+int main(void) {
+    i2c_init(i2c0, I2C0_BAUD);
+    i2c_init(i2c1, I2C1_BAUD);
+    power_register_i2c(i2c0, I2C0_BAUD);
+    power_register_i2c(i2c1, I2C1_BAUD);
+    power_init();
+    check_clocks("power_init");
+    CHECK(clock_get_hz(clk_sys) == LOW_KHZ * KHZ, "power_init: clk_sys a %lu Hz, esperado o clock baixo",
+          (unsigned long)clock_get_hz(clk_sys));
+
+    for (int n = 0; n < NUM_CYCLES; n++) {
+        for (size_t p = 0; p < sizeof(cycle) / sizeof(cycle[0]); p++) {
+            power_phase(cycle[p]);
+            uint32_t expected = cycle[p] == POWER_PHASE_INFER || cycle[p] == POWER_PHASE_OUTPUT ? POWER_BOOST_KHZ
+                                                                                               : LOW_KHZ;
+            char when[48];
+            snprintf(when, sizeof(when), "ciclo %d, fase %s", n, power_phase_name(cycle[p]));
+            CHECK(clock_get_hz(clk_sys) == expected * KHZ, "%s: clk_sys a %lu Hz, esperado %lu kHz", when,
+                  (unsigned long)clock_get_hz(clk_sys), (unsigned long)expected);
+            check_clocks(when);
+            shim_advance_us(cycle_us[p]);
+        }
+    }
+
+    const power_stats_t* st = power_stats();
+    CHECK(st->predictions == NUM_CYCLES, "%lu predições, esperado %d", (unsigned long)st->predictions, NUM_CYCLES);
+    CHECK(st->transitions == 2 * NUM_CYCLES, "%lu trocas de clk_sys, esperado %d (sobe no invoke, desce no sono)",
+          (unsigned long)st->transitions, 2 * NUM_CYCLES);
+    CHECK(st->khz[POWER_PHASE_SLEEP] == LOW_KHZ && st->khz[POWER_PHASE_INFER] == POWER_BOOST_KHZ,
+          "clocks por fase: sono %lu, inferência %lu kHz", (unsigned long)st->khz[POWER_PHASE_SLEEP],
+          (unsigned long)st->khz[POWER_PHASE_INFER]);
+    printf("[power] %d ciclos, %lu trocas de clk_sys (%.1f us cada): clk_peri %lu MHz, UART %u baud em todas as "
+           "fases\n", NUM_CYCLES, (unsigned long)st->transitions, (double)st->transition_us / st->transitions,
+           (unsigned long)(clock_get_hz(clk_peri) / MHZ), shim_uart_baud(uart_default));
+    HOST_TEST_END("power");
+}
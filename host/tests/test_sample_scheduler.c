@@ -0,0 +1,63 @@
+#include <stdlib.h>
+#include "host_test.h"
+#include "sample_scheduler.h"
+#include "fake_devices.h" //shim_advance_us: trabalho do ciclo em tempo virtual
+#include "pico/time.h"
+
+//agenda das amostras (firmware/sample_scheduler.c) ao longo de 24 h de tempo virtual do shim, no laço
+//do main.c: WFE até o alarme ou IDLE_POLL_MS e, a cada amostra, um ciclo de 80-100 ms (aquisição,
+//inferência e display) que não pode se somar ao período. Cada início deve cair na grade
+//t0 + k * período com atraso de no máximo MAX_LATENESS_US (o alarme dispara no prazo em tempo
+//virtual; sobra o tempo real entre o pulo e o despertar), e a deriva acumulada deve ficar nesse
+//mesmo limite até o fim do dia. Um ciclo de OVERRUN_PERIODS períodos no meio conta os dois prazos
+//que vencem durante ele como perdidos, e a amostra seguinte sai no prazo depois deles, na grade original
+#define PERIOD_MS        31000
+#define FIRST_DELAY_MS   31000
+#define IDLE_POLL_MS     100
+#define DAY_SAMPLES      (24 * 3600 * 1000 / PERIOD_MS)
+#define MAX_LATENESS_US  500
+#define OVERRUN_AT       1000 //amostra cujo ciclo passa do período
+#define OVERRUN_PERIODS  2.3
+
+int main(void) {
+    const uint64_t period_us = (uint64_t)PERIOD_MS * 1000;
+    uint64_t begin = time_us_64();
+    uint64_t t0 = begin + (uint64_t)FIRST_DELAY_MS * 1000;
+    sample_scheduler_init(PERIOD_MS, FIRST_DELAY_MS);
+
+    uint32_t k = 0; //índice esperado na grade
+    int64_t worst_late = 0, worst_drift = 0;
+    uint32_t wakeups = 0;
+    for (uint32_t n = 0; n < DAY_SAMPLES; n++) {
+        while (!sample_scheduler_wait(IDLE_POLL_MS))
+            wakeups++; //comandos do serial e relógio do checkpoint no firmware
+        uint64_t start = time_us_64();
+        const sample_scheduler_stats_t* st = sample_scheduler_stats();
+        int64_t late = (int64_t)(start - (t0 + k * period_us));
+        worst_late = late > worst_late ? late : worst_late;
+        worst_drift = llabs(st->drift_us) > worst_drift ? llabs(st->drift_us) : worst_drift;
+        CHECK(late >= 0 && late <= MAX_LATENESS_US, "amostra %lu (prazo %lu): atraso %lld us", (unsigned long)n,
+              (unsigned long)k, (long long)late);
+        CHECK(st->seq == k, "amostra %lu: seq %lu no prazo %lu", (unsigned long)n, (unsigned long)st->seq,
+              (unsigned long)k);
+        CHECK(llabs(st->drift_us) <= MAX_LATENESS_US, "amostra %lu: deriva acumulada %lld us", (unsigned long)n,
+              (long long)st->drift_us);
+        k++;
+        uint64_t work_us = 80000 + (n * 7919u) % 20000; //ciclo variável, sempre menor que o período
+        if (n == OVERRUN_AT) {
+            work_us = (uint64_t)(OVERRUN_PERIODS * period_us);
+            k += (uint32_t)OVERRUN_PERIODS; //prazos que vencem durante o ciclo longo
+        }
+        shim_advance_us(work_us);
+    }
+
+    const sample_scheduler_stats_t* st = sample_scheduler_stats();
+    CHECK(st->samples == DAY_SAMPLES, "%lu amostras, esperado %d", (unsigned long)st->samples, DAY_SAMPLES);
+    CHECK(st->missed == (uint32_t)OVERRUN_PERIODS, "%lu prazos perdidos, esperado %u (ciclo de %.1f períodos)",
+          (unsigned long)st->missed, (unsigned)OVERRUN_PERIODS, OVERRUN_PERIODS);
+    CHECK(st->lateness_min_us >= 0, "início antes do prazo: %ld us", (long)st->lateness_min_us);
+    printf("[scheduler] %lu amostras em %.1f h virtuais (%lu despertares ociosos): atraso máx %lld us, "
+           "deriva máx %lld us, %lu prazos perdidos\n", (unsigned long)st->samples, (double)(time_us_64() - begin) / 3.6e9,
+           (unsigned long)wakeups, (long long)worst_late, (long long)worst_drift, (unsigned long)st->missed);
+    HOST_TEST_END("scheduler");
+}
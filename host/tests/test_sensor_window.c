@@ -0,0 +1,52 @@
+#include <string.h>
+#include "host_test.h"
+#include "sensor_window.h"
+#include "temperature_model.h" //feature_names[] na ordem do treino
+
+//janela cronológica do firmware contra as sequências do create_sequences() do notebook:
+//X[i] = data.iloc[i:i+WINDOW_SIZE][features], ou seja, [passo de tempo][feature] com a mais antiga
+//primeiro e as features na ordem Temp_AHT20, Umid_AHT20, Temp_BMP280, Press_BMP280. Cada linha
+//empurrada tem valores únicos (100 * linha + feature), então qualquer troca de passo ou de feature
+//aparece; são linhas suficientes para várias voltas no anel espelhado
+#define NUM_ROWS 37
+
+static const char* const notebook_features[NUM_FEATURES] = {
+    "Temp_AHT20_C", "Umid_AHT20_pct", "Temp_BMP280_C", "Press_BMP280_hPa",
+};
+
+static float row_value(int row, int feature) {
+    return 100.0f * row + feature;
+}
+
+int main(void) {
+    for (int f = 0; f < NUM_FEATURES; f++)
+        CHECK(strcmp(feature_names[f], notebook_features[f]) == 0, "feature %d: modelo %s, notebook %s", f,
+              feature_names[f], notebook_features[f]);
+
+    static sensor_window_t w;
+    sensor_window_init(&w);
+    int windows = 0;
+    for (int row = 0; row < NUM_ROWS; row++) {
+        float sample[NUM_FEATURES];
+        for (int f = 0; f < NUM_FEATURES; f++)
+            sample[f] = row_value(row, f);
+        sensor_window_push(&w, sample);
+        CHECK(sensor_window_full(&w) == (row + 1 >= WINDOW_SIZE), "linha %d: janela cheia = %d", row,
+              sensor_window_full(&w));
+        if (!sensor_window_full(&w)) continue;
+
+        //X[i] do create_sequences, com i = primeira linha da janela
+        int i = row + 1 - WINDOW_SIZE;
+        const float* view = sensor_window_view(&w);
+        CHECK(view >= &w.rows[0][0] && view + WINDOW_SIZE * NUM_FEATURES <= &w.rows[2 * WINDOW_SIZE][0],
+              "linha %d: visão fora do anel (cópia?)", row);
+        for (int t = 0; t < WINDOW_SIZE; t++)
+            for (int f = 0; f < NUM_FEATURES; f++)
+                CHECK(view[t * NUM_FEATURES + f] == row_value(i + t, f),
+                      "X[%d][%d][%s]: janela %.0f, esperado %.0f", i, t, notebook_features[f],
+                      view[t * NUM_FEATURES + f], row_value(i + t, f));
+        windows++;
+    }
+    printf("[window] %d janelas [%d][%d] na ordem do create_sequences\n", windows, WINDOW_SIZE, NUM_FEATURES);
+    HOST_TEST_END("window");
+}
@@ -0,0 +1,43 @@
+#include <math.h>
+#include <stdlib.h>
+#include "host_test.h"
+#include "tflm_wrapper.h"
+#include "model_registry_data.h" //MODEL_REGISTRY_PLANNED_ARENA_BYTES e MODEL_REGISTRY_ARENA_MARGIN
+
+//plano de tools/plan_arena.py contra o AllocateTensors() do TFLM real (só no build host com
+//INFERENCE_ENGINE=TFLM). Com o índice de um modelo, carrega só ele e compara o uso com o plano dele
+//mais a margem; sem argumento, carrega o registro inteiro na arena compartilhada e compara com
+//MODEL_REGISTRY_PLANNED_ARENA_BYTES. A arena alocada continua em TFLM_ARENA_MIN, então o teste
+//mede o uso real sem depender do plano para caber. Cada modelo carregado também faz um invoke
+//(com TFLM_OFFLINE_PLAN, os offsets embutidos passam pelo AllocateTensors() e pelo invoke)
+int main(int argc, char** argv) {
+    int only = argc > 1 ? atoi(argv[1]) : -1;
+    CHECK(only < MODEL_REGISTRY_COUNT, "modelo %d fora do registro (%d modelos)", only, MODEL_REGISTRY_COUNT);
+    if (only >= MODEL_REGISTRY_COUNT) HOST_TEST_END("tflm_arena");
+
+    uint32_t mask = only < 0 ? (1u << MODEL_REGISTRY_COUNT) - 1 : 1u << only;
+    int rc = tflm_init_models(mask);
+    CHECK(rc == 0, "tflm_init_models(0x%lx) retornou %d", (unsigned long)mask, rc);
+    if (rc != 0) HOST_TEST_END("tflm_arena");
+
+    int used = tflm_arena_used_bytes();
+    long planned = MODEL_REGISTRY_PLANNED_ARENA_BYTES;
+    if (only >= 0) planned = (long)tflm_model_info(only)->arena_bytes + MODEL_REGISTRY_ARENA_MARGIN;
+    CHECK(used > 0 && used <= planned, "%s: arena usada %d bytes, planejada %ld (com margem %d)",
+          only < 0 ? "registro" : tflm_model_info(only)->name, used, planned, MODEL_REGISTRY_ARENA_MARGIN);
+
+    for (int i = 0; i < MODEL_REGISTRY_COUNT; i++) {
+        if (!(mask & (1u << i))) continue;
+        CHECK(tflm_select_model(i) == 0, "%s não inicializado", tflm_model_info(i)->name);
+        int n = 0;
+        float* in = tflm_input_ptr(&n);
+        for (int k = 0; k < n; k++) in[k] = 0.1f * (float)(k % 7) - 0.3f; //janela normalizada qualquer
+        CHECK(tflm_invoke() == 0, "%s: invoke falhou", tflm_model_info(i)->name);
+        float* out = tflm_output_ptr(&n);
+        for (int h = 0; h < n; h++)
+            CHECK(isfinite(out[h]), "%s: saída %d não finita", tflm_model_info(i)->name, h);
+    }
+    printf("[tflm_arena] %s: arena usada %d de %ld bytes planejados (%d alocados)\n",
+           only < 0 ? "registro" : tflm_model_info(only)->name, used, planned, MODEL_REGISTRY_ARENA_BYTES);
+    HOST_TEST_END("tflm_arena");
+}
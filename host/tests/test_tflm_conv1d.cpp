@@ -0,0 +1,49 @@
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "codegen_engine.h"
+#include "conv1d_engine_params.h"
+#include "conv1d_test_vectors.h" //janelas e saídas do interpretador de referência (tools/gen_test_vectors.py)
+#include "tflm_wrapper.h"
+
+//motor Conv1D gerado e interpretador de referência em Python contra o MicroInterpreter do TFLM real,
+//com o mesmo CONV1D_ENGINE_MODEL num registro próprio do teste (só no build host com INFERENCE_ENGINE=TFLM).
+//Os três leem os pesos de caminhos diferentes: o TFLM do flatbuffer, o motor e a referência pelo
+//tools/tflite_reader.py, então um erro de layout na leitura dos pesos aparece aqui e não em
+//test_conv1d_engine. Os kernels de referência do TFLM somam o bias depois do kernel × canais: a tolerância
+//cobre essa ordem de acumulação diferente, não mais que alguns ULPs em cada saída
+#define TOLERANCE_C 1e-3f
+
+namespace conv1d_engine {
+extern const codegen_engine_t engine;
+}
+
+int main() {
+    static_assert(kTestWindow == conv1d_engine::kWindow && kTestFeatures == conv1d_engine::kFeatures &&
+                  kTestHorizons == conv1d_engine::kHorizons, "vetores de outro modelo");
+    int rc = tflm_init();
+    CHECK(rc == 0, "tflm_init() retornou %d", rc);
+    if (rc != 0) HOST_TEST_END("tflm_conv1d");
+    CHECK(!tflm_model_is_int8(), "registro do teste com modelo int8");
+
+    float worst_engine = 0.0f, worst_ref = 0.0f;
+    for (int w = 0; w < kTestWindows; w++) {
+        int n = 0;
+        memcpy(tflm_input_ptr(&n), test_windows[w], sizeof(test_windows[w]));
+        CHECK(tflm_invoke() == 0, "janela %d: invoke falhou", w);
+        const float* tflm = tflm_output_ptr(&n);
+        float engine[kTestHorizons];
+        conv1d_engine::engine.invoke(test_windows[w], engine);
+        for (int h = 0; h < kTestHorizons; h++) {
+            float de = fabsf(engine[h] - tflm[h]), dr = fabsf(test_expected[w][h] - tflm[h]);
+            worst_engine = de > worst_engine ? de : worst_engine;
+            worst_ref = dr > worst_ref ? dr : worst_ref;
+            CHECK(de <= TOLERANCE_C, "janela %d, horizonte %d: motor %.6f, TFLM %.6f", w, h, engine[h], tflm[h]);
+            CHECK(dr <= TOLERANCE_C, "janela %d, horizonte %d: referência %.6f, TFLM %.6f", w, h,
+                  test_expected[w][h], tflm[h]);
+        }
+    }
+    printf("[tflm_conv1d] %d janelas, diferença máx para o TFLM: motor %.3g, referência %.3g °C (tolerância %.0e)\n",
+           kTestWindows, worst_engine, worst_ref, TOLERANCE_C);
+    HOST_TEST_END("tflm_conv1d");
+}
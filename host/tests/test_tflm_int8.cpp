@@ -0,0 +1,43 @@
+#include <math.h>
+#include <string.h>
+#include "host_test.h"
+#include "tflm_wrapper.h"
+#include "conv1d_test_vectors.h" //janelas normalizadas fixas (tools/gen_test_vectors.py)
+
+//models/Conv1D/temperature_model_int8.h (seção 7.4 do notebook CNN 1D) no TFLM real, contra o modelo
+//float32 do firmware no mesmo registro (float em model_registry[0], int8 em [1]). Antes de versionar o
+//artefato: ele precisa carregar (operadores e versões aceitos pelos kernels, quantização nas bordas do
+//invoke) e ficar perto do float32 em todas as janelas. A tolerância cobre o erro de quantização
+//esperado da PTQ com ativações int8, não diferenças de layout dos pesos
+#define TOLERANCE_C 0.25f
+
+int main() {
+    int rc = tflm_init();
+    CHECK(rc == 0, "tflm_init() retornou %d", rc);
+    if (rc != 0) HOST_TEST_END("tflm_int8");
+    CHECK(tflm_model_count() == 2, "%d modelos no registro, esperado float32 e int8", tflm_model_count());
+
+    float worst = 0.0f, sum = 0.0f;
+    for (int w = 0; w < kTestWindows; w++) {
+        float out[2][kTestHorizons];
+        for (int m = 0; m < 2; m++) {
+            CHECK(tflm_select_model(m) == 0, "modelo %d não inicializado", m);
+            CHECK(tflm_model_is_int8() == m, "%s: int8 = %d", tflm_model_info(m)->name, tflm_model_is_int8());
+            int n = 0;
+            memcpy(tflm_input_ptr(&n), test_windows[w], sizeof(test_windows[w]));
+            CHECK(n == kTestWindow * kTestFeatures, "entrada de %d floats", n);
+            CHECK(tflm_invoke() == 0, "janela %d: invoke de %s falhou", w, tflm_model_info(m)->name);
+            memcpy(out[m], tflm_output_ptr(&n), sizeof(out[m]));
+        }
+        for (int h = 0; h < kTestHorizons; h++) {
+            float diff = fabsf(out[1][h] - out[0][h]);
+            worst = diff > worst ? diff : worst;
+            sum += diff;
+            CHECK(diff <= TOLERANCE_C, "janela %d, horizonte %d: int8 %.4f, float32 %.4f", w, h, out[1][h],
+                  out[0][h]);
+        }
+    }
+    printf("[tflm_int8] %d janelas, int8 - float32: média %.4f, máx %.4f °C (tolerância %.2f)\n", kTestWindows,
+           sum / (kTestWindows * kTestHorizons), worst, TOLERANCE_C);
+    HOST_TEST_END("tflm_int8");
+}
@@ -0,0 +1,26 @@
+// Scaler parameters for normalization
+// Copied from models/Conv1D/scaler_params.h (CNN 1D notebook export): the GRU notebook's
+// export cell (6.2) was never run. Both notebooks fit the same StandardScaler on the same
+// training split, and the GRU notebook's printed means/stds match these values to 4 decimals.
+// Replace with the GRU notebook's own export when it is run.
+
+#ifndef SCALER_PARAMS_H
+#define SCALER_PARAMS_H
+
+// Mean values
+const float scaler_mean[] = {
+    20.276101f,  // Temp_AHT20_C
+    66.718630f,  // Umid_AHT20_pct
+    21.759548f,  // Temp_BMP280_C
+    918.015285f  // Press_BMP280_hPa
+};
+
+// Scale values
+const float scaler_scale[] = {
+    3.294128f,  // Temp_AHT20_C
+    13.480684f,  // Umid_AHT20_pct
+    3.191886f,  // Temp_BMP280_C
+    2.106629f  // Press_BMP280_hPa
+};
+
+#endif // SCALER_PARAMS_H
@@ -0,0 +1,117 @@
+"""
+Decodifica o log em anel da flash (firmware/flash_log.c) para CSV.
+
+Aceita as duas formas de leitura do log:
+  - captura do serial depois do comando 'l' (linhas "P <512 hex>" entre FLASH_LOG BEGIN/END),
+    ex.: a saída de `screen`/`minicom` salva em arquivo, ou de temperature_prediction_host;
+  - imagem binária da flash inteira (picotool save -a, ou o arquivo PICO_SHIM_FLASH do host),
+    com a partição localizada pelos mesmos tamanhos de firmware/flash_layout.h.
+
+Cada página tem o CRC-32 conferido; páginas corrompidas são contadas e descartadas. A saída usa os
+nomes de coluna de data/temp.csv para as leituras, então pode ser reproduzida pelo alvo replay
+(PICO_SHIM_SCRIPT), seguidas das previsões gravadas (vazias enquanto a janela não estava cheia).
+
+Uso: python3 tools/flash_log_dump.py <captura.txt|flash.bin> [saida.csv]
+                                     [--flash-size BYTES] [--log-sectors N] [--checkpoint-sectors N]
+"""
+import argparse
+import struct
+import sys
+import zlib
+
+PAGE_SIZE = 256
+SECTOR_SIZE = 4096
+LOG_MAGIC = 0x474F4C46
+RECORDS_PER_PAGE = 7
+NO_PREDICTION = -32768
+
+#flash_log_page_header_t e flash_log_record_t (little-endian, 32 bytes cada)
+HEADER = struct.Struct('<IIIHHQII')
+RECORD = struct.Struct('<I4i3hHI')
+CRC_OFFSET = 24
+
+COLUMNS = ['boot', 'seq', 't_ms', 'Temp_AHT20_C', 'Umid_AHT20_pct', 'Temp_BMP280_C', 'Press_BMP280_hPa',
+           'pred_5min_C', 'pred_10min_C', 'pred_15min_C', 'invoke_us']
+
+
+def page_valid(page):
+    magic, _, _, count, _, _, crc, _ = HEADER.unpack_from(page)
+    if magic != LOG_MAGIC or not 1 <= count <= RECORDS_PER_PAGE:
+        return False
+    zeroed = page[:CRC_OFFSET] + b'\0\0\0\0' + page[CRC_OFFSET + 4:]
+    return zlib.crc32(zeroed) == crc
+
+
+def pages_from_capture(text):
+    pages = []
+    for line in text.splitlines():
+        line = line.strip()
+        if line.startswith('P '):
+            try:
+                pages.append(bytes.fromhex(line[2:]))
+            except ValueError:
+                pages.append(b'') #linha truncada na captura: conta como corrompida
+    return pages
+
+
+def pages_from_image(image, flash_size, log_sectors, checkpoint_sectors):
+    end = flash_size - checkpoint_sectors * SECTOR_SIZE
+    start = end - log_sectors * SECTOR_SIZE
+    if len(image) < end:
+        sys.exit('imagem com %d bytes não contém a partição do log (0x%x..0x%x)' % (len(image), start, end))
+    return [image[o:o + PAGE_SIZE] for o in range(start, end, PAGE_SIZE)
+            if image[o:o + PAGE_SIZE] != b'\xff' * PAGE_SIZE]
+
+
+def counts_to_physical(v):
+    #mesmas contas de counts_to_physical() em main.c
+    return (v[0] * 200.0 / 1048576.0 - 50.0, v[1] * 100.0 / 1048576.0, v[2] / 100.0, v[3] / 100.0)
+
+
+def decode(pages):
+    rows, bad = [], 0
+    for page in pages:
+        if len(page) != PAGE_SIZE or not page_valid(page):
+            bad += 1
+            continue
+        _, boot, first_seq, count, _, base_ms, _, _ = HEADER.unpack_from(page)
+        for i in range(count):
+            dt_ms, c0, c1, c2, c3, p0, p1, p2, _, invoke_us = RECORD.unpack_from(page, HEADER.size + i * RECORD.size)
+            preds = ['' if p == NO_PREDICTION else '%.2f' % (p / 100.0) for p in (p0, p1, p2)]
+            phys = ['%.2f' % x for x in counts_to_physical((c0, c1, c2, c3))]
+            rows.append([boot, first_seq + i, base_ms + dt_ms] + phys + preds
+                        + [invoke_us if p0 != NO_PREDICTION else ''])
+    rows.sort(key=lambda r: r[1]) #seq cresce entre boots: ordem cronológica mesmo com o anel dado a volta
+    return rows, bad
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Decodifica o log em anel da flash para CSV')
+    ap.add_argument('input', help="captura do serial (comando 'l') ou imagem binária da flash")
+    ap.add_argument('output', nargs='?', help='CSV de saída (padrão: stdout)')
+    ap.add_argument('--flash-size', type=int, default=2 * 1024 * 1024)
+    ap.add_argument('--log-sectors', type=int, default=192, help='FLASH_LOG_SECTORS')
+    ap.add_argument('--checkpoint-sectors', type=int, default=2, help='WINDOW_CHECKPOINT_SECTORS')
+    args = ap.parse_intermixed_args()
+
+    with open(args.input, 'rb') as f:
+        data = f.read()
+    if b'FLASH_LOG BEGIN' in data:
+        pages = pages_from_capture(data.decode('utf-8', 'replace'))
+    else:
+        pages = pages_from_image(data, args.flash_size, args.log_sectors, args.checkpoint_sectors)
+    rows, bad = decode(pages)
+
+    out = open(args.output, 'w', newline='') if args.output else sys.stdout
+    out.write(','.join(COLUMNS) + '\n')
+    for r in rows:
+        out.write(','.join(str(x) for x in r) + '\n')
+    if args.output:
+        out.close()
+    boots = sorted({r[0] for r in rows})
+    print('%d registros em %d páginas (%d corrompidas), boots %s' % (
+        len(rows), len(pages) - bad, bad, ', '.join(map(str, boots)) or '-'), file=sys.stderr)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,220 @@
+"""
+Dobra o z-score do scaler na primeira camada com pesos do modelo (conv1d_1 ou dense_1).
+
+O firmware normaliza cada feature com (x - mean) / scale antes do modelo. Como a primeira
+camada com pesos é linear na entrada, o mesmo resultado sai de pesos e bias reescritos:
+
+    w'[o, ..., f] = w[o, ..., f] / scale[f]
+    b'[o]         = b[o] - sum(w'[o, ..., f] * mean[f])
+
+e o artefato gerado recebe a janela em unidades físicas (°C, %RH, °C, hPa). Só os buffers
+dos pesos e do bias mudam: o FlatBuffers é reescrito no lugar, sem mudar de tamanho. Pesos
+int8 (dense_1 híbrido do MLP) são recusados: o bias dobrado multiplica o erro de quantização
+de cada peso por mean/scale, e a camada precisa ser exportada em float32.
+
+Com --check, avalia os dois caminhos com o interpretador de referência de tools/tflite_interpreter.py
+(aritmética float32, como os kernels) sobre janelas aleatórias em unidades físicas: modelo original sobre a
+entrada normalizada contra o modelo dobrado sobre a entrada bruta. Diferença acima da tolerância
+aborta o build.
+
+Uso: python3 tools/fold_scaler.py <modelo.tflite|.h> <scaler_params.h> <saida.tflite|.h>
+                                  [--check [N]] [--tol GRAUS]
+"""
+import argparse
+import os
+import random
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import Model  # noqa: E402
+from tflite_interpreter import RESHAPE_OPS, SHAPE_OPS, evaluate, f32  # noqa: E402
+
+
+def fail(msg):
+    sys.stderr.write('fold_scaler: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def load_scaler(path):
+    text = re.sub(r'//[^\n]*', '', open(path).read())
+    out = []
+    for name in ('scaler_mean', 'scaler_scale'):
+        m = re.search(r'%s\s*\[\s*\]\s*=\s*\{([^}]*)\}' % name, text)
+        if not m:
+            fail('%s não encontrado em %s' % (name, path))
+        out.append([float(v.rstrip('fF')) for v in m.group(1).replace(',', ' ').split()])
+    mean, scale = out
+    if len(mean) != len(scale) or any(s == 0.0 for s in scale):
+        fail('scaler inválido em %s' % path)
+    return mean, scale
+
+
+def first_layer(model, num_features):
+    """Segue a entrada pelos RESHAPE/EXPAND_DIMS até a primeira CONV_2D ou FULLY_CONNECTED."""
+    x = model.tensors[model.inputs[0]]
+    if x.shape[-1] != num_features:
+        fail('entrada %s não termina em %d features' % (x.shape, num_features))
+    current = x.index
+    while True:
+        users = [op for op in model.operators if current in op.inputs and op.op not in SHAPE_OPS]
+        if len(users) != 1 or users[0].inputs[0] != current:
+            fail('t%d não alimenta uma única camada: dobra não suportada' % current)
+        op = users[0]
+        if op.op in RESHAPE_OPS:
+            current = op.outputs[0]
+            continue
+        if op.op not in ('CONV_2D', 'FULLY_CONNECTED'):
+            fail('op%d: %s antes da primeira camada com pesos' % (op.index, op.op))
+        w = model.tensors[op.inputs[1]]
+        if op.op == 'CONV_2D':
+            #padding SAME preencheria com zero no espaço normalizado, ou seja, com a média no bruto
+            if op.options.get('padding') != 'VALID':
+                fail('op%d: Conv com padding %s não pode ser dobrada' % (op.index, op.options.get('padding')))
+            if w.shape[-1] != num_features:
+                fail('op%d: filtro %s não tem %d canais de entrada' % (op.index, w.shape, num_features))
+        elif w.shape[-1] % num_features:
+            fail('op%d: pesos %s não cobrem janelas de %d features' % (op.index, w.shape, num_features))
+        if len(op.inputs) < 3 or op.inputs[2] < 0 or not model.tensors[op.inputs[2]].is_constant:
+            fail('op%d: camada sem bias constante' % op.index)
+        return op
+
+
+def check_unshared(model, tensor):
+    if sum(1 for t in model.tensors if t.buffer == tensor.buffer) != 1:
+        fail('buffer de t%d compartilhado com outro tensor' % tensor.index)
+
+
+def fold(model, mean, scale):
+    """Devolve (bytes do modelo dobrado, camada dobrada)."""
+    F = len(mean)
+    op = first_layer(model, F)
+    w = model.tensors[op.inputs[1]]
+    b = model.tensors[op.inputs[2]]
+    check_unshared(model, w)
+    check_unshared(model, b)
+    if b.type != 'float32':
+        fail('op%d: bias %s não suportado' % (op.index, b.type))
+    out_ch = w.shape[0]
+    per_out = w.num_elements // out_ch
+    data = bytearray(model.data)
+
+    #elemento k de w está na feature k % F: o canal de entrada (Conv) ou a posição na janela achatada (FC)
+    if w.type == 'float32':
+        q = w.values()
+        folded = [f32(q[k] / scale[k % F]) for k in range(len(q))]
+        struct.pack_into('<%df' % len(folded), data, w.data_offset, *folded)
+    elif w.type == 'int8':
+        #o bias absorve mean/scale vezes o erro de quantização de cada peso (~436x na pressão):
+        #requantizar custaria ~0.1 °C na saída, então a camada precisa ser exportada em float32
+        fail('op%d: pesos int8 (%s) não podem ser dobrados sem perda; exporte a camada em float32' % (op.index, w.name))
+    else:
+        fail('op%d: pesos %s não suportados' % (op.index, w.type))
+
+    bias = b.values()
+    for o in range(out_ch):
+        row = folded[o * per_out:(o + 1) * per_out]
+        bias[o] = f32(bias[o] - sum(v * mean[k % F] for k, v in enumerate(row)))
+    struct.pack_into('<%df' % len(bias), data, b.data_offset, *bias)
+    return bytes(data), op
+
+
+def parity(original, folded, mean, scale, count, tol):
+    F = len(mean)
+    n = original.tensors[original.inputs[0]].num_elements
+    rng = random.Random(1)
+    windows = [[mean[k % F] for k in range(n)]]  #janela na média: z = 0 em todas as features
+    while len(windows) < count:
+        windows.append([mean[k % F] + scale[k % F] * max(-3.0, min(3.0, rng.gauss(0.0, 1.0))) for k in range(n)])
+
+    def ident(x):
+        return x
+
+    worst = {'float32': 0.0, 'float64': 0.0}
+    for raw in windows:
+        for label, rnd in (('float32', f32), ('float64', ident)):
+            z = [rnd(rnd(rnd(x) - rnd(mean[k % F])) / rnd(scale[k % F])) for k, x in enumerate(raw)]
+            ref = evaluate(original, z, rnd)
+            got = evaluate(folded, raw, rnd)
+            worst[label] = max(worst[label], max(abs(a - c) for a, c in zip(ref, got)))
+    print('fold_scaler: paridade em %d janelas: |dobrado(bruto) - original(z-score)| máx %.3g °C em float32, '
+          '%.3g °C em float64' % (len(windows), worst['float32'], worst['float64']))
+    if worst['float32'] > tol:
+        fail('diferença %.3g °C acima da tolerância %.3g °C' % (worst['float32'], tol))
+
+
+#--- saída ---
+
+def c_array(data, newline):
+    lines = []
+    for i in range(0, len(data), 12):
+        lines.append('  ' + ''.join('0x%02x, ' % v for v in data[i:i + 12]))
+    return newline.join(lines)
+
+
+def write_header(dst, data, src, scaler):
+    if src.endswith('.h'):
+        #mantém o header original (defines, nomes das features e horizontes), troca só os bytes
+        text = open(src, newline='').read()
+        newline = '\r\n' if '\r\n' in text else '\n'
+        start = text.index('{', text.index('unsigned char')) + 1
+        end = text.index('}', start)
+        text = text[:start] + newline + c_array(data, newline) + newline + text[end:]
+        text = re.sub(r'(_len\s*=\s*)\d+', r'\g<1>%d' % len(data), text, count=1)
+        text = text.replace('// Auto-generated file - Do not edit manually',
+                            '// Auto-generated file - Do not edit manually' + newline +
+                            '// Scaler folded into the first layer by tools/fold_scaler.py (%s): '
+                            'input in physical units' % os.path.basename(scaler), 1)
+    else:
+        newline = '\n'
+        text = newline.join([
+            '// Temperature Prediction Model - TinyML',
+            '// Auto-generated by tools/fold_scaler.py - Do not edit manually',
+            '// Scaler folded into the first layer (%s): input in physical units' % os.path.basename(scaler),
+            '',
+            '#ifndef TEMPERATURE_MODEL_H',
+            '#define TEMPERATURE_MODEL_H',
+            '',
+            'const unsigned char temperature_model[] = {',
+            c_array(data, newline),
+            '};',
+            'const unsigned int temperature_model_len = %d;' % len(data),
+            '',
+            '#endif // TEMPERATURE_MODEL_H',
+            '',
+        ])
+    with open(dst, 'w', newline='') as f:
+        f.write(text)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Dobra o scaler z-score na primeira camada do modelo')
+    ap.add_argument('model')
+    ap.add_argument('scaler')
+    ap.add_argument('output')
+    ap.add_argument('--check', type=int, nargs='?', const=64, default=0, metavar='N',
+                    help='paridade com o caminho em dois passos sobre N janelas (padrão 64)')
+    ap.add_argument('--tol', type=float, default=1e-3, help='diferença máxima aceita em °C (padrão 1e-3)')
+    args = ap.parse_args()
+
+    model = Model.load(args.model)
+    mean, scale = load_scaler(args.scaler)
+    data, op = fold(model, mean, scale)
+    folded = Model(data)
+    print('fold_scaler: %s -> op%d %s (%s) recebe unidades físicas' % (
+        os.path.basename(args.scaler), op.index, op.op, folded.tensors[op.inputs[1]].type))
+    if args.check:
+        parity(model, folded, mean, scale, args.check, args.tol)
+
+    out_dir = os.path.dirname(os.path.abspath(args.output))
+    os.makedirs(out_dir, exist_ok=True)
+    if args.output.endswith('.h'):
+        write_header(args.output, data, args.model, args.scaler)
+    else:
+        with open(args.output, 'wb') as f:
+            f.write(data)
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,155 @@
+"""
+Gera os parâmetros do motor Conv1D especializado (firmware/conv1d_engine.cpp).
+
+Lê o modelo .tflite (ou o array C de temperature_model.h), confere que o grafo é
+exatamente [1,10,4] -> Conv1D -> Conv1D -> GlobalAveragePooling1D -> Dense -> Dense
+e escreve um header com formas constexpr e pesos em float32 na ordem usada pelos
+kernels. Qualquer desvio do grafo esperado aborta o build.
+
+Uso: python3 tools/gen_conv1d_engine.py <modelo.tflite|.h> <saida.h>
+"""
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import Model  # noqa: E402
+
+EXPECTED_OPS = ['EXPAND_DIMS', 'CONV_2D', 'RESHAPE', 'EXPAND_DIMS', 'CONV_2D',
+                'RESHAPE', 'MEAN', 'FULLY_CONNECTED', 'FULLY_CONNECTED']
+
+
+def fail(msg):
+    sys.stderr.write('gen_conv1d_engine: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def check_conv(model, op):
+    o = op.options
+    if o.get('padding') != 'VALID' or o.get('stride_w') != 1 or o.get('stride_h') != 1:
+        fail('op%d: apenas Conv1D com padding VALID e stride 1 é suportada' % op.index)
+    if o.get('dilation_w', 1) != 1 or o.get('dilation_h', 1) != 1:
+        fail('op%d: dilatação não suportada' % op.index)
+    if o.get('activation') != 'RELU':
+        fail('op%d: ativação %s não suportada (esperado RELU)' % (op.index, o.get('activation')))
+    w = model.tensors[op.inputs[1]]
+    b = model.tensors[op.inputs[2]]
+    if len(w.shape) != 4 or w.shape[1] != 1:
+        fail('op%d: filtro com forma %s não é Conv1D' % (op.index, w.shape))
+    return w, b
+
+
+def check_dense(model, op, activation):
+    if op.options.get('activation') != activation:
+        fail('op%d: ativação %s, esperado %s' % (op.index, op.options.get('activation'), activation))
+    return model.tensors[op.inputs[1]], model.tensors[op.inputs[2]]
+
+
+def c_floats(values, per_line=8, indent='    '):
+    lines = []
+    for i in range(0, len(values), per_line):
+        lines.append(indent + ' '.join('%.9ef,' % v for v in values[i:i + per_line]))
+    return '\n'.join(lines)
+
+
+def main():
+    if len(sys.argv) != 3:
+        fail('uso: gen_conv1d_engine.py <modelo.tflite|.h> <saida.h>')
+    src, dst = sys.argv[1], sys.argv[2]
+    model = Model.load(src)
+
+    ops = [op.op for op in model.operators]
+    if ops != EXPECTED_OPS:
+        fail('grafo inesperado: %s' % ops)
+    for t in model.tensors:
+        if t.type not in ('float32', 'int32'):
+            fail('tensor %d (%s) é %s; o motor gerado só aceita float32' % (t.index, t.name, t.type))
+
+    x = model.tensors[model.inputs[0]]
+    if len(x.shape) != 3 or x.shape[0] != 1:
+        fail('entrada com forma %s, esperado [1, janela, features]' % x.shape)
+    window, features = x.shape[1], x.shape[2]
+
+    w1, b1 = check_conv(model, model.operators[1])
+    w2, b2 = check_conv(model, model.operators[4])
+    d1, db1 = check_dense(model, model.operators[7], 'RELU')
+    d2, db2 = check_dense(model, model.operators[8], 'NONE')
+
+    conv1_filters, conv1_kernel = w1.shape[0], w1.shape[2]
+    conv2_filters, conv2_kernel = w2.shape[0], w2.shape[2]
+    conv1_steps = window - conv1_kernel + 1
+    conv2_steps = conv1_steps - conv2_kernel + 1
+    if w1.shape[3] != features or w2.shape[3] != conv1_filters:
+        fail('canais incompatíveis entre camadas: %s %s' % (w1.shape, w2.shape))
+    if d1.shape[1] != conv2_filters or d2.shape[1] != d1.shape[0]:
+        fail('camadas densas incompatíveis: %s %s' % (d1.shape, d2.shape))
+    dense_units, horizons = d1.shape[0], d2.shape[0]
+    y = model.tensors[model.outputs[0]]
+    if y.shape != [1, horizons]:
+        fail('saída com forma %s, esperado [1, %d]' % (y.shape, horizons))
+
+    conv1_col_macs = conv1_filters * conv1_kernel * features
+    conv2_col_macs = conv2_filters * conv2_kernel * conv1_filters
+    head_macs = dense_units * conv2_filters + horizons * dense_units
+    macs = conv1_steps * conv1_col_macs + conv2_steps * conv2_col_macs + head_macs
+    stream_macs = conv1_col_macs + conv2_col_macs + head_macs  #apenas a coluna nova de cada conv
+
+    out = []
+    out.append('// Conv1D engine parameters - TinyML')
+    out.append('// Auto-generated by tools/gen_conv1d_engine.py - Do not edit manually')
+    out.append('// Source: %s' % os.path.basename(src))
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('namespace conv1d_engine {')
+    out.append('')
+    out.append('// Model shape')
+    out.append('constexpr int kWindow       = %d;' % window)
+    out.append('constexpr int kFeatures     = %d;' % features)
+    out.append('constexpr int kConv1Filters = %d;' % conv1_filters)
+    out.append('constexpr int kConv1Kernel  = %d;' % conv1_kernel)
+    out.append('constexpr int kConv1Steps   = %d;' % conv1_steps)
+    out.append('constexpr int kConv2Filters = %d;' % conv2_filters)
+    out.append('constexpr int kConv2Kernel  = %d;' % conv2_kernel)
+    out.append('constexpr int kConv2Steps   = %d;' % conv2_steps)
+    out.append('constexpr int kDenseUnits   = %d;' % dense_units)
+    out.append('constexpr int kHorizons     = %d;' % horizons)
+    out.append('constexpr int kMacsPerInvoke = %d;' % macs)
+    out.append('constexpr int kMacsPerStreamStep = %d;' % stream_macs)
+    out.append('')
+    for name, t, dims in (
+            ('conv1_weights', w1, [conv1_filters, conv1_kernel, features]),
+            ('conv1_bias', b1, [conv1_filters]),
+            ('conv2_weights', w2, [conv2_filters, conv2_kernel, conv1_filters]),
+            ('conv2_bias', b2, [conv2_filters]),
+            ('dense1_weights', d1, [dense_units, conv2_filters]),
+            ('dense1_bias', db1, [dense_units]),
+            ('output_weights', d2, [horizons, dense_units]),
+            ('output_bias', db2, [horizons])):
+        values = t.values()
+        n = 1
+        for d in dims:
+            n *= d
+        if len(values) != n:
+            fail('%s: %d valores, esperado %d' % (name, len(values), n))
+        out.append('// %s' % t.name)
+        out.append('alignas(4) constexpr float %s[%s] = {' % (name, ']['.join(str(d) for d in dims)))
+        out.append(c_floats(values))
+        out.append('};')
+        out.append('')
+    out.append('} // namespace conv1d_engine')
+    out.append('')
+
+    text = '\n'.join(out)
+    if os.path.exists(dst) and open(dst).read() == text:
+        #evita recompilar quando o modelo não mudou; o mtime avança mesmo assim, senão a saída fica
+        #mais velha que as dependências e o comando do CMake roda de novo em todo build
+        os.utime(dst, None)
+        return
+    os.makedirs(os.path.dirname(os.path.abspath(dst)), exist_ok=True)
+    with open(dst, 'w') as f:
+        f.write(text)
+    print('gen_conv1d_engine: %s -> %s (%d MACs/invoke)' % (os.path.basename(src), dst, macs))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,100 @@
+"""
+Gera o atlas de fonte do SSD1306 (firmware/lib/font_atlas.h) a partir de firmware/lib/font.h.
+
+Cada glifo 8x8 é gravado já na ordem da GDDRAM: 8 bytes, um por coluna, com o bit 0 na linha
+de cima. Os símbolos que o desenho antigo girava em tempo de execução (':', '.', '>', '-', '!',
+'%', '/') saem já girados, então ssd1306_draw_char() copia um byte por coluna em linhas
+alinhadas a página (ou desloca/combina duas páginas nas demais).
+
+Uso: python3 tools/gen_font_atlas.py [firmware/lib/font.h] [firmware/lib/font_atlas.h]
+"""
+import os
+import re
+import sys
+
+ROOT = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+#caractere -> (glifo em font.h, girado), na mesma ordem do mapeamento antigo de ssd1306_draw_char()
+GLYPHS = [(' ', 0, False)]
+GLYPHS += [(chr(ord('0') + i), 1 + i, False) for i in range(10)]
+GLYPHS += [(chr(ord('A') + i), 11 + i, False) for i in range(26)]
+GLYPHS += [(chr(ord('a') + i), 37 + i, False) for i in range(26)]
+GLYPHS += [(':', 64, True), ('.', 65, True), ('>', 66, True), ('-', 67, True),
+           (chr(127), 68, False), ('!', 69, True), ('%', 70, True), ('/', 71, True)]
+
+FIRST, LAST = 32, 127
+
+
+def fail(msg):
+    sys.stderr.write('gen_font_atlas: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def load_font(path):
+    text = open(path).read()
+    body = text[text.index('{') + 1:text.rindex('}')]
+    body = re.sub(r'//[^\n]*', '', body)
+    return [int(v, 16) for v in re.findall(r'0x[0-9a-fA-F]+', body)]
+
+
+def columns(font, glyph, rotate):
+    rows = font[glyph * 8:glyph * 8 + 8]
+    if len(rows) != 8:
+        fail('glifo %d fora da tabela' % glyph)
+    if not rotate:
+        return rows  #font.h já guarda colunas com o bit 0 em cima
+    #pixel (7 - j, i) = bit j da linha i
+    return [sum(((rows[i] >> (7 - c)) & 1) << i for i in range(8)) for c in range(8)]
+
+
+def label(c):
+    return 'DEL (Ohm)' if ord(c) == 127 else "'%s'" % ('\\\\' if c == '\\' else c)
+
+
+def main():
+    src = sys.argv[1] if len(sys.argv) > 1 else os.path.join(ROOT, 'firmware', 'lib', 'font.h')
+    dst = sys.argv[2] if len(sys.argv) > 2 else os.path.join(ROOT, 'firmware', 'lib', 'font_atlas.h')
+    font = load_font(src)
+
+    glyphs = sorted(GLYPHS, key=lambda g: ord(g[0]))
+    index = [0xFF] * (LAST - FIRST + 1)
+    for n, (c, _, _) in enumerate(glyphs):
+        index[ord(c) - FIRST] = n
+
+    out = []
+    out.append('// SSD1306 font atlas - TinyML')
+    out.append('// Auto-generated by tools/gen_font_atlas.py - Do not edit manually')
+    out.append('// Source: %s' % os.path.basename(src))
+    out.append('')
+    out.append('#ifndef FONT_ATLAS_H')
+    out.append('#define FONT_ATLAS_H')
+    out.append('')
+    out.append('#include <stdint.h>')
+    out.append('')
+    out.append('#define FONT_ATLAS_FIRST %d' % FIRST)
+    out.append('#define FONT_ATLAS_LAST  %d' % LAST)
+    out.append('#define FONT_ATLAS_NONE  0xFF // Caractere sem glifo: não desenhado')
+    out.append('')
+    out.append('// Glifo de cada caractere ASCII %d..%d' % (FIRST, LAST))
+    out.append('static const uint8_t font_atlas_index[%d] = {' % len(index))
+    for i in range(0, len(index), 16):
+        out.append('    ' + ' '.join('0x%02X,' % v for v in index[i:i + 16]))
+    out.append('};')
+    out.append('')
+    out.append('// 8 colunas por glifo, bit 0 = linha de cima (ordem da GDDRAM)')
+    out.append('static const uint8_t font_atlas[%d][8] = {' % len(glyphs))
+    for c, glyph, rotate in glyphs:
+        cols = columns(font, glyph, rotate)
+        out.append('    {%s}, // %s' % (', '.join('0x%02X' % v for v in cols), label(c)))
+    out.append('};')
+    out.append('')
+    out.append('#endif /* FONT_ATLAS_H */')
+    out.append('')
+
+    with open(dst, 'w') as f:
+        f.write('\n'.join(out))
+    print('gen_font_atlas: %s -> %s (%d glifos)' % (os.path.basename(src), dst, len(glyphs)))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,177 @@
+"""
+Gera os parâmetros do motor GRU especializado (firmware/gru_engine.cpp).
+
+O conversor TFLite exporta o GRU do Keras como um laço WHILE com TensorListReserve, que o
+TFLM não implementa. Este gerador lê direto o models/GRU/temperature_model.keras (config.json
++ model.weights.h5, via tools/keras_reader.py), confere que o modelo é exatamente
+[1,10,4] -> GRU(tanh/sigmoid, reset_after, só o último estado) -> Dense(ReLU) -> Dense e
+escreve um header com formas constexpr e pesos float32 no layout [saída][entrada] das
+densas do codegen_engine.h. Os Dropout não existem na inferência.
+
+GruModel.forward() é a mesma conta em Python (float64), para conferir o motor.
+
+Uso: python3 tools/gen_gru_engine.py <modelo.keras> <saida.h>
+"""
+import math
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from keras_reader import KerasModel, H5Error  # noqa: E402
+from gen_conv1d_engine import c_floats  # noqa: E402
+
+
+def fail(msg):
+    sys.stderr.write('gen_gru_engine: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def transpose(values, rows, cols):
+    """[rows][cols] do Keras -> [cols][rows] (uma linha por saída)."""
+    return [values[r * cols + c] for c in range(cols) for r in range(rows)]
+
+
+class GruModel:
+    """Pesos do GRU + densas, já no layout do motor."""
+
+    def __init__(self, path):
+        try:
+            model = KerasModel(path)
+        except (H5Error, KeyError, OSError) as e:
+            fail('%s: %s' % (path, e))
+        layers = [l for l in model.layers if l.class_name != 'Dropout']
+        if [l.class_name for l in layers] != ['GRU', 'Dense', 'Dense']:
+            fail('grafo inesperado: %s' % [l.class_name for l in model.layers])
+        shape = model.input_shape
+        if not shape or len(shape) != 3:
+            fail('entrada %s, esperado [batch, janela, features]' % shape)
+        self.window, self.features = shape[1], shape[2]
+
+        gru, d1, d2 = layers
+        c = gru.config
+        expected = {'activation': 'tanh', 'recurrent_activation': 'sigmoid', 'reset_after': True,
+                    'return_sequences': False, 'go_backwards': False, 'use_bias': True}
+        for key, value in expected.items():
+            if c.get(key) != value:
+                fail('%s: %s=%r, esperado %r' % (gru.name, key, c.get(key), value))
+        if c.get('stateful'):
+            fail('%s: GRU stateful não suportado' % gru.name)
+        self.units = c['units']
+        u, f = self.units, self.features
+        (ks, kernel), (rs, recurrent), (bs, bias) = gru.weights
+        if ks != [f, 3 * u] or rs != [u, 3 * u] or bs != [2, 3 * u]:
+            fail('%s: pesos %s %s %s' % (gru.name, ks, rs, bs))
+        #Keras: portões na ordem z (update), r (reset), h (candidato); bias[0] da entrada, bias[1] recorrente
+        self.kernel = transpose(kernel, f, 3 * u)
+        self.recurrent = transpose(recurrent, u, 3 * u)
+        self.bias_input = bias[:3 * u]
+        self.bias_recurrent = bias[3 * u:]
+
+        for layer, activation in ((d1, 'relu'), (d2, 'linear')):
+            if layer.config.get('activation') != activation or not layer.config.get('use_bias'):
+                fail('%s: ativação %s, esperado %s com bias' % (
+                    layer.name, layer.config.get('activation'), activation))
+        (w1s, w1), (b1s, b1) = d1.weights
+        (w2s, w2), (b2s, b2) = d2.weights
+        if w1s[0] != u or w2s[0] != w1s[1]:
+            fail('camadas densas incompatíveis: %s %s' % (w1s, w2s))
+        self.hidden, self.horizons = w1s[1], w2s[1]
+        self.dense_weights = transpose(w1, u, self.hidden)
+        self.dense_bias = b1
+        self.output_weights = transpose(w2, self.hidden, self.horizons)
+        self.output_bias = b2
+        self.names = (gru.name, d1.name, d2.name)
+
+    @property
+    def macs(self):
+        step = 3 * self.units * (self.features + self.units)
+        return self.window * step + self.units * self.hidden + self.hidden * self.horizons
+
+    @property
+    def params(self):
+        u = self.units
+        return (3 * u * (self.features + u + 2) + (u + 1) * self.hidden +
+                (self.hidden + 1) * self.horizons)
+
+    @property
+    def activation_bytes(self):
+        #estado [u], portões da entrada e da recorrência [3u] cada, densa [hidden] (firmware/gru_engine.cpp)
+        return 4 * (self.units + 6 * self.units + self.hidden)
+
+    def forward(self, window):
+        """Referência em float64 da mesma conta do motor: janela [janela*features] -> [horizontes]."""
+        u, f = self.units, self.features
+        sig = lambda v: 1.0 / (1.0 + math.exp(-v))  # noqa: E731
+        h = [0.0] * u
+        for t in range(self.window):
+            x = window[t * f:(t + 1) * f]
+            xg = [self.bias_input[o] + sum(x[i] * self.kernel[o * f + i] for i in range(f))
+                  for o in range(3 * u)]
+            hg = [self.bias_recurrent[o] + sum(h[i] * self.recurrent[o * u + i] for i in range(u))
+                  for o in range(3 * u)]
+            z = [sig(xg[j] + hg[j]) for j in range(u)]
+            r = [sig(xg[u + j] + hg[u + j]) for j in range(u)]
+            cand = [math.tanh(xg[2 * u + j] + r[j] * hg[2 * u + j]) for j in range(u)]
+            h = [z[j] * h[j] + (1.0 - z[j]) * cand[j] for j in range(u)]
+        d = [max(0.0, self.dense_bias[o] + sum(h[i] * self.dense_weights[o * u + i] for i in range(u)))
+             for o in range(self.hidden)]
+        return [self.output_bias[o] + sum(d[i] * self.output_weights[o * self.hidden + i]
+                                          for i in range(self.hidden)) for o in range(self.horizons)]
+
+
+def main():
+    if len(sys.argv) != 3:
+        fail('uso: gen_gru_engine.py <modelo.keras> <saida.h>')
+    src, dst = sys.argv[1], sys.argv[2]
+    m = GruModel(src)
+    u = m.units
+
+    out = []
+    out.append('// GRU engine parameters - TinyML')
+    out.append('// Auto-generated by tools/gen_gru_engine.py - Do not edit manually')
+    out.append('// Source: %s' % os.path.basename(src))
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('namespace gru_engine {')
+    out.append('')
+    out.append('// Model shape')
+    out.append('constexpr int kWindow   = %d;' % m.window)
+    out.append('constexpr int kFeatures = %d;' % m.features)
+    out.append('constexpr int kUnits    = %d;' % u)
+    out.append('constexpr int kGates    = %d; // z, r, h' % (3 * u))
+    out.append('constexpr int kHidden   = %d;' % m.hidden)
+    out.append('constexpr int kHorizons = %d;' % m.horizons)
+    out.append('constexpr int kMacsPerInvoke = %d;' % m.macs)
+    out.append('')
+    for name, values, dims, comment in (
+            ('gru_kernel', m.kernel, [3 * u, m.features], '%s kernel' % m.names[0]),
+            ('gru_recurrent_kernel', m.recurrent, [3 * u, u], '%s recurrent_kernel' % m.names[0]),
+            ('gru_input_bias', m.bias_input, [3 * u], '%s bias[0]' % m.names[0]),
+            ('gru_recurrent_bias', m.bias_recurrent, [3 * u], '%s bias[1] (reset_after)' % m.names[0]),
+            ('dense_weights', m.dense_weights, [m.hidden, u], m.names[1]),
+            ('dense_bias', m.dense_bias, [m.hidden], m.names[1]),
+            ('output_weights', m.output_weights, [m.horizons, m.hidden], m.names[2]),
+            ('output_bias', m.output_bias, [m.horizons], m.names[2])):
+        out.append('// %s' % comment)
+        out.append('alignas(4) constexpr float %s[%s] = {' % (name, ']['.join(str(d) for d in dims)))
+        out.append(c_floats(values))
+        out.append('};')
+        out.append('')
+    out.append('} // namespace gru_engine')
+    out.append('')
+
+    text = '\n'.join(out)
+    if os.path.exists(dst) and open(dst).read() == text:
+        #evita recompilar quando o modelo não mudou; o mtime avança mesmo assim, senão a saída fica
+        #mais velha que as dependências e o comando do CMake roda de novo em todo build
+        os.utime(dst, None)
+        return
+    os.makedirs(os.path.dirname(os.path.abspath(dst)), exist_ok=True)
+    with open(dst, 'w') as f:
+        f.write(text)
+    print('gen_gru_engine: %s -> %s (%d MACs/invoke)' % (os.path.basename(src), dst, m.macs))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,123 @@
+"""
+Gera os parâmetros do motor MLP especializado (firmware/mlp_engine.cpp).
+
+Lê o modelo .tflite (ou o array C de temperature_model.h), confere que o grafo é
+exatamente [1,10,4] -> Flatten -> Dense(ReLU) -> Dense(ReLU) -> Dense e escreve um header
+com formas constexpr e pesos em float32. O Flatten do Keras chega como SHAPE, STRIDED_SLICE,
+PACK e RESHAPE, que só calculam a forma [1, 40]: a janela cronológica já está nessa ordem
+na memória e o motor lê direto dela.
+
+Pesos híbridos (dense_1 int8 com escala por canal, gerado pelo conversor) são dequantizados:
+o motor calcula em float32 com os mesmos pesos que o TFLM recebe do registro de modelos.
+
+Uso: python3 tools/gen_mlp_engine.py <modelo.tflite|.h> <saida.h>
+"""
+import os
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import Model  # noqa: E402
+from gen_conv1d_engine import c_floats  # noqa: E402
+
+EXPECTED_OPS = ['SHAPE', 'STRIDED_SLICE', 'PACK', 'RESHAPE',
+                'FULLY_CONNECTED', 'FULLY_CONNECTED', 'FULLY_CONNECTED']
+
+
+def fail(msg):
+    sys.stderr.write('gen_mlp_engine: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def check_dense(model, op, activation):
+    if op.options.get('activation') != activation:
+        fail('op%d: ativação %s, esperado %s' % (op.index, op.options.get('activation'), activation))
+    w, b = model.tensors[op.inputs[1]], model.tensors[op.inputs[2]]
+    if w.type not in ('float32', 'int8') or b.type != 'float32':
+        fail('op%d: pesos %s / bias %s não suportados' % (op.index, w.type, b.type))
+    if w.type == 'int8' and w.quantized_dimension != 0:
+        fail('op%d: pesos int8 quantizados na dimensão %d' % (op.index, w.quantized_dimension))
+    return w, b
+
+
+def main():
+    if len(sys.argv) != 3:
+        fail('uso: gen_mlp_engine.py <modelo.tflite|.h> <saida.h>')
+    src, dst = sys.argv[1], sys.argv[2]
+    model = Model.load(src)
+
+    ops = [op.op for op in model.operators]
+    if ops != EXPECTED_OPS:
+        fail('grafo inesperado: %s' % ops)
+    x = model.tensors[model.inputs[0]]
+    if len(x.shape) != 3 or x.shape[0] != 1 or x.type != 'float32':
+        fail('entrada %s %s, esperado float32 [1, janela, features]' % (x.type, x.shape))
+    window, features = x.shape[1], x.shape[2]
+    flat = model.tensors[model.operators[3].outputs[0]]
+    if model.operators[3].inputs[0] != x.index or flat.shape != [1, window * features]:
+        fail('RESHAPE não achata a entrada: %s' % flat.shape)
+
+    d1, b1 = check_dense(model, model.operators[4], 'RELU')
+    d2, b2 = check_dense(model, model.operators[5], 'RELU')
+    d3, b3 = check_dense(model, model.operators[6], 'NONE')
+    inputs = window * features
+    hidden1, hidden2, horizons = d1.shape[0], d2.shape[0], d3.shape[0]
+    if d1.shape[1] != inputs or d2.shape[1] != hidden1 or d3.shape[1] != hidden2:
+        fail('camadas densas incompatíveis: %s %s %s' % (d1.shape, d2.shape, d3.shape))
+    y = model.tensors[model.outputs[0]]
+    if y.shape != [1, horizons]:
+        fail('saída com forma %s, esperado [1, %d]' % (y.shape, horizons))
+    macs = hidden1 * inputs + hidden2 * hidden1 + horizons * hidden2
+
+    out = []
+    out.append('// MLP engine parameters - TinyML')
+    out.append('// Auto-generated by tools/gen_mlp_engine.py - Do not edit manually')
+    out.append('// Source: %s' % os.path.basename(src))
+    out.append('')
+    out.append('#pragma once')
+    out.append('')
+    out.append('namespace mlp_engine {')
+    out.append('')
+    out.append('// Model shape')
+    out.append('constexpr int kWindow   = %d;' % window)
+    out.append('constexpr int kFeatures = %d;' % features)
+    out.append('constexpr int kInputs   = %d;' % inputs)
+    out.append('constexpr int kHidden1  = %d;' % hidden1)
+    out.append('constexpr int kHidden2  = %d;' % hidden2)
+    out.append('constexpr int kHorizons = %d;' % horizons)
+    out.append('constexpr int kMacsPerInvoke = %d;' % macs)
+    out.append('')
+    for name, t, dims in (
+            ('dense1_weights', d1, [hidden1, inputs]),
+            ('dense1_bias', b1, [hidden1]),
+            ('dense2_weights', d2, [hidden2, hidden1]),
+            ('dense2_bias', b2, [hidden2]),
+            ('output_weights', d3, [horizons, hidden2]),
+            ('output_bias', b3, [horizons])):
+        values = t.dequantized()
+        n = 1
+        for d in dims:
+            n *= d
+        if len(values) != n:
+            fail('%s: %d valores, esperado %d' % (name, len(values), n))
+        out.append('// %s%s' % (t.name, ' (int8 dequantizado)' if t.type == 'int8' else ''))
+        out.append('alignas(4) constexpr float %s[%s] = {' % (name, ']['.join(str(d) for d in dims)))
+        out.append(c_floats(values))
+        out.append('};')
+        out.append('')
+    out.append('} // namespace mlp_engine')
+    out.append('')
+
+    text = '\n'.join(out)
+    if os.path.exists(dst) and open(dst).read() == text:
+        #evita recompilar quando o modelo não mudou; o mtime avança mesmo assim, senão a saída fica
+        #mais velha que as dependências e o comando do CMake roda de novo em todo build
+        os.utime(dst, None)
+        return
+    os.makedirs(os.path.dirname(os.path.abspath(dst)), exist_ok=True)
+    with open(dst, 'w') as f:
+        f.write(text)
+    print('gen_mlp_engine: %s -> %s (%d MACs/invoke)' % (os.path.basename(src), dst, macs))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,456 @@
+"""
+Gera o registro de modelos embarcados (firmware/model_registry.h) a partir de um ou mais .tflite.
+
+Cada modelo entra com um nome, o arquivo (.tflite ou o array C de temperature_model.h) e o
+scaler_params.h exportado junto com ele. O header gerado tem, por modelo, o flatbuffer num array
+com prefixo próprio (model_<nome>_tflite, sem os globais temperature_model/feature_names dos
+headers do notebook) e um descritor com formas, scaler, lista de operadores, MACs, parâmetros e
+a soma dos tensores de ativação (teto da arena, sem reuso de memória).
+
+Com --engine tflm o plano de tools/plan_arena.py (a maior área de ativações mais a parte persistente
+de todos os modelos e a margem) vai em MODEL_REGISTRY_PLANNED_ARENA_BYTES, e o build falha se passar
+de --arena-budget. A arena alocada, MODEL_REGISTRY_ARENA_BYTES, nunca é menor que --arena-min: as
+partes persistente e temporária do plano são estimativas, e a arena só desce para o plano depois que
+o host/tests/test_tflm_arena.cpp confirmar o uso real do AllocateTensors() contra ele. Com
+--offline-plan os offsets das ativações vão no flatbuffer, no metadado OfflineMemoryAllocation
+(no lugar da entrada CONVERSION_METADATA), pela mesma razão desligado por padrão.
+
+O resolver também sai daqui (model_registry_add_ops): um MicroMutableOpResolver com exatamente os
+operadores dos modelos do registro, e o build falha num operador sem kernel no TFLM (TFLM_KERNELS em
+tools/tflite_reader.py). A versão de cada operador vai só nos comentários: o TFLM resolve pelo código
+do operador e não confere a versão.
+
+Todos os modelos precisam da mesma janela, features e horizontes, e do mesmo scaler do firmware:
+a janela é normalizada uma vez em main.c e lida por qualquer modelo ativo.
+
+Pesos híbridos (FULLY_CONNECTED float com pesos int8, dense_1 do MLP) não rodam no TFLM ("Hybrid
+models are not supported"): com --engine tflm os pesos são dequantizados para float32 num vetor
+anexado ao fim do flatbuffer, e o buffer do tensor passa a apontar para ele. A diferença para o
+kernel híbrido do TFLite (entrada quantizada a cada invoke) é medida com o interpretador de
+referência de tools/tflite_interpreter.py e reportada no build.
+
+Com --engine codegen o flatbuffer não é embarcado: cada modelo é coberto por um motor gerado
+(conv1d_engine.cpp, mlp_engine.cpp, gru_engine.cpp) e o registro aponta para ele. --kind imprime
+o motor que cobre o grafo de um modelo (usado pelo CMake para escolher o gerador). Um .keras
+(GRU, que o conversor não exporta para o TFLM) só entra com --engine codegen.
+
+Uso: python3 tools/gen_model_registry.py <saida.h> --engine tflm|codegen
+                                         --model NOME MODELO SCALER [--model ...]
+                                         [--reference-scaler firmware/scaler_params.h] [--tol GRAUS]
+                                         [--arena-margin BYTES] [--arena-budget BYTES] [--arena-min BYTES]
+                                         [--offline-plan]
+     python3 tools/gen_model_registry.py --kind MODELO
+SCALER '-' indica um modelo com o scaler já dobrado nos pesos (MODEL_RAW_INPUT).
+"""
+import argparse
+import os
+import random
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import TFLM_KERNELS, Model  # noqa: E402
+from fold_scaler import load_scaler  # noqa: E402
+from tflite_interpreter import evaluate, f32  # noqa: E402
+from gen_conv1d_engine import EXPECTED_OPS as CONV1D_OPS  # noqa: E402
+from gen_gru_engine import GruModel  # noqa: E402
+from plan_arena import ALLOCATOR_BYTES, ArenaPlan, align, embed_offline_plan, offline_offsets  # noqa: E402
+
+#flatten do Keras (forma de destino calculada em tempo de execução) seguido de camadas densas
+MLP_PREFIX = ['SHAPE', 'STRIDED_SLICE', 'PACK', 'RESHAPE']
+MAX_MODELS = 4  #MODEL_REGISTRY_MAX em firmware/model_registry.h
+
+
+def fail(msg):
+    sys.stderr.write('gen_model_registry: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def engine_kind(model):
+    """Motor gerado que cobre o grafo: 'conv1d', 'mlp' ou None."""
+    ops = [op.op for op in model.operators]
+    if ops == CONV1D_OPS:
+        return 'conv1d'
+    if ops[:len(MLP_PREFIX)] == MLP_PREFIX and ops[len(MLP_PREFIX):] == ['FULLY_CONNECTED'] * 3:
+        return 'mlp'
+    return None
+
+
+def hybrid_layers(model):
+    """Camadas float com pesos int8 (quantização híbrida do conversor)."""
+    out = []
+    for op in model.operators:
+        if op.op not in ('FULLY_CONNECTED', 'CONV_2D'):
+            continue
+        x, w = model.tensors[op.inputs[0]], model.tensors[op.inputs[1]]
+        if x.type == 'float32' and w.type == 'int8':
+            out.append((op, w))
+    return out
+
+
+def dequantize_hybrid(model):
+    """Devolve os bytes do modelo com os pesos híbridos em float32 (vetores anexados ao fim)."""
+    data = bytearray(model.data)
+    for op, w in hybrid_layers(model):
+        if sum(1 for t in model.tensors if t.buffer == w.buffer) != 1:
+            fail('buffer de t%d compartilhado com outro tensor' % w.index)
+        if w.type_pos is None or model.buffer_data_pos[w.buffer] is None:
+            fail('t%d sem campos de tipo/buffer no flatbuffer' % w.index)
+        values = [f32(v) for v in w.dequantized()]
+        #vetor FlatBuffers: u32 com o tamanho em bytes e os dados alinhados em 16 (leitura float no M0+)
+        while (len(data) + 4) % 16:
+            data.append(0)
+        vec = len(data)
+        data += struct.pack('<I', 4 * len(values))
+        data += struct.pack('<%df' % len(values), *values)
+        #uoffset é relativo à posição do campo e só aponta para frente: o fim do arquivo serve
+        field = model.buffer_data_pos[w.buffer]
+        struct.pack_into('<I', data, field, vec - field)
+        struct.pack_into('<b', data, w.type_pos, 0)  #TensorType FLOAT32
+    while len(data) % 16:
+        data.append(0)
+    return bytes(data)
+
+
+def hybrid_parity(original, dequant, count, tol):
+    """Kernel híbrido do TFLite (original) contra os pesos dequantizados, em janelas z-score."""
+    n = original.tensors[original.inputs[0]].num_elements
+    rng = random.Random(1)
+    worst = 0.0
+    for _ in range(count):
+        z = [max(-3.0, min(3.0, rng.gauss(0.0, 1.0))) for _ in range(n)]
+        ref = evaluate(original, z, f32)
+        got = evaluate(dequant, z, f32)
+        worst = max(worst, max(abs(a - b) for a, b in zip(ref, got)))
+    if worst > tol:
+        fail('pesos dequantizados diferem %.3g °C do kernel híbrido (tolerância %.3g °C)' % (worst, tol))
+    return worst
+
+
+def op_list(model):
+    """Operadores distintos na ordem do primeiro uso."""
+    seen = []
+    for op in model.operators:
+        if op.op not in seen:
+            seen.append(op.op)
+    return seen
+
+
+def count_macs_params(model):
+    macs = params = 0
+    for op in model.operators:
+        if op.op == 'CONV_2D':
+            w, y = model.tensors[op.inputs[1]], model.tensors[op.outputs[0]]
+            macs += y.num_elements * w.num_elements // w.shape[0]
+        elif op.op == 'FULLY_CONNECTED':
+            macs += model.tensors[op.inputs[1]].num_elements
+        else:
+            continue
+        params += sum(model.tensors[i].num_elements for i in op.inputs[1:] if i >= 0)
+    return macs, params
+
+
+def activation_bytes(model):
+    return sum(t.num_bytes for t in model.tensors if not t.is_constant)
+
+
+def c_array(data, indent='  '):
+    lines = []
+    for i in range(0, len(data), 12):
+        lines.append(indent + ''.join('0x%02x, ' % v for v in data[i:i + 12]))
+    return '\n'.join(lines)
+
+
+def c_ident(name):
+    ident = re.sub(r'[^0-9a-zA-Z]+', '_', name).strip('_').lower()
+    if not ident or ident[0].isdigit():
+        fail('nome de modelo inválido: %r' % name)
+    return ident
+
+
+class Entry:
+    def __init__(self, name, path, scaler, engine, tol, offline_plan=False):
+        self.name = name
+        self.ident = c_ident(name)
+        self.path = path
+        if path.endswith('.keras'):
+            self._load_keras(scaler, engine)
+            return
+        model = Model.load(path)
+        self.kind = engine_kind(model)
+        x = model.tensors[model.inputs[0]]
+        y = model.tensors[model.outputs[0]]
+        if len(model.inputs) != 1 or len(model.outputs) != 1:
+            fail('%s: esperado 1 entrada e 1 saída' % name)
+        if len(x.shape) != 3 or x.shape[0] != 1 or len(y.shape) != 2 or y.shape[0] != 1:
+            fail('%s: entrada %s / saída %s, esperado [1, janela, features] -> [1, horizontes]' %
+                 (name, x.shape, y.shape))
+        self.window, self.features, self.horizons = x.shape[1], x.shape[2], y.shape[1]
+        self.int8 = x.type == 'int8'
+        if x.type not in ('float32', 'int8') or y.type != x.type:
+            fail('%s: entrada %s / saída %s não suportadas' % (name, x.type, y.type))
+        self._load_scaler(scaler)
+
+        self.hybrid = len(hybrid_layers(model))
+        self.hybrid_error = None
+        if engine == 'codegen':
+            if self.kind is None:
+                fail('%s: nenhum motor gerado cobre o grafo %s' % (name, [op.op for op in model.operators]))
+            self.data = None
+        elif self.hybrid:
+            self.data = dequantize_hybrid(model)
+            self.hybrid_error = hybrid_parity(model, Model(self.data), 64, tol)
+            model = Model(self.data)
+        else:
+            self.data = model.data
+        self.plan = None
+        self.offline_plan = False
+        if self.data is not None:
+            self.plan = ArenaPlan(model)
+            planned = embed_offline_plan(model, self.plan) if offline_plan else None
+            if offline_plan and planned is None:
+                sys.stderr.write('gen_model_registry: AVISO: %s sem entrada CONVERSION_METADATA para o plano '
+                                 'offline, o TFLM planeja a arena no boot\n' % name)
+            elif planned is not None:
+                model = Model(planned)
+                if offline_offsets(model) != self.plan.offsets():
+                    fail('%s: plano offline não confere depois de embutido' % name)
+                self.data = planned
+                self.offline_plan = True
+        if engine == 'tflm':
+            missing = [op for op in op_list(model) if op not in TFLM_KERNELS]
+            if missing:
+                fail('%s: operador(es) sem kernel no TFLM: %s' % (name, ', '.join(missing)))
+        self.ops = op_list(model)
+        self.op_versions = model.op_versions()
+        self.num_ops = len(model.operators)
+        self.macs, self.params = count_macs_params(model)
+        self.activation_bytes = activation_bytes(model)
+
+    @property
+    def arena_bytes(self):
+        """Arena do TFLM com só este modelo (0 sem flatbuffer embarcado)."""
+        return self.plan.arena_bytes if self.plan else 0
+
+    def _load_scaler(self, scaler):
+        if scaler == '-':
+            self.mean, self.scale = [0.0] * self.features, [1.0] * self.features
+            self.raw_input = True
+        else:
+            self.mean, self.scale = load_scaler(scaler)
+            self.raw_input = False
+        if len(self.mean) != self.features:
+            fail('%s: scaler com %d features, modelo com %d' % (self.name, len(self.mean), self.features))
+
+    def _load_keras(self, scaler, engine):
+        """GRU direto do .keras: sem flatbuffer, só o motor gerado (tools/gen_gru_engine.py)."""
+        if engine != 'codegen':
+            fail('%s: o conversor exporta o GRU com TensorListReserve, sem kernel no TFLM; '
+                 'use INFERENCE_ENGINE=CODEGEN (firmware/gru_engine.cpp)' % self.name)
+        if scaler == '-':
+            fail('%s: MODEL_RAW_INPUT não dobra o scaler em modelos .keras' % self.name)
+        m = GruModel(self.path)
+        self.kind = 'gru'
+        self.window, self.features, self.horizons = m.window, m.features, m.horizons
+        self.int8 = False
+        self._load_scaler(scaler)
+        self.hybrid = 0
+        self.hybrid_error = None
+        self.data = None
+        self.plan = None
+        self.offline_plan = False
+        self.ops = ['GRU', 'FULLY_CONNECTED']
+        self.op_versions = {}
+        self.num_ops = 3
+        self.macs, self.params = m.macs, m.params
+        self.activation_bytes = m.activation_bytes
+
+
+def registry_arena(entries, margin):
+    """Arena compartilhada (tflm_wrapper.cpp): as ativações são reaproveitadas entre os modelos, a
+    parte persistente de cada um fica no fim, uma atrás da outra."""
+    plans = [e.plan for e in entries]
+    return align(max(p.head for p in plans) + max(p.temp for p in plans) + sum(p.persistent for p in plans) +
+                 ALLOCATOR_BYTES + margin)
+
+
+def resolver_ops(entries):
+    """União dos operadores do registro: [(op, [(modelo, versão)])] na ordem do primeiro uso."""
+    out = []
+    for e in entries:
+        for op in e.ops:
+            if op not in [o for o, _ in out]:
+                out.append((op, [(x.name, x.op_versions[op]) for x in entries if op in x.ops]))
+    return out
+
+
+def write_registry(dst, entries, engine, arena):
+    """arena: (planejada com margem, margem, mínima) no TFLM, None no CODEGEN."""
+    first = entries[0]
+    out = []
+    out.append('// Model registry - TinyML')
+    out.append('// Auto-generated by tools/gen_model_registry.py - Do not edit manually')
+    for e in entries:
+        out.append('// %s: %s' % (e.name, os.path.basename(os.path.dirname(os.path.abspath(e.path))) + '/' +
+                                  os.path.basename(e.path)))
+    out.append('')
+    out.append('#pragma once')
+    out.append('#include "model_registry.h"')
+    if engine == 'codegen':
+        out.append('#include "codegen_engine.h"')
+    else:
+        out.append('#include "tensorflow/lite/micro/micro_mutable_op_resolver.h"')
+    out.append('')
+    out.append('#define MODEL_REGISTRY_COUNT    %d' % len(entries))
+    out.append('#define MODEL_REGISTRY_WINDOW   %d' % first.window)
+    out.append('#define MODEL_REGISTRY_FEATURES %d' % first.features)
+    out.append('#define MODEL_REGISTRY_HORIZONS %d' % first.horizons)
+    if arena:
+        planned, margin, minimum = arena
+        out.append('#define MODEL_REGISTRY_ARENA_BYTES %d // max(planned, --arena-min)' % max(planned, minimum))
+        out.append('#define MODEL_REGISTRY_PLANNED_ARENA_BYTES %d // tools/plan_arena.py, with margin' % planned)
+        out.append('#define MODEL_REGISTRY_ARENA_MARGIN %d' % margin)
+    out.append('')
+    for e in entries:
+        if e.data is not None:
+            out.append('// %s: %d bytes%s%s' % (e.name, len(e.data),
+                                               ', %d camada(s) híbrida(s) dequantizada(s) para float32' % e.hybrid
+                                               if e.hybrid else '',
+                                               ', arena planejada offline' if e.offline_plan else ''))
+            out.append('alignas(16) static const unsigned char model_%s_tflite[] = {' % e.ident)
+            out.append(c_array(e.data))
+            out.append('};')
+        out.append('static const float model_%s_scaler_mean[]  = {%s};' % (
+            e.ident, ', '.join('%.6ff' % v for v in e.mean)))
+        out.append('static const float model_%s_scaler_scale[] = {%s};' % (
+            e.ident, ', '.join('%.6ff' % v for v in e.scale)))
+        out.append('')
+    out.append('static const model_descriptor_t model_registry[MODEL_REGISTRY_COUNT] = {')
+    for e in entries:
+        tflite = ('model_%s_tflite' % e.ident, '%d' % len(e.data)) if e.data is not None else ('nullptr', '0')
+        out.append('    {"%s", %s, %s, %d, %d, %d, %d, %d, %d, %d, "%s", %d, %d, %d, %d, model_%s_scaler_mean, '
+                   'model_%s_scaler_scale},' % (
+                       e.name, tflite[0], tflite[1], e.window, e.features, e.horizons, int(e.int8),
+                       int(e.raw_input), int(bool(e.hybrid) and e.data is not None), e.num_ops, ' '.join(e.ops),
+                       e.params, e.macs, e.activation_bytes, e.arena_bytes, e.ident, e.ident))
+    out.append('};')
+    if engine == 'codegen':
+        out.append('')
+        kinds = []
+        for e in entries:
+            if e.kind not in kinds:
+                kinds.append(e.kind)
+        for k in kinds:
+            out.append('namespace %s_engine { extern const codegen_engine_t engine; }' % k)
+        out.append('static const codegen_engine_t* const model_registry_engines[MODEL_REGISTRY_COUNT] = {')
+        out.append('    %s,' % ', '.join('&%s_engine::engine' % e.kind for e in entries))
+        out.append('};')
+    else:
+        ops = resolver_ops(entries)
+        out.append('')
+        out.append('// Op resolver: exactly the ops of the registry models (TFLM resolves by builtin code,')
+        out.append('// the version each model needs is in the comments)')
+        out.append('#define MODEL_REGISTRY_OP_COUNT %d' % len(ops))
+        out.append('static inline void model_registry_add_ops(tflite::MicroMutableOpResolver<MODEL_REGISTRY_OP_COUNT>& r) {')
+        width = max(len(TFLM_KERNELS[op][0]) for op, _ in ops) + len('r.();')
+        for op, users in ops:
+            out.append('    %-*s // %s: %s' % (width, 'r.%s();' % TFLM_KERNELS[op][0], op,
+                                              ', '.join('%s v%d' % u for u in users)))
+        out.append('}')
+    out.append('')
+
+    text = '\n'.join(out)
+    if os.path.exists(dst) and open(dst).read() == text:
+        #evita recompilar quando os modelos não mudaram; o mtime avança mesmo assim, senão a saída fica
+        #mais velha que as dependências e o comando do CMake roda de novo em todo build
+        os.utime(dst, None)
+        return
+    os.makedirs(os.path.dirname(os.path.abspath(dst)), exist_ok=True)
+    with open(dst, 'w') as f:
+        f.write(text)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Gera o registro de modelos embarcados')
+    ap.add_argument('output', nargs='?')
+    ap.add_argument('--engine', choices=('tflm', 'codegen'), default='tflm')
+    ap.add_argument('--model', nargs=3, action='append', default=[], metavar=('NOME', 'MODELO', 'SCALER'))
+    ap.add_argument('--reference-scaler', help='scaler_params.h usado pelo firmware para normalizar a janela')
+    ap.add_argument('--tol', type=float, default=0.05,
+                    help='diferença máxima aceita entre pesos dequantizados e kernel híbrido em °C (padrão 0.05)')
+    ap.add_argument('--arena-margin', type=int, default=2048,
+                    help='bytes somados à arena planejada do TFLM (padrão 2048)')
+    ap.add_argument('--arena-budget', type=int, default=0,
+                    help='arena máxima do TFLM em bytes; o build falha acima dela (0: sem limite)')
+    ap.add_argument('--arena-min', type=int, default=0,
+                    help='arena mínima alocada em bytes, mesmo com o plano menor (padrão 0)')
+    ap.add_argument('--offline-plan', action='store_true',
+                    help='embute o plano no flatbuffer (metadado OfflineMemoryAllocation)')
+    ap.add_argument('--kind', metavar='MODELO', help='imprime o motor gerado que cobre o grafo e sai')
+    args = ap.parse_args()
+
+    if args.kind:
+        if args.kind.endswith('.keras'):
+            GruModel(args.kind)  #falha se o .keras não for o GRU coberto pelo motor
+            print('gru')
+            return
+        kind = engine_kind(Model.load(args.kind))
+        if kind is None:
+            fail('nenhum motor gerado cobre o grafo de %s' % args.kind)
+        print(kind)
+        return
+    if not args.output or not args.model:
+        fail('uso: gen_model_registry.py <saida.h> --model NOME MODELO SCALER [--model ...]')
+    if len(args.model) > MAX_MODELS:
+        fail('%d modelos, o registro aceita até %d' % (len(args.model), MAX_MODELS))
+
+    entries = [Entry(name, path, scaler, args.engine, args.tol, args.offline_plan)
+               for name, path, scaler in args.model]
+    names = [e.ident for e in entries]
+    if len(set(names)) != len(names):
+        fail('nomes de modelo repetidos: %s' % names)
+    first = entries[0]
+    for e in entries[1:]:
+        if (e.window, e.features, e.horizons) != (first.window, first.features, first.horizons):
+            fail('%s: janela [%d, %d] -> %d difere de %s' % (e.name, e.window, e.features, e.horizons, first.name))
+    if args.engine == 'codegen':
+        kinds = [e.kind for e in entries]
+        if len(set(kinds)) != len(kinds):
+            fail('dois modelos usam o motor %s: cada motor gerado entra uma vez na imagem' % kinds)
+    if args.reference_scaler:
+        ref = load_scaler(args.reference_scaler)
+        for e in entries:
+            if not e.raw_input and (e.mean, e.scale) != ref:
+                fail('%s: scaler difere de %s (a janela é normalizada uma vez para todos os modelos)' %
+                     (e.name, args.reference_scaler))
+    if len(entries) > 1 and any(e.raw_input for e in entries):
+        fail('modelo com o scaler dobrado (SCALER -) só pode ser o único do registro')
+
+    arena = registry_arena(entries, args.arena_margin) if args.engine == 'tflm' else 0
+    if args.arena_budget and arena > args.arena_budget:
+        fail('arena do TFLM de %d bytes não cabe em %d (%s)' % (
+            arena, args.arena_budget, ', '.join('%s %d' % (e.name, e.arena_bytes) for e in entries)))
+
+    write_registry(args.output, entries, args.engine,
+                   (arena, args.arena_margin, args.arena_min) if arena else None)
+    for e in entries:
+        extra = ''
+        if e.hybrid_error is not None:
+            extra = ', pesos híbridos -> float32 (máx %.3g °C do kernel híbrido)' % e.hybrid_error
+        if e.plan is not None:
+            extra += ', %d planejados com reuso' % e.plan.head
+        print('gen_model_registry: %s (%s): %d ops, %d parâmetros, %d MACs, %d bytes de ativações%s' % (
+            e.name, os.path.basename(e.path), e.num_ops, e.params, e.macs, e.activation_bytes, extra))
+    if args.engine == 'tflm':
+        ops = resolver_ops(entries)
+        print('gen_model_registry: resolver com %d operador(es): %s' % (
+            len(ops), ' '.join('%s v%d' % (op, max(v for _, v in users)) for op, users in ops)))
+    if arena:
+        print('gen_model_registry: arena do TFLM %d bytes planejados (margem %d%s), %d alocados%s' % (
+            arena, args.arena_margin, ', limite %d' % args.arena_budget if args.arena_budget else '',
+            max(arena, args.arena_min), ', plano offline no flatbuffer' if args.offline_plan else ''))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,169 @@
+"""
+Janelas fixas e saídas de referência para os testes host dos motores gerados (host/tests/).
+
+As janelas são sequências suaves em z-score (passeio aleatório de semente fixa, limitado a ±3) e
+duas janelas de borda (todas as features na média e nos extremos alternados). A saída esperada de
+cada janela vem do interpretador de referência de tools/tflite_interpreter.py, em aritmética float32 com
+a mesma ordem de acumulação dos kernels: o motor gerado deve bater dentro de poucos ULPs.
+
+Para um .keras (GRU, sem flatbuffer), a saída vem de keras_forward(): as contas de
+keras.layers.GRUCell.call (reset_after) e Dense.call transcritas sobre os pesos crus do
+model.weights.h5, no layout do Keras ([entrada][saída], bias [2][3u]), em float64. Não passa pelo
+GruModel de tools/gen_gru_engine.py, então confere também a transposição e a ordem dos portões
+que o gerador escreve para o motor.
+
+Uso: python3 tools/gen_test_vectors.py <modelo.tflite|.h|.keras> <saida.h> [--windows N] [--seed S]
+"""
+import argparse
+import math
+import os
+import random
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import Model  # noqa: E402
+from tflite_interpreter import evaluate, f32  # noqa: E402
+from keras_reader import KerasModel  # noqa: E402
+
+KERAS_ACTIVATIONS = {
+    'linear': lambda v: v,
+    'relu': lambda v: max(0.0, v),
+    'tanh': math.tanh,
+    'sigmoid': lambda v: 1.0 / (1.0 + math.exp(-v)),
+}
+
+
+def fail(msg):
+    sys.stderr.write('gen_test_vectors: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def make_windows(count, window, features, seed):
+    rng = random.Random(seed)
+    out = [[0.0] * (window * features),
+           [3.0 if (t + f) % 2 else -3.0 for t in range(window) for f in range(features)]]
+    while len(out) < count:
+        z = [max(-3.0, min(3.0, rng.gauss(0.0, 1.0))) for _ in range(features)]
+        rows = []
+        for _ in range(window):
+            z = [max(-3.0, min(3.0, v + rng.gauss(0.0, 0.15))) for v in z]
+            rows += z
+        out.append([f32(v) for v in rows])
+    return out[:count]
+
+
+def keras_matmul(x, kernel, cols, start, stop):
+    """x @ kernel[:, start:stop] com o kernel [len(x)][cols] achatado do Keras."""
+    return [sum(x[i] * kernel[i * cols + o] for i in range(len(x))) for o in range(start, stop)]
+
+
+def keras_gru(layer, sequence):
+    """GRUCell.call do Keras 3 com reset_after=True, passo a passo; devolve o último estado."""
+    c = layer.config
+    if not c.get('reset_after') or c.get('return_sequences') or c.get('go_backwards') or not c.get('use_bias'):
+        fail('%s: só GRU reset_after, com bias, último estado' % layer.name)
+    act, rec_act = KERAS_ACTIVATIONS[c['activation']], KERAS_ACTIVATIONS[c['recurrent_activation']]
+    u = c['units']
+    (_, kernel), (_, recurrent_kernel), (_, bias) = layer.weights
+    input_bias, recurrent_bias = bias[:3 * u], bias[3 * u:] #ops.split(self.bias, 2)
+    h_tm1 = [0.0] * u
+    for x in sequence:
+        x_z = [a + b for a, b in zip(keras_matmul(x, kernel, 3 * u, 0, u), input_bias[:u])]
+        x_r = [a + b for a, b in zip(keras_matmul(x, kernel, 3 * u, u, 2 * u), input_bias[u:2 * u])]
+        x_h = [a + b for a, b in zip(keras_matmul(x, kernel, 3 * u, 2 * u, 3 * u), input_bias[2 * u:])]
+        recurrent_z = [a + b for a, b in zip(keras_matmul(h_tm1, recurrent_kernel, 3 * u, 0, u),
+                                             recurrent_bias[:u])]
+        recurrent_r = [a + b for a, b in zip(keras_matmul(h_tm1, recurrent_kernel, 3 * u, u, 2 * u),
+                                             recurrent_bias[u:2 * u])]
+        z = [rec_act(a + b) for a, b in zip(x_z, recurrent_z)]
+        r = [rec_act(a + b) for a, b in zip(x_r, recurrent_r)]
+        recurrent_h = [a + b for a, b in zip(keras_matmul(h_tm1, recurrent_kernel, 3 * u, 2 * u, 3 * u),
+                                             recurrent_bias[2 * u:])]
+        hh = [act(a + ri * b) for a, ri, b in zip(x_h, r, recurrent_h)]
+        h_tm1 = [zi * hp + (1.0 - zi) * hi for zi, hp, hi in zip(z, h_tm1, hh)]
+    return h_tm1
+
+
+def keras_forward(model, window, features):
+    """Saída do modelo Sequential do .keras para uma janela [janela*features] (GRU, Dense, Dropout)."""
+    x = [window[t:t + features] for t in range(0, len(window), features)]
+    for layer in model.layers:
+        if layer.class_name == 'Dropout':
+            continue #identidade na inferência
+        if layer.class_name == 'GRU':
+            x = keras_gru(layer, x)
+        elif layer.class_name == 'Dense':
+            (shape, kernel), (_, bias) = layer.weights
+            act = KERAS_ACTIVATIONS[layer.config['activation']]
+            x = [act(v + b) for v, b in zip(keras_matmul(x, kernel, shape[1], 0, shape[1]), bias)]
+        else:
+            fail('%s: camada %s sem referência' % (layer.name, layer.class_name))
+    return x
+
+
+def c_rows(rows, per_line, indent='    '):
+    lines = []
+    for r in rows:
+        lines.append(indent + '{')
+        for i in range(0, len(r), per_line):
+            lines.append(indent * 2 + ' '.join('%.9ef,' % v for v in r[i:i + per_line]))
+        lines.append(indent + '},')
+    return '\n'.join(lines)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Vetores de teste dos motores gerados')
+    ap.add_argument('model')
+    ap.add_argument('output')
+    ap.add_argument('--windows', type=int, default=8, help='número de janelas (padrão 8)')
+    ap.add_argument('--seed', type=int, default=1)
+    args = ap.parse_args()
+
+    if args.model.endswith('.keras'):
+        model = KerasModel(args.model)
+        shape = model.input_shape
+        if not shape or len(shape) != 3:
+            fail('entrada %s, esperado [batch, janela, features]' % shape)
+        window, features = shape[1], shape[2]
+        windows = make_windows(max(2, args.windows), window, features, args.seed)
+        expected = [keras_forward(model, w, features) for w in windows]
+        horizons = len(expected[0])
+        reference = 'Keras GRUCell/Dense in float64'
+    else:
+        model = Model.load(args.model)
+        x = model.tensors[model.inputs[0]]
+        y = model.tensors[model.outputs[0]]
+        if len(x.shape) != 3 or x.type != 'float32':
+            fail('entrada %s %s, esperado float32 [1, janela, features]' % (x.type, x.shape))
+        window, features, horizons = x.shape[1], x.shape[2], y.num_elements
+        windows = make_windows(max(2, args.windows), window, features, args.seed)
+        expected = [evaluate(model, w, f32) for w in windows]
+        reference = 'float32 reference interpreter'
+
+    out = ['// Engine test vectors - TinyML',
+           '// Auto-generated by tools/gen_test_vectors.py - Do not edit manually',
+           '// Source: %s (%s)' % (os.path.basename(args.model), reference),
+           '',
+           '#pragma once',
+           '',
+           'constexpr int kTestWindows  = %d;' % len(windows),
+           'constexpr int kTestWindow   = %d;' % window,
+           'constexpr int kTestFeatures = %d;' % features,
+           'constexpr int kTestHorizons = %d;' % horizons,
+           '',
+           'static const float test_windows[kTestWindows][kTestWindow * kTestFeatures] = {',
+           c_rows(windows, features),  #uma linha por passo de tempo
+           '};',
+           '',
+           'static const float test_expected[kTestWindows][kTestHorizons] = {',
+           c_rows(expected, horizons),
+           '};',
+           '']
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'w') as f:
+        f.write('\n'.join(out))
+    print('gen_test_vectors: %d janelas de %s' % (len(windows), os.path.basename(args.model)))
+
+
+if __name__ == '__main__':
+    main()
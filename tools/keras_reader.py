@@ -0,0 +1,202 @@
+"""
+Leitor mínimo de modelos .keras (Keras 3) sem dependências externas.
+
+O .keras é um zip com config.json (arquitetura) e model.weights.h5 (pesos). O HDF5
+gravado pelo h5py para esses modelos usa só o formato clássico: superbloco v0, grupos
+com tabela de símbolos (B-tree v1 + heap local), cabeçalhos de objeto v1 e datasets
+float32 contíguos ou compactos. É o que este leitor cobre; qualquer outra coisa falha.
+
+Usado por tools/gen_gru_engine.py para modelos que o conversor TFLite não exporta
+para o TFLM (GRU com TensorListReserve).
+"""
+import json
+import struct
+import zipfile
+
+
+class H5Error(Exception):
+    pass
+
+
+class _H5:
+    """Grupos e datasets de um arquivo HDF5 clássico, por caminho ('layers/dense/vars/0')."""
+
+    def __init__(self, data):
+        self.data = data
+        if data[:8] != b'\x89HDF\r\n\x1a\n':
+            raise H5Error('assinatura HDF5 ausente')
+        if data[8] != 0:
+            raise H5Error('superbloco v%d não suportado' % data[8])
+        if data[13] != 8 or data[14] != 8:
+            raise H5Error('offsets de %d bytes não suportados' % data[13])
+        #entrada da tabela de símbolos do grupo raiz: nome, cabeçalho, cache (B-tree, heap)
+        self.root = self._group_from_header(struct.unpack_from('<Q', data, 0x38 + 8)[0])
+
+    def _u(self, fmt, pos):
+        return struct.unpack_from('<' + fmt, self.data, pos)
+
+    def _messages(self, addr):
+        """Mensagens (tipo, dados) de um cabeçalho de objeto v1, seguindo as continuações."""
+        version, _, count = self._u('BBH', addr)
+        if version != 1:
+            raise H5Error('cabeçalho de objeto v%d não suportado' % version)
+        size = self._u('I', addr + 8)[0]
+        blocks = [(addr + 16, size)]
+        out = []
+        while blocks and len(out) < count:
+            pos, size = blocks.pop(0)
+            end = pos + size
+            while pos + 8 <= end and len(out) < count:
+                mtype, msize = self._u('HH', pos)
+                body = self.data[pos + 8:pos + 8 + msize]
+                if mtype == 0x10: #continuação
+                    blocks.append(struct.unpack_from('<QQ', body, 0))
+                out.append((mtype, body))
+                pos += 8 + msize
+        return out
+
+    def _group_from_header(self, addr):
+        for mtype, body in self._messages(addr):
+            if mtype == 0x11: #tabela de símbolos: B-tree v1 + heap local
+                btree, heap = struct.unpack_from('<QQ', body, 0)
+                return self._symbols(btree, heap)
+        return None #não é grupo
+
+    def _heap_name(self, heap, offset):
+        if self.data[heap:heap + 4] != b'HEAP':
+            raise H5Error('heap local inválido')
+        base = self._u('Q', heap + 24)[0]
+        end = self.data.index(b'\0', base + offset)
+        return self.data[base + offset:end].decode()
+
+    def _symbols(self, btree, heap):
+        """Nome -> endereço do cabeçalho de objeto, percorrendo a B-tree do grupo."""
+        if self.data[btree:btree + 4] != b'TREE':
+            raise H5Error('B-tree inválida')
+        _, level, used = self._u('BBH', btree + 4)
+        entries = {}
+        pos = btree + 24 + 8 #primeira chave
+        for _ in range(used):
+            child = self._u('Q', pos)[0]
+            if level > 0:
+                entries.update(self._symbols(child, heap))
+            else:
+                if self.data[child:child + 4] != b'SNOD':
+                    raise H5Error('nó de símbolos inválido')
+                for i in range(self._u('H', child + 6)[0]):
+                    name_off, header = self._u('QQ', child + 8 + 40 * i)
+                    entries[self._heap_name(heap, name_off)] = header
+            pos += 16
+        return entries
+
+    def _lookup(self, path):
+        group = self.root
+        parts = [p for p in path.split('/') if p]
+        for i, name in enumerate(parts):
+            if group is None or name not in group:
+                raise H5Error('%s não encontrado' % '/'.join(parts[:i + 1]))
+            if i == len(parts) - 1:
+                return group[name]
+            group = self._group_from_header(group[name])
+        raise H5Error('caminho vazio')
+
+    def children(self, path=''):
+        group = self.root if not path else self._group_from_header(self._lookup(path))
+        return sorted(group) if group is not None else []
+
+    def dataset(self, path):
+        """(forma, valores float32 achatados em ordem C) de um dataset."""
+        shape, raw = None, None
+        for mtype, body in self._messages(self._lookup(path)):
+            if mtype == 0x01: #dataspace
+                version, rank, flags = body[0], body[1], body[2]
+                off = 8 if version == 1 else 4
+                shape = list(struct.unpack_from('<%dQ' % rank, body, off))
+            elif mtype == 0x03: #datatype
+                cls, size = body[0] & 0x0F, struct.unpack_from('<I', body, 4)[0]
+                if cls != 1 or size != 4 or body[1] & 1:
+                    raise H5Error('%s: só float32 little-endian' % path)
+            elif mtype == 0x0B:
+                raise H5Error('%s: dataset com filtros (compressão) não suportado' % path)
+            elif mtype == 0x08: #layout
+                if body[0] != 3:
+                    raise H5Error('%s: layout v%d não suportado' % (path, body[0]))
+                if body[1] == 0: #compacto
+                    size = struct.unpack_from('<H', body, 2)[0]
+                    raw = body[4:4 + size]
+                elif body[1] == 1: #contíguo
+                    addr, size = struct.unpack_from('<QQ', body, 2)
+                    raw = self.data[addr:addr + size] if addr != 0xFFFFFFFFFFFFFFFF else b''
+                else:
+                    raise H5Error('%s: layout em chunks não suportado' % path)
+        if shape is None or raw is None:
+            raise H5Error('%s não é um dataset' % path)
+        n = 1
+        for d in shape:
+            n *= d
+        if len(raw) != 4 * n:
+            raise H5Error('%s: %d bytes para a forma %s' % (path, len(raw), shape))
+        return shape, list(struct.unpack('<%df' % n, raw))
+
+
+class Layer:
+    def __init__(self, class_name, config, weights):
+        self.class_name = class_name
+        self.config = config
+        self.name = config.get('name')
+        self.weights = weights #[(forma, valores)] na ordem das variáveis do Keras
+
+
+class KerasModel:
+    """Camadas do config.json com os pesos de model.weights.h5, na ordem do modelo sequencial."""
+
+    def __init__(self, path):
+        with zipfile.ZipFile(path) as z:
+            config = json.loads(z.read('config.json'))
+            self.h5 = _H5(z.read('model.weights.h5'))
+        if config.get('class_name') != 'Sequential':
+            raise H5Error('só modelos Sequential (%s)' % config.get('class_name'))
+        self.name = config['config'].get('name')
+        layers = config['config']['layers']
+        self.input_shape = None
+        if layers and layers[0]['class_name'] == 'InputLayer':
+            self.input_shape = layers[0]['config']['batch_shape']
+            layers = layers[1:]
+        #Keras 3 grava os pesos por caminho derivado da classe (gru, dense, dense_1, ...), na ordem do modelo
+        stored = self.h5.children('layers')
+        counts = {}
+        self.layers = []
+        for layer in layers:
+            base = _snake(layer['class_name'])
+            n = counts.get(base, 0)
+            counts[base] = n + 1
+            key = base if n == 0 else '%s_%d' % (base, n)
+            weights = []
+            if key in stored:
+                vars_path = 'layers/%s/vars' % key
+                if 'cell' in self.h5.children('layers/' + key):
+                    vars_path = 'layers/%s/cell/vars' % key #RNNs guardam os pesos na célula
+                names = self.h5.children(vars_path)
+                weights = [self.h5.dataset('%s/%s' % (vars_path, v)) for v in sorted(names, key=int)]
+            self.layers.append(Layer(layer['class_name'], layer['config'], weights))
+
+
+def _snake(name):
+    out = ''
+    for i, c in enumerate(name):
+        if c.isupper() and i and (not name[i - 1].isupper() or (i + 1 < len(name) and name[i + 1].islower())):
+            out += '_'
+        out += c.lower()
+    return out
+
+
+def dump(model):
+    print('%s: entrada %s' % (model.name, model.input_shape))
+    for layer in model.layers:
+        shapes = ' '.join(str(s) for s, _ in layer.weights)
+        print('  %-10s %-14s %s' % (layer.class_name, layer.name, shapes))
+
+
+if __name__ == '__main__':
+    import sys
+    dump(KerasModel(sys.argv[1]))
@@ -0,0 +1,147 @@
+"""
+Flash dos kernels do TFLM por operador e por modelo, a partir do .map do link do firmware.
+
+O resolver gerado por tools/gen_model_registry.py registra só os operadores do registro, então só os
+kernels deles entram na imagem. Este relatório soma as seções .text/.rodata de cada objeto de kernel
+do pico-tflmicro (conv.cpp.obj, fully_connected_common.cpp.obj... via TFLM_KERNELS) e atribui os bytes
+aos operadores e aos modelos do registro (descritores de model_registry_data.h). Kernels usados por
+mais de um operador (pooling, reduce) contam uma vez no total.
+
+O .text da imagem inteira (seção de saída .text do mapa) sai junto. Com --baseline (o .map de um
+build com outro resolver, por exemplo o temperature_prediction_fixed_resolver do TFLM_FLASH_BASELINE,
+com os 11 operadores fixos de antes), o .text sai como antes -> depois, e por modelo a flash dos kernels
+de operadores no baseline contra a dos que ele usa (a da imagem só com ele). Os números só existem
+depois de um link real com o pico-tflmicro: nada aqui é estimado.
+
+Uso: python3 tools/op_flash_report.py <firmware.elf.map> --registry model_registry_data.h
+                                      [--baseline outro.elf.map]
+"""
+import argparse
+import os
+import re
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import TFLM_KERNELS  # noqa: E402
+
+#entrada de seção no mapa do GNU ld: [nome] endereço tamanho arquivo (o nome longo fica na linha de cima)
+SECTION_RE = re.compile(r'^ (\.\S+)?\s+0x([0-9a-fA-F]+)\s+0x([0-9a-fA-F]+)\s+(\S.*)$')
+#objeto de kernel: membro de libpico-tflmicro.a ou objeto solto em .../kernels/
+KERNEL_RE = re.compile(r'tflmicro[^(]*\(([^)]+)\)$|[/\\]kernels[/\\](?:[^/\\]+[/\\])?([^/\\()]+)$')
+#seção de saída .text (coluna 0): endereço e tamanho
+TEXT_RE = re.compile(r'^\.text\s+0x[0-9a-fA-F]+\s+0x([0-9a-fA-F]+)')
+#descritor em model_registry_data.h: {"nome", ..., "OPS", ...}
+DESCRIPTOR_RE = re.compile(r'^\s*\{"([^"]+)",[^"]*"([A-Z0-9_ ]*)"')
+
+
+def kernel_bytes(path):
+    """Bytes em flash (.text*, .rodata*) por fonte de kernel ('conv', 'conv_common', ...)."""
+    sizes = {}
+    section = None
+    in_map = False
+    with open(path, errors='replace') as f:
+        for line in f:
+            line = line.rstrip('\n')
+            if not in_map:
+                #antes disso vêm as seções descartadas pelo --gc-sections
+                in_map = line.startswith('Linker script and memory map')
+                continue
+            m = SECTION_RE.match(line)
+            if not m:
+                s = line.strip()
+                section = s if s.startswith('.') and ' ' not in s else None
+                continue
+            name = m.group(1) or section
+            section = None
+            size = int(m.group(3), 16)
+            if not name or not size or not (name.startswith('.text') or name.startswith('.rodata')):
+                continue
+            k = KERNEL_RE.search(m.group(4).strip())
+            if k:
+                stem = os.path.basename(k.group(1) or k.group(2)).split('.')[0]
+                sizes[stem] = sizes.get(stem, 0) + size
+    return sizes
+
+
+def image_text(path):
+    """Tamanho da seção de saída .text da imagem (None se o mapa não tiver)."""
+    with open(path, errors='replace') as f:
+        for line in f:
+            m = TEXT_RE.match(line)
+            if m:
+                return int(m.group(1), 16)
+    return None
+
+
+def registry_ops(path):
+    models = []
+    with open(path) as f:
+        for line in f:
+            m = DESCRIPTOR_RE.match(line)
+            if m:
+                models.append((m.group(1), m.group(2).split()))
+    return models
+
+
+def ops_bytes(ops, sizes):
+    """Flash dos kernels de um conjunto de operadores (fonte compartilhada conta uma vez)."""
+    stems = set()
+    for op in ops:
+        stems.update(TFLM_KERNELS[op][1] if op in TFLM_KERNELS else [])
+    return sum(sizes.get(s, 0) for s in stems)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Flash dos kernels do TFLM por operador e por modelo')
+    ap.add_argument('map', help='.map do link do firmware (temperature_prediction.elf.map)')
+    ap.add_argument('--registry', required=True, help='model_registry_data.h gerado')
+    ap.add_argument('--baseline', help='.map de um build com outro resolver, para o antes/depois e a economia por modelo')
+    args = ap.parse_args()
+
+    sizes = kernel_bytes(args.map)
+    models = registry_ops(args.registry)
+    if not models:
+        sys.exit('op_flash_report: nenhum descritor em %s' % args.registry)
+    used = []
+    for _, ops in models:
+        used += [op for op in ops if op not in used]
+
+    print('op_flash_report: kernels do TFLM na imagem (%s)' % os.path.basename(args.map))
+    for op in used:
+        stems = TFLM_KERNELS[op][1] if op in TFLM_KERNELS else []
+        print('  %-18s %7d B  %s' % (op, ops_bytes([op], sizes), ', '.join(stems)))
+    total = sum(sizes.values())
+    print('  %-18s %7d B  (%d objetos de kernel, com os utilitários comuns)' % ('total', total, len(sizes)))
+    if not total:
+        print('  nenhum objeto de kernel do pico-tflmicro no mapa')
+
+    text = image_text(args.map)
+    baseline = kernel_bytes(args.baseline) if args.baseline else None
+    base_text = image_text(args.baseline) if args.baseline else None
+    if text is not None and base_text is not None:
+        print('  .text da imagem: %d B antes (%s) -> %d B depois, %+d B' % (
+            base_text, os.path.basename(args.baseline), text, text - base_text))
+    elif text is not None:
+        print('  .text da imagem: %d B (sem --baseline para o antes)' % text)
+    if baseline is not None:
+        #só os kernels de algum operador: os utilitários comuns ficam em qualquer resolver
+        stems = set(s for kernel in TFLM_KERNELS.values() for s in kernel[1])
+        base_total = sum(v for s, v in baseline.items() if s in stems)
+    for i, (name, ops) in enumerate(models):
+        line = '  %s: %d operador(es), kernels %d B' % (name, len(ops), ops_bytes(ops, sizes))
+        if len(models) > 1:
+            #o que sai da imagem sem este modelo no registro
+            others = [op for j, (_, o) in enumerate(models) if j != i for op in o]
+            line += ', %d B só dele' % (ops_bytes(used, sizes) - ops_bytes(others, sizes))
+        if baseline is not None:
+            line += '; kernels do baseline %d -> %d B (%+d B)' % (
+                base_total, ops_bytes(ops, baseline), ops_bytes(ops, baseline) - base_total)
+        print(line)
+    if baseline is not None:
+        gone = sorted(s for s in baseline if s not in sizes)
+        print('  fora da imagem: %s (%d B no baseline)' % (
+            ', '.join(gone) or '-', sum(baseline[s] for s in gone)))
+
+
+if __name__ == '__main__':
+    main()
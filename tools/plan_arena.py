@@ -0,0 +1,227 @@
+"""
+Planejamento offline da arena do TFLM para os modelos do repositório.
+
+Refaz no host o que o MicroAllocator faz no AllocateTensors(): tempo de vida de cada tensor não
+constante (do operador que o produz ao último que o consome; a entrada do grafo vive desde o op 0 e
+a saída até o último) e o GreedyMemoryPlanner (buffers alinhados em 16, do maior para o menor, cada
+um no menor offset que não colide com os já colocados que vivem ao mesmo tempo). O resultado é o
+tamanho da área de ativações ("head") e o offset de cada tensor.
+
+A parte persistente (fim da arena: tensores de avaliação, nós, dados dos kernels) e a área temporária
+do próprio AllocateTensors() não saem do flatbuffer: são estimadas pelas estruturas do TFLM, e a margem
+cobre o erro da estimativa e os scratch buffers que os kernels pedem no Prepare.
+
+Os offsets podem ir no modelo como metadado "OfflineMemoryAllocation" (embed_offline_plan): com ele o
+TFLM usa o plano pronto em vez de rodar o planner guloso no boot.
+
+Uso: python3 tools/plan_arena.py [MODELO ...] [--margin BYTES] [--header saida.h]
+     sem MODELO, todos os models/*/temperature_model.tflite
+"""
+import argparse
+import glob
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import Model  # noqa: E402
+
+ALIGN = 16                #MicroArenaBufferAlignment()
+OFFLINE_PLAN_NAME = 'OfflineMemoryAllocation'
+ONLINE = -1               #offset de um tensor deixado para o planner do TFLM (constantes)
+
+#estimativa da parte persistente, pelas estruturas do TFLM em 32 bits
+EVAL_TENSOR_BYTES = 16    #TfLiteEvalTensor por tensor do grafo
+OP_BYTES = 160            #TfLiteNode + TFLMRegistration + opções builtin + OpData do kernel
+PER_CHANNEL_BYTES = 8     #multiplicador e shift int32 por canal de saída (camadas int8 por canal)
+MODEL_BYTES = 256         #SubgraphAllocations e os TfLiteTensor de entrada/saída de um interpretador
+ALLOCATOR_BYTES = 512     #MicroAllocator, SingleArenaBufferAllocator e planner, uma vez por arena
+#área temporária do AllocateTensors() (AllocationInfo por tensor, requisitos do planner por buffer)
+TEMP_TENSOR_BYTES = 24
+TEMP_BUFFER_BYTES = 40
+
+
+def align(n):
+    return (n + ALIGN - 1) // ALIGN * ALIGN
+
+
+class Buffer:
+    def __init__(self, tensor, first, last):
+        self.tensor = tensor
+        self.size = align(tensor.num_bytes)
+        self.first = first
+        self.last = last
+        self.offset = None
+
+    def overlaps(self, other):
+        return self.first <= other.last and other.first <= self.last
+
+
+class ArenaPlan:
+    """Plano de um modelo: buffers com tempo de vida e offset, head e estimativas."""
+
+    def __init__(self, model):
+        self.model = model
+        self.buffers = lifetimes(model)
+        greedy_plan(self.buffers)
+        self.head = max([b.offset + b.size for b in self.buffers] or [0])
+        self.naive = sum(b.size for b in self.buffers)  #sem reuso entre tensores
+        self.persistent = persistent_estimate(model)
+        self.temp = align(TEMP_TENSOR_BYTES * len(model.tensors) + TEMP_BUFFER_BYTES * len(self.buffers))
+
+    @property
+    def arena_bytes(self):
+        """Arena com só este modelo, sem margem."""
+        return align(self.head + self.temp + self.persistent + ALLOCATOR_BYTES)
+
+    def offsets(self):
+        """Offset por tensor do subgrafo, ONLINE para os que não estão na área de ativações."""
+        out = [ONLINE] * len(self.model.tensors)
+        for b in self.buffers:
+            out[b.tensor.index] = b.offset
+        return out
+
+
+def lifetimes(model):
+    """Buffers dos tensores não constantes, com o primeiro e o último operador em que vivem."""
+    last_op = len(model.operators) - 1
+    first, last = {}, {}
+    for i in model.inputs:
+        first[i] = 0
+        last[i] = 0
+    for op in model.operators:
+        for i in op.inputs:
+            if i >= 0 and not model.tensors[i].is_constant:
+                first.setdefault(i, op.index)
+                last[i] = op.index
+        for i in op.outputs:
+            first.setdefault(i, op.index)
+            last[i] = max(last.get(i, op.index), op.index)
+    for i in model.outputs:
+        last[i] = last_op
+    return [Buffer(model.tensors[i], first[i], last[i]) for i in sorted(first)]
+
+
+def greedy_plan(buffers):
+    """GreedyMemoryPlanner: do maior para o menor, no menor offset livre durante o tempo de vida."""
+    placed = []
+    for b in sorted(buffers, key=lambda b: (-b.size, b.tensor.index)):
+        offset = 0
+        for other in sorted((p for p in placed if p.overlaps(b)), key=lambda p: p.offset):
+            if offset + b.size <= other.offset:
+                break
+            offset = max(offset, other.offset + other.size)
+        b.offset = offset
+        placed.append(b)
+
+
+def persistent_estimate(model):
+    total = MODEL_BYTES + EVAL_TENSOR_BYTES * len(model.tensors) + OP_BYTES * len(model.operators)
+    for op in model.operators:
+        if op.op not in ('CONV_2D', 'DEPTHWISE_CONV_2D', 'FULLY_CONNECTED'):
+            continue
+        x, w = model.tensors[op.inputs[0]], model.tensors[op.inputs[1]]
+        if x.type == 'int8' and len(w.scale) > 1:
+            total += PER_CHANNEL_BYTES * len(w.scale)
+    return align(total)
+
+
+def embed_offline_plan(model, plan):
+    """Bytes do modelo com os offsets do plano no metadado OfflineMemoryAllocation.
+
+    O conversor não reserva espaço para o metadado: a entrada CONVERSION_METADATA (só informativa,
+    ignorada pelo TFLM) é reaproveitada, com o nome e o buffer repontados para dados anexados ao fim
+    do arquivo (uoffsets só apontam para frente). Devolve None se o modelo não tem essa entrada."""
+    names = [name for name, _, _ in model.metadata]
+    if OFFLINE_PLAN_NAME in names:
+        return None  #já planejado offline
+    if 'CONVERSION_METADATA' not in names:
+        return None
+    _, buffer, name_pos = model.metadata[names.index('CONVERSION_METADATA')]
+    data_pos = model.buffer_data_pos[buffer]
+    if name_pos is None or data_pos is None or sum(1 for t in model.tensors if t.buffer == buffer):
+        return None
+    data = bytearray(model.data)
+    name = OFFLINE_PLAN_NAME.encode()
+    while len(data) % 4:
+        data.append(0)
+    string = len(data)
+    data += struct.pack('<I', len(name)) + name + b'\0'
+    #[versão, subgrafo, número de tensores, offsets...] em int32, alinhado em 16 como os pesos
+    offsets = plan.offsets()
+    values = [1, 0, len(offsets)] + offsets
+    while (len(data) + 4) % 16:
+        data.append(0)
+    vec = len(data)
+    data += struct.pack('<I', 4 * len(values)) + struct.pack('<%di' % len(values), *values)
+    struct.pack_into('<I', data, name_pos, string - name_pos)
+    struct.pack_into('<I', data, data_pos, vec - data_pos)
+    while len(data) % 16:
+        data.append(0)
+    return bytes(data)
+
+
+def offline_offsets(model):
+    """Offsets do metadado OfflineMemoryAllocation (None se o modelo não tem plano offline)."""
+    for name, buffer, _ in model.metadata:
+        if name == OFFLINE_PLAN_NAME:
+            values = list(struct.unpack('<%di' % (len(model.buffers[buffer]) // 4), model.buffers[buffer]))
+            if values[:2] != [1, 0] or values[2] != len(model.tensors) or len(values) != 3 + values[2]:
+                raise ValueError('OfflineMemoryAllocation inválido: %s' % values[:3])
+            return values[3:]
+    return None
+
+
+def dump(name, plan):
+    m = plan.model
+    print('%s: %d tensores, %d operadores' % (name, len(m.tensors), len(m.operators)))
+    print('  %-5s %7s %5s %5s %7s  %s' % ('t', 'bytes', 'de', 'até', 'offset', 'nome'))
+    for b in sorted(plan.buffers, key=lambda b: (b.first, b.tensor.index)):
+        print('  t%-4d %7d %5d %5d %7d  %s' % (b.tensor.index, b.size, b.first, b.last, b.offset,
+                                               b.tensor.name[:60]))
+    print('  ativações: %d bytes planejados (%d sem reuso)' % (plan.head, plan.naive))
+    print('  persistente ~%d bytes, temporária ~%d bytes, alocador ~%d bytes -> arena %d bytes' % (
+        plan.persistent, plan.temp, ALLOCATOR_BYTES, plan.arena_bytes))
+
+
+def model_name(path):
+    """models/<nome>/temperature_model.tflite -> <nome>; outros caminhos, o nome do arquivo."""
+    parent = os.path.basename(os.path.dirname(os.path.abspath(path)))
+    return parent if parent != 'firmware' else os.path.splitext(os.path.basename(path))[0]
+
+
+def main():
+    root = os.path.join(os.path.dirname(os.path.abspath(__file__)), '..')
+    ap = argparse.ArgumentParser(description='Planeja offline a arena do TFLM de cada modelo')
+    ap.add_argument('models', nargs='*', metavar='MODELO', help='.tflite ou .h (padrão: models/*/)')
+    ap.add_argument('--margin', type=int, default=2048, help='bytes somados à arena de cada modelo (padrão 2048)')
+    ap.add_argument('--header', help='gera um header com TFLM_ARENA_<NOME>_BYTES por modelo')
+    args = ap.parse_args()
+
+    paths = args.models or sorted(glob.glob(os.path.join(root, 'models', '*', 'temperature_model.tflite')))
+    if not paths:
+        sys.exit('plan_arena: nenhum modelo .tflite em models/')
+    out = ['// TFLM arena sizes - TinyML',
+           '// Auto-generated by tools/plan_arena.py - Do not edit manually',
+           '// planned activations + estimated persistent/temporary areas + %d bytes of margin' % args.margin,
+           '',
+           '#pragma once',
+           '']
+    for path in paths:
+        name = model_name(path)
+        plan = ArenaPlan(Model.load(path))
+        dump(name, plan)
+        print('  com margem: %d bytes\n' % align(plan.arena_bytes + args.margin))
+        ident = re.sub(r'[^0-9a-zA-Z]+', '_', name).strip('_').upper()
+        out.append('#define TFLM_ARENA_%s_BYTES %d // activations %d' % (
+            ident, align(plan.arena_bytes + args.margin), plan.head))
+    out.append('')
+    if args.header:
+        os.makedirs(os.path.dirname(os.path.abspath(args.header)), exist_ok=True)
+        with open(args.header, 'w') as f:
+            f.write('\n'.join(out))
+
+
+if __name__ == '__main__':
+    main()
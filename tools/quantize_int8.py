@@ -0,0 +1,383 @@
+"""
+Quantização int8 completa (pós-treino) do modelo Conv1D float32, sem TensorFlow.
+
+Ferramenta de experimento onde o TensorFlow não está disponível: o artefato versionado em
+models/Conv1D/temperature_model_int8.{tflite,h} sai da seção 7.4 do notebook CNN 1D (TFLiteConverter com
+as janelas de treino como representative_dataset), não daqui, e só entra no repositório depois que o
+host/tests/test_tflm_int8.cpp passar (carregado no TFLM real, perto do float32). Segue o esquema do
+TFLiteConverter com Optimize.DEFAULT, representative_dataset e entrada/saída int8:
+
+- ativações: int8 assimétrico por tensor, faixa [min, max] calibrada (sempre contendo o zero);
+  EXPAND_DIMS/RESHAPE herdam os parâmetros da entrada (o kernel só copia os bytes)
+- pesos: CONV_2D int8 simétrico por canal de saída, FULLY_CONNECTED simétrico por tensor
+- bias: int32 com escala entrada × peso (por canal), zero_point 0
+
+A calibração usa janelas normalizadas de um CSV gravado (--calibration, com o scaler do modelo); janelas
+sintéticas suaves em z-score (tools/gen_test_vectors.py) só com --synthetic, para testar a ferramenta. O modelo gerado é relido e
+avaliado com aritmética inteira no estilo do TFLM (acumulador int32, multiplicador Q31 com shift como
+MultiplyByQuantizedMultiplier); o relatório dá a diferença int8 - float32 por horizonte e, com --check,
+o MAE dos dois sobre as janelas do CSV (horizontes de host/replay.c).
+
+Uso: python3 tools/quantize_int8.py <modelo.tflite> <saida.tflite> [--header saida.h] [--like modelo.h]
+                                    --calibration CSV --scaler scaler_params.h | --synthetic [--check CSV]
+"""
+import argparse
+import math
+import os
+import re
+import struct
+import sys
+
+sys.path.insert(0, os.path.dirname(os.path.abspath(__file__)))
+from tflite_reader import Model, TENSOR_TYPES  # noqa: E402
+from tflite_writer import (Bytes, String, Table, Tables, Vector, child, copy_fields, copy_options,  # noqa: E402
+                           copy_signature_defs, opcode_code, opcode_table, root_table, scalar, serialize)
+from fold_scaler import c_array, load_scaler  # noqa: E402
+from tflite_interpreter import evaluate, f32  # noqa: E402
+from gen_test_vectors import make_windows  # noqa: E402
+
+SUPPORTED_OPS = ('EXPAND_DIMS', 'RESHAPE', 'CONV_2D', 'MEAN', 'FULLY_CONNECTED')
+#versões que o conversor grava para estes operadores com tensores int8 (op_version.cc)
+INT8_VERSIONS = {'CONV_2D': 3, 'FULLY_CONNECTED': 4, 'MEAN': 2, 'EXPAND_DIMS': 1, 'RESHAPE': 1}
+TYPE_CODES = {v: k for k, v in TENSOR_TYPES.items()}
+HORIZONS = (10, 19, 29)  #amostras após a janela, como em host/replay.c
+CSV_COLUMNS = ('Temp_AHT20_C', 'Umid_AHT20_pct', 'Temp_BMP280_C', 'Press_BMP280_hPa')
+
+
+def fail(msg):
+    sys.stderr.write('quantize_int8: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def _round(v):
+    return math.floor(v + 0.5) if v >= 0 else -math.floor(-v + 0.5)  #std::round
+
+
+def clamp(v, lo, hi):
+    return lo if v < lo else hi if v > hi else v
+
+
+#--- calibração ---
+
+def load_csv(path):
+    """Linhas [T_AHT20, UR, T_BMP280, P] do CSV (colunas pelo nome ou as 4 primeiras numéricas)."""
+    rows = []
+    with open(path) as f:
+        header = f.readline().strip().split(',')
+        cols = [header.index(c) for c in CSV_COLUMNS] if all(c in header for c in CSV_COLUMNS) else None
+        for line in f:
+            parts = line.strip().split(',')
+            try:
+                if cols is None:
+                    nums = [float(p) for p in parts if re.match(r'^-?\d+(\.\d*)?$', p.strip())]
+                    row = nums[:4]
+                else:
+                    row = [float(parts[c]) for c in cols]
+            except (ValueError, IndexError):
+                continue  #linha incompleta: ignorada, como no replay
+            if len(row) == 4:
+                rows.append(row)
+    return rows
+
+
+def csv_windows(rows, window, mean, scale):
+    z = [[f32((v - mean[f]) / scale[f]) for f, v in enumerate(r)] for r in rows]
+    return [sum(z[i:i + window], []) for i in range(len(z) - window + 1)]
+
+
+def asymmetric(lo, hi):
+    """scale/zero_point int8 de uma faixa real (o zero é sempre representável)."""
+    lo, hi = min(lo, 0.0), max(hi, 0.0)
+    scale = f32((hi - lo) / 255.0) if hi > lo else 1.0
+    return scale, int(clamp(_round(-128 - lo / scale), -128, 127))
+
+
+def calibrate(model, windows):
+    ranges = {}
+    for w in windows:
+        vals = {}
+        evaluate(model, w, f32, vals)
+        for t, v in vals.items():
+            lo, hi = ranges.get(t, (v[0], v[0]))
+            ranges[t] = (min(lo, min(v)), max(hi, max(v)))
+    return ranges
+
+
+#--- quantização ---
+
+class Quant:
+    def __init__(self, scale, zero_point, dim=0):
+        self.scale = scale if isinstance(scale, list) else [scale]
+        self.zero_point = zero_point if isinstance(zero_point, list) else [zero_point]
+        self.dim = dim
+
+
+def symmetric(values, channels):
+    """Pesos int8 simétricos (zero_point 0) com uma escala por canal da dimensão 0."""
+    inner = len(values) // channels
+    scales, q = [], []
+    for c in range(channels):
+        chunk = values[c * inner:(c + 1) * inner]
+        s = f32(max(abs(v) for v in chunk) / 127.0) or 1.0
+        scales.append(s)
+        q += [int(clamp(_round(v / s), -127, 127)) for v in chunk]
+    return scales, q
+
+
+def quantize(model, ranges):
+    """Parâmetros e buffers int8: {tensor: Quant}, {tensor: (tipo, bytes)}."""
+    quant, data = {}, {}
+    for i in model.inputs:
+        quant[i] = Quant(*asymmetric(*ranges[i]))
+    for op in model.operators:
+        x, y = op.inputs[0], op.outputs[0]
+        if op.op in ('EXPAND_DIMS', 'RESHAPE'):
+            quant[y] = quant[x]  #mesmos bytes, mesma escala
+            continue
+        quant[y] = Quant(*asymmetric(*ranges[y]))
+        if op.op == 'MEAN':
+            continue
+        wt, bt = model.tensors[op.inputs[1]], model.tensors[op.inputs[2]]
+        if wt.index in data or bt.index in data:
+            fail('op%d: pesos compartilhados com outro operador' % op.index)
+        channels = wt.shape[0]
+        per_channel = op.op == 'CONV_2D'
+        scales, q = symmetric(wt.values(), channels if per_channel else 1)
+        quant[wt.index] = Quant(scales, [0] * len(scales), 0)
+        data[wt.index] = ('int8', struct.pack('<%db' % len(q), *q))
+        s_in = quant[x].scale[0]
+        bias_scales = [f32(s_in * scales[c if per_channel else 0]) for c in range(channels)]
+        b = [int(_round(v / bias_scales[c])) for c, v in enumerate(bt.values())]
+        quant[bt.index] = Quant(bias_scales, [0] * channels, 0)
+        data[bt.index] = ('int32', struct.pack('<%di' % len(b), *b))
+    return quant, data
+
+
+#--- escrita ---
+
+def quant_table(q):
+    return Table({2: child(Vector('f', q.scale)), 3: child(Vector('q', q.zero_point, 8)),
+                  6: scalar('i', q.dim)})
+
+
+def write_model(model, quant, data):
+    root = root_table(model.data)
+    sg = root.tables(2)[0]
+    tensors = []
+    for t, src in zip(model.tensors, sg.tables(0)):
+        ttype = data[t.index][0] if t.index in data else 'int8' if t.index in quant else t.type
+        fields = {0: child(Vector('i', t.shape)), 1: scalar('b', TYPE_CODES[ttype]),
+                  2: scalar('I', t.buffer), 3: child(String(t.name))}
+        if t.index in quant:
+            fields[4] = child(quant_table(quant[t.index]))
+        if src.field_pos(7) is not None:
+            fields[7] = child(Vector('i', src.vector(7, 'i')))  #shape_signature (batch -1)
+        tensors.append(Table(fields))
+    operators = []
+    for op, src in zip(model.operators, sg.tables(3)):
+        operators.append(Table({0: scalar('I', op.opcode_index), 1: child(Vector('i', op.inputs)),
+                                2: child(Vector('i', op.outputs)), 3: scalar('B', op.options_type),
+                                4: child(copy_options(src, op.options_type))}))
+    opcodes = []
+    for (name, _), oc in zip(model.opcodes, root.tables(1)):
+        opcodes.append(opcode_table(opcode_code(oc), INT8_VERSIONS[name]))
+    buffers = []
+    for i, raw in enumerate(model.buffers):
+        for t in model.tensors:
+            if t.buffer == i and t.index in data:
+                raw = data[t.index][1]
+        buffers.append(Table({0: child(Bytes(raw) if raw else None)}))
+    subgraph = Table({0: child(Tables(tensors)), 1: child(Vector('i', model.inputs)),
+                      2: child(Vector('i', model.outputs)), 3: child(Tables(operators)),
+                      4: child(String(sg.string(4) or 'main'))})
+    fields = {0: scalar('I', model.version), 1: child(Tables(opcodes)), 2: child(Tables([subgraph])),
+              4: child(Tables(buffers)),
+              6: child(Tables([copy_fields(md, ['str', 'I']) for md in root.tables(6)]))}
+    if root.field_pos(3) is not None:
+        fields[3] = child(String(root.string(3)))
+    sigs = copy_signature_defs(root)
+    if sigs:
+        fields[7] = child(Tables(sigs))
+    return serialize(Table(fields))
+
+
+#--- avaliação inteira (referência do TFLM) ---
+
+def quantize_multiplier(m):
+    """QuantizeMultiplier do TFLite: m = q * 2^shift, q em Q31."""
+    if m == 0.0:
+        return 0, 0
+    q, shift = math.frexp(m)
+    q_fixed = int(_round(q * (1 << 31)))
+    if q_fixed == 1 << 31:
+        q_fixed //= 2
+        shift += 1
+    if shift < -31:
+        return 0, 0
+    return q_fixed, shift
+
+
+def multiply_by_quantized_multiplier(x, q, shift):
+    """SaturatingRoundingDoublingHighMul seguido de RoundingDivideByPOT (arredondamento duplo)."""
+    x *= 1 << max(shift, 0)
+    ab = x * q
+    nudge = (1 << 30) if ab >= 0 else 1 - (1 << 30)
+    v = ab + nudge
+    high = (abs(v) >> 31) * (1 if v >= 0 else -1)
+    exponent = max(-shift, 0)
+    mask = (1 << exponent) - 1
+    threshold = (mask >> 1) + (1 if high < 0 else 0)
+    return (high >> exponent) + (1 if (high & mask) > threshold else 0)
+
+
+def evaluate_int8(model, window):
+    """Executa o modelo int8 sobre a janela em z-score: quantiza na entrada e dequantiza na saída
+    como o tflm_wrapper.cpp, kernels inteiros como os de referência do TFLM."""
+    xt = model.tensors[model.inputs[0]]
+    vals = {xt.index: [int(clamp(_round(v / xt.scale[0]) + xt.zero_point[0], -128, 127)) for v in window]}
+    for op in model.operators:
+        xt, yt = model.tensors[op.inputs[0]], model.tensors[op.outputs[0]]
+        x = vals[xt.index]
+        zin, zout, sin, sout = xt.zero_point[0], yt.zero_point[0], xt.scale[0], yt.scale[0]
+        lo = max(-128, zout) if op.options.get('activation') == 'RELU' else -128
+        if op.op in ('EXPAND_DIMS', 'RESHAPE'):
+            out = x
+        elif op.op == 'MEAN':
+            _, L, C = xt.shape
+            out = []
+            for c in range(C):
+                mean = sum(x[i * C + c] for i in range(L)) / L
+                out.append(int(clamp(_round((mean - zin) * sin / sout) + zout, -128, 127)))
+        else:
+            wt, bt = model.tensors[op.inputs[1]], model.tensors[op.inputs[2]]
+            w, bias = wt.values(), bt.values()
+            mult = [quantize_multiplier(float(sin) * s / float(sout)) for s in wt.scale]
+            out = []
+            if op.op == 'CONV_2D':
+                _, H, W, C = xt.shape
+                O, KH, KW, _ = wt.shape
+                cols = [(oh, ow) for oh in range(H - KH + 1) for ow in range(W - KW + 1)]
+            else:
+                O, C = wt.shape
+                KH = KW = W = 1
+                cols = [(0, 0)]
+            for oh, ow in cols:
+                for o in range(O):
+                    acc = bias[o]
+                    for kh in range(KH):
+                        for kw in range(KW):
+                            xi = ((oh + kh) * W + ow + kw) * C
+                            wi = ((o * KH + kh) * KW + kw) * C
+                            for c in range(C):
+                                acc += (x[xi + c] - zin) * w[wi + c]
+                    q, shift = mult[o if len(mult) > 1 else 0]
+                    out.append(int(clamp(multiply_by_quantized_multiplier(acc, q, shift) + zout, lo, 127)))
+        vals[yt.index] = out
+    yt = model.tensors[model.outputs[0]]
+    return [(q - yt.zero_point[0]) * yt.scale[0] for q in vals[yt.index]]
+
+
+def report(float_model, int8_model, windows, rows=None, mean=None, scale=None):
+    H = float_model.tensors[float_model.outputs[0]].num_elements
+    diff = [[] for _ in range(H)]
+    preds = []
+    for w in windows:
+        a, b = evaluate(float_model, w, f32), evaluate_int8(int8_model, w)
+        preds.append((a, b))
+        for h in range(H):
+            diff[h].append(abs(a[h] - b[h]))
+    print('quantize_int8: |int8 - float32| em %d janelas: %s °C (médio), %s °C (máx)' % (
+        len(windows), ' / '.join('%.4f' % (sum(d) / len(d)) for d in diff),
+        ' / '.join('%.4f' % max(d) for d in diff)))
+    if rows is None:
+        return
+    window = float_model.tensors[float_model.inputs[0]].shape[1]
+    for label, k in (('float32', 0), ('int8', 1)):
+        maes = []
+        for h, ahead in enumerate(HORIZONS[:H]):
+            errs = [abs(p[k][h] - rows[i + window - 1 + 1 + ahead][0])
+                    for i, p in enumerate(preds) if i + window + ahead < len(rows)]
+            maes.append(sum(errs) / len(errs))
+        print('quantize_int8: MAE %-7s %s °C' % (label, ' / '.join('%.4f' % m for m in maes)))
+
+
+def write_header(dst, data, like):
+    """Header com os mesmos símbolos do float32 (--like) e MODEL_INT8, como a seção 7.4 do notebook."""
+    text = open(like, newline='').read()
+    newline = '\r\n' if '\r\n' in text else '\n'
+    start = text.index('{', text.index('unsigned char')) + 1
+    end = text.index('}', start)
+    text = text[:start] + newline + c_array(data, newline) + newline + text[end:]
+    text = re.sub(r'(_len\s*=\s*)\d+', r'\g<1>%d' % len(data), text, count=1)
+    text = text.replace('#define NUM_HORIZONS 3', '#define NUM_HORIZONS 3' + newline + '#define MODEL_INT8 1', 1)
+    text = text.replace('// Auto-generated file - Do not edit manually',
+                        '// Auto-generated file - Do not edit manually' + newline +
+                        '// Full-int8 variant quantized by tools/quantize_int8.py', 1)
+    with open(dst, 'w', newline='') as f:
+        f.write(text)
+
+
+def main():
+    ap = argparse.ArgumentParser(description='Quantização int8 completa do modelo Conv1D, sem TensorFlow')
+    ap.add_argument('model', help='modelo float32 (.tflite ou .h)')
+    ap.add_argument('output', help='.tflite int8 gerado')
+    ap.add_argument('--header', help='gera também o header C')
+    ap.add_argument('--like', help='header float32 cujos defines o header int8 mantém')
+    ap.add_argument('--calibration', help='CSV gravado para calibrar as ativações')
+    ap.add_argument('--synthetic', action='store_true',
+                    help='calibra em janelas sintéticas em z-score (só para testar a ferramenta)')
+    ap.add_argument('--scaler', help='scaler_params.h do modelo (obrigatório com CSV)')
+    ap.add_argument('--windows', type=int, default=512, help='janelas de calibração (padrão 512)')
+    ap.add_argument('--check', metavar='CSV', help='MAE float32 e int8 sobre as janelas do CSV')
+    args = ap.parse_args()
+
+    model = Model.load(args.model)
+    for op in model.operators:
+        if op.op not in SUPPORTED_OPS:
+            fail('op%d: %s não suportado' % (op.index, op.op))
+    for t in model.tensors:
+        if t.type not in ('float32', 'int32'):
+            fail('tensor %d (%s) é %s: esperado modelo float32' % (t.index, t.name, t.type))
+    x = model.tensors[model.inputs[0]]
+    window, features = x.shape[1], x.shape[2]
+    if not args.calibration and not args.synthetic:
+        fail('sem --calibration: calibre nas janelas do CSV de treino (--synthetic só para testar a ferramenta)')
+    if (args.calibration or args.check) and not args.scaler:
+        fail('--calibration e --check precisam de --scaler')
+    mean, scale = load_scaler(args.scaler) if args.scaler else (None, None)
+
+    if args.calibration:
+        windows = csv_windows(load_csv(args.calibration), window, mean, scale)
+        step = max(1, len(windows) // args.windows)
+        windows = windows[::step][:args.windows]
+        source = os.path.basename(args.calibration)
+    else:
+        windows = make_windows(args.windows, window, features, 7)
+        source = 'janelas sintéticas'
+    quant, data = quantize(model, calibrate(model, windows))
+    out = write_model(model, quant, data)
+    int8_model = Model(out)
+    print('quantize_int8: %s -> %d bytes (float32 %d bytes), calibrado em %d janelas (%s)' % (
+        os.path.basename(args.model), len(out), len(model.data), len(windows), source))
+    xq, yq = int8_model.tensors[int8_model.inputs[0]], int8_model.tensors[int8_model.outputs[0]]
+    print('quantize_int8: entrada scale=%.6f zp=%d, saída scale=%.6f zp=%d' % (
+        xq.scale[0], xq.zero_point[0], yq.scale[0], yq.zero_point[0]))
+
+    checks = make_windows(64, window, features, 1)
+    if args.check:
+        rows = load_csv(args.check)
+        report(model, int8_model, csv_windows(rows, window, mean, scale), rows, mean, scale)
+    else:
+        report(model, int8_model, checks)
+
+    os.makedirs(os.path.dirname(os.path.abspath(args.output)), exist_ok=True)
+    with open(args.output, 'wb') as f:
+        f.write(out)
+    if args.header:
+        if not args.like:
+            fail('--header precisa de --like (header float32 do modelo)')
+        write_header(args.header, out, args.like)
+
+
+if __name__ == '__main__':
+    main()
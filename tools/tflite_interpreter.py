@@ -0,0 +1,127 @@
+"""
+Interpretador de referência em Python dos modelos .tflite deste repositório.
+
+Executa o grafo lido por tools/tflite_reader.py operador a operador, só com os operadores dos modelos
+de models/ (EXPAND_DIMS, RESHAPE, CONV_2D, MEAN, FULLY_CONNECTED, o flatten SHAPE/STRIDED_SLICE/PACK do
+MLP e o FULLY_CONNECTED híbrido com pesos int8). Com rnd = f32 cada soma e produto é arredondado para
+float32 na ordem de acumulação dos kernels (bias, depois kernel × canais); com a identidade, as contas
+ficam em float64.
+
+É a referência de tools/fold_scaler.py (--check), tools/gen_test_vectors.py (saídas esperadas dos testes
+dos motores gerados), tools/gen_model_registry.py (pesos híbridos dequantizados) e tools/quantize_int8.py
+(calibração). Como lê os pesos pelo mesmo tools/tflite_reader.py dos geradores, um erro de layout na
+leitura passa despercebido aqui: a paridade com o TFLM real fica com host/tests/test_tflm_conv1d.cpp.
+"""
+import math
+import struct
+import sys
+
+#operadores que só mudam a forma do tensor de dados (a ordem row-major das features é mantida)
+RESHAPE_OPS = ('EXPAND_DIMS', 'RESHAPE')
+#operadores que só produzem a forma de destino de um RESHAPE (flatten do MLP)
+SHAPE_OPS = ('SHAPE', 'STRIDED_SLICE', 'PACK')
+
+_F32 = struct.Struct('<f')
+
+
+def fail(msg):
+    sys.stderr.write('tflite_interpreter: ERRO: %s\n' % msg)
+    sys.exit(1)
+
+
+def f32(x):
+    return _F32.unpack(_F32.pack(x))[0]
+
+
+def _activation(v, act):
+    if act == 'RELU':
+        return [max(0.0, x) for x in v]
+    if act != 'NONE':
+        fail('ativação %s não suportada pela referência' % act)
+    return v
+
+
+def _round(v):
+    return math.floor(v + 0.5) if v >= 0 else -math.floor(-v + 0.5)  #std::round, como o TFLite
+
+
+def _hybrid_fc(x, wt, bias, asymmetric, rnd):
+    """FULLY_CONNECTED híbrido do TFLite: entrada quantizada em int8 a cada invoke, pesos int8 por canal."""
+    O, N = wt.shape
+    if asymmetric:  #tensor_utils::AsymmetricQuantizeFloats
+        rmin, rmax = min(0.0, min(x)), max(0.0, max(x))
+        scale = (rmax - rmin) / 255.0 if rmax > rmin else 1.0
+        zp = int(max(-128, min(127, _round(-128 - rmin / scale))))
+    else:           #tensor_utils::SymmetricQuantizeFloats
+        scale = max(abs(v) for v in x) / 127.0 or 1.0
+        zp = 0
+    q = [max(-128, min(127, zp + int(_round(v / scale)))) for v in x]
+    w = wt.values()
+    out = []
+    for o in range(O):
+        acc = sum((q[j] - zp) * w[o * N + j] for j in range(N))
+        ws = wt.scale[o] if len(wt.scale) > 1 else wt.scale[0]
+        out.append(rnd(rnd(acc * rnd(scale * ws)) + bias[o]))
+    return out
+
+
+def evaluate(model, window, rnd, tensors=None):
+    """Executa o grafo sobre a janela (lista plana [1,10,4]); rnd = f32 ou identidade.
+    Com tensors (dict), devolve nele os valores de cada tensor intermediário (calibração int8)."""
+    vals = {model.inputs[0]: [rnd(x) for x in window]}
+    for op in model.operators:
+        if op.op in SHAPE_OPS:
+            continue
+        x = vals[op.inputs[0]]
+        xt = model.tensors[op.inputs[0]]
+        if op.op in RESHAPE_OPS:
+            out = x
+        elif op.op == 'CONV_2D':
+            wt, bt = model.tensors[op.inputs[1]], model.tensors[op.inputs[2]]
+            w, bias = wt.values(), bt.values()
+            _, H, W, C = xt.shape
+            O, KH, KW, _ = wt.shape
+            out = []
+            for oh in range(H - KH + 1):
+                for ow in range(W - KW + 1):
+                    for o in range(O):
+                        acc = bias[o]
+                        for kh in range(KH):
+                            for kw in range(KW):
+                                xi = ((oh + kh) * W + ow + kw) * C
+                                wi = ((o * KH + kh) * KW + kw) * C
+                                for c in range(C):
+                                    acc = rnd(acc + rnd(x[xi + c] * w[wi + c]))
+                        out.append(acc)
+            out = _activation(out, op.options['activation'])
+        elif op.op == 'MEAN':
+            axes = model.tensors[op.inputs[1]].values()
+            if len(xt.shape) != 3 or [a % 3 for a in axes] != [1]:
+                fail('MEAN só é suportada no eixo 1 de [1, L, C]')
+            _, L, C = xt.shape
+            out = []
+            for c in range(C):
+                acc = 0.0
+                for i in range(L):
+                    acc = rnd(acc + x[i * C + c])
+                out.append(rnd(acc / L))
+        elif op.op == 'FULLY_CONNECTED':
+            wt, bt = model.tensors[op.inputs[1]], model.tensors[op.inputs[2]]
+            w, bias = wt.values(), bt.values()
+            O, N = wt.shape
+            if wt.type == 'int8':  #pesos híbridos (dense_1 do MLP)
+                out = _hybrid_fc(x, wt, bias, op.options.get('asymmetric_quantize_inputs', False), rnd)
+            else:
+                out = []
+                for o in range(O):
+                    acc = bias[o]
+                    for j in range(N):
+                        acc = rnd(acc + rnd(x[j] * w[o * N + j]))
+                    out.append(acc)
+            out = _activation(out, op.options['activation'])
+        else:
+            fail('op%d: %s não suportado pela referência' % (op.index, op.op))
+        vals[op.outputs[0]] = out
+    if tensors is not None:
+        tensors.update(vals)
+    return vals[model.outputs[0]]
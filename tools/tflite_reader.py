@@ -0,0 +1,300 @@
+"""
+Leitor mínimo de arquivos .tflite (FlatBuffers) sem dependências externas.
+
+Usado pelas ferramentas de build (geração de código, resolver, planner) para
+extrair grafo, tensores, pesos e parâmetros de quantização do modelo embarcado.
+Cobre apenas os campos do schema TFLite usados pelos modelos deste repositório.
+"""
+import struct
+
+#tipos de tensor (schema.fbs: TensorType)
+TENSOR_TYPES = {
+    0: 'float32', 1: 'float16', 2: 'int32', 3: 'uint8', 4: 'int64',
+    5: 'string', 6: 'bool', 7: 'int16', 9: 'int8', 10: 'float64',
+}
+TYPE_SIZES = {'float32': 4, 'float16': 2, 'int32': 4, 'uint8': 1, 'int64': 8,
+              'bool': 1, 'int16': 2, 'int8': 1, 'float64': 8}
+TYPE_FORMATS = {'float32': 'f', 'int32': 'i', 'uint8': 'B', 'int64': 'q',
+                'int16': 'h', 'int8': 'b', 'float64': 'd', 'bool': 'B'}
+
+#operadores builtin (schema.fbs: BuiltinOperator)
+BUILTIN_OPS = {
+    0: 'ADD', 1: 'AVERAGE_POOL_2D', 2: 'CONCATENATION', 3: 'CONV_2D',
+    4: 'DEPTHWISE_CONV_2D', 6: 'DEQUANTIZE', 9: 'FULLY_CONNECTED',
+    14: 'LOGISTIC', 17: 'MAX_POOL_2D', 18: 'MUL', 19: 'RELU', 22: 'RESHAPE',
+    25: 'SOFTMAX', 28: 'TANH', 34: 'PAD', 36: 'GATHER', 39: 'TRANSPOSE',
+    40: 'MEAN', 41: 'SUB', 43: 'SQUEEZE', 45: 'STRIDED_SLICE', 47: 'EXP',
+    49: 'SPLIT', 53: 'CAST', 70: 'EXPAND_DIMS', 74: 'SUM', 77: 'SHAPE', 83: 'PACK',
+    88: 'UNPACK', 102: 'SPLIT_V', 114: 'QUANTIZE', 119: 'WHILE',
+    126: 'BATCH_MATMUL', 127: 'PLACEHOLDER_FOR_GREATER_OP_CODES',
+}
+BUILTIN_CUSTOM = 32  #operador custom/flex: o nome vem de OperatorCode.custom_code
+
+#operadores com kernel no TFLM -> (Add*() do MicroMutableOpResolver, fontes do kernel em kernels/,
+#que viram os objetos conv.cpp.obj, conv_common.cpp.obj... no .map do link)
+TFLM_KERNELS = {
+    'ADD': ('AddAdd', ['add', 'add_common']),
+    'AVERAGE_POOL_2D': ('AddAveragePool2D', ['pooling', 'pooling_common']),
+    'BATCH_MATMUL': ('AddBatchMatMul', ['batch_matmul', 'batch_matmul_common']),
+    'CAST': ('AddCast', ['cast']),
+    'CONCATENATION': ('AddConcatenation', ['concatenation']),
+    'CONV_2D': ('AddConv2D', ['conv', 'conv_common']),
+    'DEPTHWISE_CONV_2D': ('AddDepthwiseConv2D', ['depthwise_conv', 'depthwise_conv_common']),
+    'DEQUANTIZE': ('AddDequantize', ['dequantize', 'dequantize_common']),
+    'EXP': ('AddExp', ['exp']),
+    'EXPAND_DIMS': ('AddExpandDims', ['expand_dims']),
+    'FULLY_CONNECTED': ('AddFullyConnected', ['fully_connected', 'fully_connected_common']),
+    'GATHER': ('AddGather', ['gather']),
+    'LOGISTIC': ('AddLogistic', ['logistic', 'logistic_common']),
+    'MAX_POOL_2D': ('AddMaxPool2D', ['pooling', 'pooling_common']),
+    'MEAN': ('AddMean', ['reduce', 'reduce_common']),
+    'MUL': ('AddMul', ['mul', 'mul_common']),
+    'PACK': ('AddPack', ['pack']),
+    'PAD': ('AddPad', ['pad', 'pad_common']),
+    'QUANTIZE': ('AddQuantize', ['quantize', 'quantize_common']),
+    'RELU': ('AddRelu', ['activations', 'activations_common']),
+    'RESHAPE': ('AddReshape', ['reshape', 'reshape_common']),
+    'SHAPE': ('AddShape', ['shape']),
+    'SOFTMAX': ('AddSoftmax', ['softmax', 'softmax_common']),
+    'SPLIT': ('AddSplit', ['split']),
+    'SPLIT_V': ('AddSplitV', ['split_v']),
+    'SQUEEZE': ('AddSqueeze', ['squeeze']),
+    'STRIDED_SLICE': ('AddStridedSlice', ['strided_slice', 'strided_slice_common']),
+    'SUB': ('AddSub', ['sub', 'sub_common']),
+    'SUM': ('AddSum', ['reduce', 'reduce_common']),
+    'TANH': ('AddTanh', ['tanh', 'tanh_common']),
+    'TRANSPOSE': ('AddTranspose', ['transpose', 'transpose_common']),
+    'UNPACK': ('AddUnpack', ['unpack']),
+    'WHILE': ('AddWhile', ['while']),
+}
+#opções builtin (schema.fbs: BuiltinOptions) relevantes para os kernels gerados
+OPTIONS_CONV2D = 1
+OPTIONS_FULLY_CONNECTED = 8
+OPTIONS_RESHAPE = 17
+OPTIONS_REDUCER = 27
+
+#padding e ativações fundidas
+PADDING = {0: 'SAME', 1: 'VALID'}
+ACTIVATIONS = {0: 'NONE', 1: 'RELU', 2: 'RELU_N1_TO_1', 3: 'RELU6', 4: 'TANH'}
+
+
+class _Table:
+    """Acesso a campos de uma tabela FlatBuffers pelo índice do campo."""
+
+    def __init__(self, buf, pos):
+        self.buf = buf
+        self.pos = pos
+        vtable = pos - struct.unpack_from('<i', buf, pos)[0]
+        self.vt_size = struct.unpack_from('<H', buf, vtable)[0]
+        self.vtable = vtable
+
+    def _offset(self, field):
+        vo = 4 + 2 * field
+        if vo >= self.vt_size:
+            return 0
+        return struct.unpack_from('<H', self.buf, self.vtable + vo)[0]
+
+    def field_pos(self, field):
+        """Posição absoluta do campo (None se ausente), para ferramentas que reescrevem no lugar."""
+        off = self._offset(field)
+        return self.pos + off if off else None
+
+    def scalar(self, field, fmt, default=0):
+        off = self._offset(field)
+        if not off:
+            return default
+        return struct.unpack_from('<' + fmt, self.buf, self.pos + off)[0]
+
+    def _indirect(self, field):
+        off = self._offset(field)
+        if not off:
+            return None
+        p = self.pos + off
+        return p + struct.unpack_from('<I', self.buf, p)[0]
+
+    def table(self, field):
+        p = self._indirect(field)
+        return _Table(self.buf, p) if p is not None else None
+
+    def string(self, field):
+        p = self._indirect(field)
+        if p is None:
+            return None
+        n = struct.unpack_from('<I', self.buf, p)[0]
+        return self.buf[p + 4:p + 4 + n].decode('utf-8')
+
+    def vector(self, field, fmt):
+        p = self._indirect(field)
+        if p is None:
+            return []
+        n = struct.unpack_from('<I', self.buf, p)[0]
+        return list(struct.unpack_from('<%d%s' % (n, fmt), self.buf, p + 4))
+
+    def vector_offset(self, field):
+        """Posição do primeiro elemento de um vetor no buffer (None se ausente)."""
+        p = self._indirect(field)
+        return p + 4 if p is not None else None
+
+    def bytes(self, field):
+        p = self._indirect(field)
+        if p is None:
+            return b''
+        n = struct.unpack_from('<I', self.buf, p)[0]
+        return bytes(self.buf[p + 4:p + 4 + n])
+
+    def tables(self, field):
+        p = self._indirect(field)
+        if p is None:
+            return []
+        n = struct.unpack_from('<I', self.buf, p)[0]
+        out = []
+        for i in range(n):
+            e = p + 4 + 4 * i
+            out.append(_Table(self.buf, e + struct.unpack_from('<I', self.buf, e)[0]))
+        return out
+
+
+class Tensor:
+    def __init__(self, index, table, buffers, buffer_offsets):
+        self.index = index
+        self.shape = table.vector(0, 'i')
+        self.type = TENSOR_TYPES.get(table.scalar(1, 'b'), 'unknown')
+        self.type_pos = table.field_pos(1)
+        self.buffer = table.scalar(2, 'I')
+        self.name = table.string(3) or ''
+        q = table.table(4)
+        self.scale = q.vector(2, 'f') if q else []
+        self.zero_point = q.vector(3, 'q') if q else []
+        self.quantized_dimension = q.scalar(6, 'i') if q else 0
+        self.data = buffers[self.buffer] if self.buffer < len(buffers) else b''
+        #posição dos bytes constantes em Model.data (ferramentas que reescrevem pesos no lugar)
+        self.data_offset = buffer_offsets[self.buffer] if self.data else None
+
+    @property
+    def is_constant(self):
+        return len(self.data) > 0
+
+    @property
+    def num_elements(self):
+        n = 1
+        for d in self.shape:
+            n *= d
+        return n
+
+    @property
+    def num_bytes(self):
+        return self.num_elements * TYPE_SIZES.get(self.type, 1)
+
+    def values(self):
+        """Valores do buffer constante como lista plana (ordem row-major)."""
+        fmt = TYPE_FORMATS[self.type]
+        return list(struct.unpack('<%d%s' % (len(self.data) // TYPE_SIZES[self.type], fmt), self.data))
+
+    def dequantized(self):
+        """Valores reais do buffer: (q - zero_point) * scale, por canal em quantized_dimension."""
+        q = self.values()
+        if self.type not in ('int8', 'uint8', 'int16') or not self.scale:
+            return [float(v) for v in q]
+        if len(self.scale) == 1:
+            return [(v - self.zero_point[0]) * self.scale[0] for v in q]
+        #elemento k pertence ao canal (k // inner) % canais da dimensão quantizada
+        inner = 1
+        for d in self.shape[self.quantized_dimension + 1:]:
+            inner *= d
+        n = len(self.scale)
+        return [(v - self.zero_point[(k // inner) % n]) * self.scale[(k // inner) % n] for k, v in enumerate(q)]
+
+
+class Operator:
+    def __init__(self, index, table, opcodes):
+        self.index = index
+        self.opcode_index = table.scalar(0, 'I')
+        self.op, self.version = opcodes[self.opcode_index]
+        self.inputs = table.vector(1, 'i')
+        self.outputs = table.vector(2, 'i')
+        self.options_type = table.scalar(3, 'B')
+        self.options = {}
+        opt = table.table(4)
+        if opt is None:
+            return
+        if self.options_type == OPTIONS_CONV2D:
+            self.options = {
+                'padding': PADDING.get(opt.scalar(0, 'b'), '?'),
+                'stride_w': opt.scalar(1, 'i'),
+                'stride_h': opt.scalar(2, 'i'),
+                'activation': ACTIVATIONS.get(opt.scalar(3, 'b'), '?'),
+                'dilation_w': opt.scalar(4, 'i', 1),
+                'dilation_h': opt.scalar(5, 'i', 1),
+            }
+        elif self.options_type == OPTIONS_FULLY_CONNECTED:
+            self.options = {
+                'activation': ACTIVATIONS.get(opt.scalar(0, 'b'), '?'),
+                'keep_num_dims': bool(opt.scalar(2, 'B')),
+                'asymmetric_quantize_inputs': bool(opt.scalar(3, 'B')),
+            }
+        elif self.options_type == OPTIONS_REDUCER:
+            self.options = {'keep_dims': bool(opt.scalar(0, 'B'))}
+        elif self.options_type == OPTIONS_RESHAPE:
+            self.options = {'new_shape': opt.vector(0, 'i')}
+
+
+class Model:
+    """Modelo TFLite carregado de um arquivo .tflite ou de um array C em .h."""
+
+    def __init__(self, data):
+        self.data = bytes(data)
+        root = _Table(self.data, struct.unpack_from('<I', self.data, 0)[0])
+        self.version = root.scalar(0, 'I')
+        self.opcodes = []
+        for oc in root.tables(1):
+            code = max(oc.scalar(0, 'b'), oc.scalar(3, 'i'))
+            name = oc.string(1) if code == BUILTIN_CUSTOM else BUILTIN_OPS.get(code, 'BUILTIN_%d' % code)
+            self.opcodes.append((name or 'CUSTOM', oc.scalar(2, 'i', 1)))
+        buffer_tables = root.tables(4)
+        buffers = [b.bytes(0) for b in buffer_tables]
+        buffer_offsets = [b.vector_offset(0) for b in buffer_tables]
+        #posição do uoffset de Buffer.data (para repontar um buffer para bytes anexados ao fim)
+        self.buffer_data_pos = [b.field_pos(0) for b in buffer_tables]
+        self.buffers = buffers
+        #metadados: (nome, índice do buffer, posição do uoffset do nome) por entrada
+        self.metadata = [(md.string(0), md.scalar(1, 'I'), md.field_pos(0)) for md in root.tables(6)]
+        sg = root.tables(2)[0]
+        self.tensors = [Tensor(i, t, buffers, buffer_offsets) for i, t in enumerate(sg.tables(0))]
+        self.inputs = sg.vector(1, 'i')
+        self.outputs = sg.vector(2, 'i')
+        self.operators = [Operator(i, t, self.opcodes) for i, t in enumerate(sg.tables(3))]
+
+    @classmethod
+    def load(cls, path):
+        if path.endswith('.h'):
+            return cls(c_array_bytes(open(path).read()))
+        with open(path, 'rb') as f:
+            return cls(f.read())
+
+    def op_versions(self):
+        """Operadores usados pelo grafo com a maior versão exigida de cada um."""
+        used = {}
+        for op in self.operators:
+            used[op.op] = max(used.get(op.op, 0), op.version)
+        return used
+
+
+def c_array_bytes(text):
+    """Extrai os bytes do primeiro array 'unsigned char' de um header gerado."""
+    start = text.index('{', text.index('unsigned char'))
+    end = text.index('}', start)
+    return bytes(int(tok, 16) for tok in text[start + 1:end].replace(',', ' ').split())
+
+
+def dump(model):
+    print('schema v%d, %d tensores, %d operadores' % (model.version, len(model.tensors), len(model.operators)))
+    for t in model.tensors:
+        q = ' q=(%s, %s)' % (t.scale[:2], t.zero_point[:2]) if t.scale else ''
+        print('  t%-3d %-8s %-16s %s%s %s' % (t.index, t.type, t.shape, 'const ' if t.is_constant else '', q, t.name))
+    for op in model.operators:
+        print('  op%-2d %s v%d in=%s out=%s %s' % (op.index, op.op, op.version, op.inputs, op.outputs, op.options))
+
+
+if __name__ == '__main__':
+    import sys
+    dump(Model.load(sys.argv[1]))
@@ -0,0 +1,189 @@
+"""
+Escritor mínimo de arquivos .tflite (FlatBuffers) sem dependências externas.
+
+Par de tools/tflite_reader.py para as ferramentas que reescrevem um modelo com outro tamanho (os
+tensores mudam de tipo, os buffers de tamanho): o arquivo é serializado de novo a partir de nós
+Table/Vector/String. A ordem é de cima para baixo (pai antes dos filhos), então todo uoffset aponta
+para frente, como o formato exige; a vtable de cada tabela fica logo antes dela. Campos ausentes do
+nó ficam com o default do schema.
+"""
+import struct
+
+from tflite_reader import BUILTIN_CUSTOM, _Table
+
+TFLITE_IDENTIFIER = b'TFL3'
+_SIZES = {'b': 1, 'B': 1, '?': 1, 'h': 2, 'H': 2, 'i': 4, 'I': 4, 'f': 4, 'q': 8, 'd': 8}
+
+
+class Table:
+    """Tabela: {campo: (formato, valor)}; formato struct para escalares, None para um nó filho."""
+
+    def __init__(self, fields=None):
+        self.fields = {k: v for k, v in (fields or {}).items() if v[1] is not None}
+
+
+class Vector:
+    """Vetor de escalares (formato struct) alinhado em align bytes."""
+
+    def __init__(self, fmt, values, align=4):
+        self.fmt = fmt
+        self.values = list(values)
+        self.align = max(align, _SIZES[fmt], 4)
+
+
+class Bytes(Vector):
+    def __init__(self, data, align=16):
+        Vector.__init__(self, 'B', bytearray(data), align)
+
+
+class String:
+    def __init__(self, text):
+        self.data = text.encode('utf-8')
+
+
+class Tables:
+    """Vetor de tabelas."""
+
+    def __init__(self, tables):
+        self.tables = list(tables)
+
+
+def scalar(fmt, value):
+    return (fmt, value)
+
+
+def child(node):
+    return (None, node)
+
+
+class _Builder:
+    def __init__(self):
+        self.buf = bytearray()
+
+    def pad(self, align, extra=0):
+        while (len(self.buf) + extra) % align:
+            self.buf.append(0)
+
+    def uoffset(self, at, target):
+        struct.pack_into('<I', self.buf, at, target - at)
+
+    def write(self, node):
+        if isinstance(node, Table):
+            return self.table(node)
+        if isinstance(node, Tables):
+            self.pad(4)
+            pos = len(self.buf)
+            self.buf += struct.pack('<I', len(node.tables)) + bytes(4 * len(node.tables))
+            for i, t in enumerate(node.tables):
+                self.uoffset(pos + 4 + 4 * i, self.write(t))
+            return pos
+        if isinstance(node, String):
+            self.pad(4)
+            pos = len(self.buf)
+            self.buf += struct.pack('<I', len(node.data)) + node.data + b'\0'
+            return pos
+        if isinstance(node, Vector):
+            self.pad(node.align, 4)  #os elementos (depois do tamanho) ficam alinhados
+            pos = len(self.buf)
+            self.buf += struct.pack('<I%d%s' % (len(node.values), node.fmt), len(node.values), *node.values)
+            return pos
+        raise TypeError(node)
+
+    def table(self, node):
+        #campos inline do maior para o menor: cada um fica alinhado no próprio tamanho
+        layout, size = {}, 4
+        for key in sorted(node.fields, key=lambda k: (-_SIZES.get(node.fields[k][0], 4), k)):
+            n = _SIZES.get(node.fields[key][0], 4)
+            size = (size + n - 1) // n * n
+            layout[key] = size
+            size += n
+        size = (size + 3) // 4 * 4
+        slots = max(node.fields) + 1 if node.fields else 0
+        vtable = struct.pack('<HH%dH' % slots, 4 + 2 * slots, size, *[layout.get(k, 0) for k in range(slots)])
+        self.pad(2)
+        vt_pos = len(self.buf)
+        self.buf += vtable
+        self.pad(4)
+        pos = len(self.buf)
+        self.buf += struct.pack('<i', pos - vt_pos) + bytes(size - 4)
+        children = []
+        for key, (fmt, value) in node.fields.items():
+            if fmt is None:
+                children.append((pos + layout[key], value))
+            else:
+                struct.pack_into('<' + fmt, self.buf, pos + layout[key], value)
+        for at, value in children:
+            self.uoffset(at, self.write(value))
+        return pos
+
+
+def serialize(root, identifier=TFLITE_IDENTIFIER):
+    b = _Builder()
+    b.buf += bytes(4) + identifier
+    b.uoffset(0, b.write(root))
+    b.pad(16)
+    return bytes(b.buf)
+
+
+#--- cópia de tabelas do modelo lido (campos que as ferramentas não alteram) ---
+
+#formato de cada campo das opções builtin dos modelos do repositório (schema.fbs)
+OPTION_FIELDS = {
+    1: ['b', 'i', 'i', 'b', 'i', 'i'],    #Conv2DOptions
+    8: ['b', 'b', '?', '?'],              #FullyConnectedOptions
+    17: [('vec', 'i')],                   #ReshapeOptions
+    27: ['?'],                            #ReducerOptions
+    52: [],                               #ExpandDimsOptions
+}
+
+
+def copy_fields(src, spec):
+    """Tabela com os campos presentes em src, pelos formatos de spec (escalar, ('vec', fmt) ou 'str')."""
+    fields = {}
+    for i, fmt in enumerate(spec):
+        if src.field_pos(i) is None:
+            continue
+        if fmt == 'str':
+            fields[i] = child(String(src.string(i)))
+        elif isinstance(fmt, tuple):
+            fields[i] = child(Vector(fmt[1], src.vector(i, fmt[1])))
+        else:
+            fields[i] = scalar(fmt, src.scalar(i, fmt))
+    return Table(fields)
+
+
+def copy_options(op_table, options_type):
+    if not options_type:
+        return None
+    if options_type not in OPTION_FIELDS:
+        raise ValueError('opções builtin %d não suportadas pelo escritor' % options_type)
+    src = op_table.table(4)
+    return copy_fields(src, OPTION_FIELDS[options_type]) if src else None
+
+
+def opcode_table(code, version):
+    """OperatorCode com os dois campos de código (deprecated até 127, como o conversor grava)."""
+    return Table({0: scalar('b', min(code, 127)), 2: scalar('i', version), 3: scalar('i', code)})
+
+
+def root_table(data):
+    return _Table(data, struct.unpack_from('<I', data, 0)[0])
+
+
+def opcode_code(oc):
+    code = max(oc.scalar(0, 'b'), oc.scalar(3, 'i'))
+    if code == BUILTIN_CUSTOM:
+        raise ValueError('operador custom não suportado pelo escritor')
+    return code
+
+
+def copy_signature_defs(root):
+    """SignatureDefs do modelo lido (nomes de entrada/saída; o TFLM ignora, o interpretador Python usa)."""
+    out = []
+    for sd in root.tables(7):
+        maps = [Tables([copy_fields(m, ['str', 'I']) for m in sd.tables(f)]) for f in (0, 1)]
+        fields = {0: child(maps[0]), 1: child(maps[1]), 4: scalar('I', sd.scalar(4, 'I'))}
+        if sd.field_pos(2) is not None:
+            fields[2] = child(String(sd.string(2)))
+        out.append(Table(fields))
+    return out